@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -37,13 +39,28 @@ public:
   JITMapper &operator=(JITMapper &&other) noexcept;
 
   /// Get the address for a global, which must be contained in the compiled
-  /// module.
+  /// module. Returns nullptr for functions with local linkage whose address is
+  /// not taken inside the module, as they may use a private calling
+  /// convention.
   void *lookup_global(llvm::GlobalValue *) noexcept;
 
   /// Indicate whether compilation and in-memory mapping was successful.
   operator bool() const noexcept { return impl != nullptr; }
 };
 
+/// Options for linking a module into a shared object or executable.
+struct LinkOptions {
+  /// DT_SONAME of the shared object, omitted if empty.
+  std::string_view soname;
+  /// Libraries the output depends on (DT_NEEDED), e.g., "libc.so.6".
+  std::vector<std::string> needed;
+  /// Entry symbol of executables. If the module does not define it, main is
+  /// called through __libc_start_main instead.
+  std::string_view entry = "_start";
+  /// Program interpreter of executables, the default of the target if empty.
+  std::string_view interp;
+};
+
 /// Compiler for LLVM modules
 class LLVMCompiler {
 protected:
@@ -61,12 +78,75 @@ public:
   static std::unique_ptr<LLVMCompiler>
       create(const llvm::Triple &triple) noexcept;
 
+  /// Emit blocks that are unlikely to execute into a separate section
+  /// (.text.unlikely). Disabled by default.
+  virtual void set_split_cold_code(bool enable) noexcept = 0;
+
+  /// Skip instructions without side effects whose results are unused, e.g.
+  /// leftovers in unoptimized IR. Disabled by default.
+  virtual void set_eliminate_dead_code(bool enable) noexcept = 0;
+
+  /// Fold instructions whose operands are all constants instead of emitting
+  /// code for them. Disabled by default.
+  virtual void set_fold_constants(bool enable) noexcept = 0;
+
+  /// Omit zero-extensions of integers whose upper register bits are known to
+  /// be zero, e.g. after a load or an earlier zext. Disabled by default.
+  virtual void set_elide_redundant_ext(bool enable) noexcept = 0;
+
+  /// Emit a DWARF line table (.debug_line) from the debug locations of the
+  /// instructions, e.g., for profilers. Disabled by default.
+  virtual void set_emit_line_table(bool enable) noexcept = 0;
+
+  /// Record functions mapped by compile_and_map in the perf map
+  /// /tmp/perf-<pid>.map. Disabled by default.
+  virtual void set_perf_map(bool enable) noexcept = 0;
+
+  /// Record functions mapped by compile_and_map in the jitdump file
+  /// /tmp/jit-<pid>.dump for perf inject --jit, including line numbers if a
+  /// line table is emitted. Disabled by default.
+  virtual void set_jitdump(bool enable) noexcept = 0;
+
+  /// Register modules mapped by compile_and_map with the GDB JIT interface,
+  /// providing symbols, unwind information, and the line table (if emitted)
+  /// to gdb. Disabled by default.
+  virtual void set_gdb_jit(bool enable) noexcept = 0;
+
   /// Compile the module to an object file and emit it into the buffer. The
   /// module might be modified during compilation.
   /// \returns true on success.
   virtual bool compile_to_elf(llvm::Module &mod,
                               std::vector<uint8_t> &buf) noexcept = 0;
 
+  /// Compile the module to an object file and pass it in order to write,
+  /// which is called with consecutive parts of the object file and returns
+  /// false on failure. The object file is never built in memory as a whole.
+  /// The module might be modified during compilation.
+  /// \returns true on success.
+  virtual bool compile_to_elf(
+      llvm::Module &mod,
+      std::function<bool(std::span<const uint8_t>)> write) noexcept = 0;
+
+  /// Compile the module and link it into a shared object, which is passed in
+  /// order to write. Symbols defined in the module are bound locally, thread-
+  /// local variables are not supported. The module might be modified during
+  /// compilation.
+  /// \returns true on success.
+  virtual bool compile_to_shared(
+      llvm::Module &mod,
+      const LinkOptions &options,
+      std::function<bool(std::span<const uint8_t>)> write) noexcept = 0;
+
+  /// Compile the module and link it into a position-independent executable,
+  /// which is passed in order to write. External symbols must be provided by
+  /// the libraries in options.needed. The module might be modified during
+  /// compilation.
+  /// \returns true on success.
+  virtual bool compile_to_executable(
+      llvm::Module &mod,
+      const LinkOptions &options,
+      std::function<bool(std::span<const uint8_t>)> write) noexcept = 0;
+
   /// Compile the module and map it into memory, calling resolver to resolve
   /// references to external symbols. This function will also register unwind
   /// information. The module might be modified during compilation.
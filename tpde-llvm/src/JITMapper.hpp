@@ -23,8 +23,15 @@ public:
   /// Map the ELF from the assembler into memory, returns true on success.
   bool map(tpde::AssemblerElf &, tpde::ElfMapper::SymbolResolver) noexcept;
 
+  void set_perf_map(bool enable) noexcept { mapper.set_perf_map(enable); }
+
+  void set_jitdump(bool enable) noexcept { mapper.set_jitdump(enable); }
+
+  void set_gdb_jit(bool enable) noexcept { mapper.set_gdb_jit(enable); }
+
   void *lookup_global(llvm::GlobalValue *gv) noexcept {
-    return mapper.get_sym_addr(globals.lookup(gv));
+    tpde::SymRef sym = globals.lookup(gv);
+    return sym.valid() ? mapper.get_sym_addr(sym) : nullptr;
   }
 };
 
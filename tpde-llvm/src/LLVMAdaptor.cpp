@@ -14,12 +14,14 @@
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ProfDataUtils.h>
 #include <llvm/IR/ReplaceConstant.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/Support/TimeProfiler.h>
 #include <llvm/Support/raw_ostream.h>
 
 #include <algorithm>
+#include <optional>
 #include <utility>
 
 #include "base.hpp"
@@ -227,6 +229,54 @@ llvm::Instruction *LLVMAdaptor::handle_inst_in_block(llvm::Instruction *inst) {
   return nullptr;
 }
 
+/// If cond is an llvm.expect or a comparison of llvm.expect with a constant,
+/// get the expected value of cond.
+static std::optional<bool> expected_cond(const llvm::Value *cond) noexcept {
+  const auto *cmp = llvm::dyn_cast<llvm::ICmpInst>(cond);
+  const llvm::ConstantInt *cmp_rhs = nullptr;
+  if (cmp) {
+    cmp_rhs = llvm::dyn_cast<llvm::ConstantInt>(cmp->getOperand(1));
+    if (!cmp->isEquality() || !cmp_rhs) {
+      return std::nullopt;
+    }
+    cond = cmp->getOperand(0);
+  }
+
+  const auto *intrin = llvm::dyn_cast<llvm::IntrinsicInst>(cond);
+  if (!intrin || intrin->getIntrinsicID() != llvm::Intrinsic::expect) {
+    return std::nullopt;
+  }
+  const auto *expected =
+      llvm::dyn_cast<llvm::ConstantInt>(intrin->getArgOperand(1));
+  if (!expected) {
+    return std::nullopt;
+  }
+  if (!cmp) {
+    return !expected->isZero();
+  }
+  const bool eq = expected->getValue() == cmp_rhs->getValue();
+  return cmp->getPredicate() == llvm::CmpInst::ICMP_EQ ? eq : !eq;
+}
+
+/// Get the branch weights of a terminator from profile metadata or, for
+/// conditional branches, from llvm.expect.
+static bool branch_weights(const llvm::Instruction *term,
+                           llvm::SmallVectorImpl<u32> &weights) noexcept {
+  if (llvm::extractBranchWeights(*term, weights)) {
+    return weights.size() == term->getNumSuccessors();
+  }
+  const auto *br = llvm::dyn_cast<llvm::BranchInst>(term);
+  if (!br || !br->isConditional()) {
+    return false;
+  }
+  if (auto expected = expected_cond(br->getCondition())) {
+    // Same weights as used by the LowerExpectIntrinsic pass.
+    weights.assign({*expected ? 2000u : 1u, *expected ? 1u : 2000u});
+    return true;
+  }
+  return false;
+}
+
 bool LLVMAdaptor::switch_func(const IRFuncRef function) noexcept {
   llvm::TimeTraceScope time_scope("TPDE_Prepass", [function]() {
     // getName is expensive, so only call it when time tracing is enabled.
@@ -250,6 +300,7 @@ bool LLVMAdaptor::switch_func(const IRFuncRef function) noexcept {
   block_succ_ranges.clear();
   initial_stack_slot_indices.clear();
   func_has_dynamic_alloca = false;
+  func_private_cc = func_has_private_cc(function);
 
   // we keep globals around for all function compilation
   // and assign their value indices at the start of the compilation
@@ -398,6 +449,9 @@ bool LLVMAdaptor::switch_func(const IRFuncRef function) noexcept {
         BlockInfo{.block = &block, .aux = BlockAux{.phi_end = it}});
   }
 
+  // Number of predecessor edges and unlikely predecessor edges of each block.
+  tpde::util::SmallVector<std::pair<u32, u32>, 128> pred_counts;
+  pred_counts.resize(blocks.size(), std::make_pair(0u, 0u));
   for (BlockInfo &info : blocks) {
     llvm::BasicBlock *block = info.block;
     for (auto it = block->begin(), end = block->end(); it != end;) {
@@ -418,14 +472,47 @@ bool LLVMAdaptor::switch_func(const IRFuncRef function) noexcept {
       ++info.aux.phi_end; // phi_end points to the instr after the phi again
     }
 
+    const llvm::Instruction *term = block->getTerminator();
+    // Error paths and exception handling are unlikely to be executed.
+    info.cold = llvm::isa<llvm::UnreachableInst>(term) || block->isEHPad();
+
+    llvm::SmallVector<u32, 4> weights;
+    u64 weight_sum = 0, weight_max = 0;
+    if (branch_weights(term, weights)) {
+      for (u32 weight : weights) {
+        weight_sum += weight;
+        weight_max = std::max(weight_max, u64{weight});
+      }
+    }
+
     const u32 start_idx = block_succ_indices.size();
-    for (auto *succ : llvm::successors(info.block)) {
-      block_succ_indices.push_back(block_lookup_idx(succ));
+    for (u32 i = 0, n = term->getNumSuccessors(); i < n; ++i) {
+      const IRBlockRef succ = block_lookup_idx(term->getSuccessor(i));
+      block_succ_indices.push_back(succ);
+      ++pred_counts[succ].first;
+      if (weight_max == 0) {
+        continue;
+      }
+      // Edges with less than ~6% probability are unlikely, the successor
+      // with at least 80% probability is likely.
+      if (u64{weights[i]} * 16 <= weight_sum) {
+        ++pred_counts[succ].second;
+      } else if (u64{weights[i]} * 5 >= weight_sum * 4) {
+        info.likely_succ = succ;
+      }
     }
     block_succ_ranges.push_back(
         std::make_pair(start_idx, block_succ_indices.size()));
   }
 
+  // Blocks that are only reached through unlikely edges are cold.
+  for (u32 i = 1; i < blocks.size(); ++i) {
+    const auto [num_preds, num_unlikely] = pred_counts[i];
+    if (num_preds != 0 && num_preds == num_unlikely) {
+      blocks[i].cold = true;
+    }
+  }
+
   return !func_unsupported;
 }
 
@@ -438,6 +525,47 @@ void LLVMAdaptor::switch_module(llvm::Module &mod) noexcept {
   this->mod->setDataLayout(data_layout);
 }
 
+bool LLVMAdaptor::private_cc_ret_fits(llvm::Type *ret_ty) noexcept {
+  if (ret_ty->isVoidTy()) {
+    return true;
+  }
+  // Return registers of the private conventions of all targets: 9 GP and 16
+  // vector registers on x86-64, more on AArch64.
+  constexpr u32 MaxGP = 9, MaxFP = 16;
+  auto [bvt, ty_idx] = lower_type(ret_ty);
+  const LLVMComplexPart *complex = nullptr;
+  if (bvt == LLVMBasicValType::complex) {
+    complex = &complex_part_types[ty_idx];
+  }
+  ValueParts parts{bvt, complex};
+  u32 gp = 0, fp = 0;
+  for (u32 i = 0; i < parts.count(); ++i) {
+    ++(parts.reg_bank(i) == tpde::RegBank{0} ? gp : fp);
+  }
+  return gp <= MaxGP && fp <= MaxFP;
+}
+
+bool LLVMAdaptor::func_has_private_cc(const llvm::Function *fn) noexcept {
+  if (!fn->hasLocalLinkage() || fn->isDeclaration() || fn->isVarArg()) {
+    return false;
+  }
+  switch (fn->getCallingConv()) {
+  case llvm::CallingConv::C:
+  case llvm::CallingConv::Fast: break;
+  default: return false;
+  }
+
+  auto [it, inserted] = private_cc_funcs.try_emplace(fn, false);
+  if (inserted) {
+    // Any use other than the callee operand of a call with matching function
+    // type lets the function escape. nest arguments use a fixed register.
+    it->second = !fn->hasAddressTaken() &&
+                 !fn->getAttributes().hasAttrSomewhere(llvm::Attribute::Nest) &&
+                 private_cc_ret_fits(fn->getReturnType());
+  }
+  return it->second;
+}
+
 void LLVMAdaptor::reset() noexcept {
   context = nullptr;
   mod = nullptr;
@@ -453,6 +581,7 @@ void LLVMAdaptor::reset() noexcept {
   complex_part_types.clear();
   complex_type_map.clear();
   initial_stack_slot_indices.clear();
+  private_cc_funcs.clear();
   cur_func = nullptr;
   globals_init = false;
   blocks.clear();
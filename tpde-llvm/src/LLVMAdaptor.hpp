@@ -196,6 +196,11 @@ struct LLVMAdaptor {
   struct BlockInfo {
     llvm::BasicBlock *block;
     BlockAux aux;
+    /// Successor that is most likely executed next, from branch weights or
+    /// llvm.expect.
+    IRBlockRef likely_succ = INVALID_BLOCK_REF;
+    /// Block is unlikely to be executed.
+    bool cold = false;
   };
 
   /// Value info. Values are numbered in the following order:
@@ -222,11 +227,15 @@ struct LLVMAdaptor {
   // helpers for faster lookup
   tpde::util::SmallVector<const llvm::AllocaInst *, 16>
       initial_stack_slot_indices;
+  /// Cache for func_has_private_cc, determining this requires a walk over all
+  /// uses of the function.
+  llvm::DenseMap<const llvm::Function *, bool> private_cc_funcs;
 
   llvm::Function *cur_func = nullptr;
   bool func_unsupported = false;
   bool globals_init = false;
   bool func_has_dynamic_alloca = false;
+  bool func_private_cc = false;
 
   tpde::util::SmallVector<BlockInfo, 128> blocks;
   tpde::util::SmallVector<u32, 256> block_succ_indices;
@@ -236,6 +245,8 @@ struct LLVMAdaptor {
 
   static constexpr bool TPDE_PROVIDES_HIGHEST_VAL_IDX = true;
   static constexpr bool TPDE_LIVENESS_VISIT_ARGS = true;
+  static constexpr bool TPDE_PROVIDES_BLOCK_HINTS = true;
+  static constexpr bool TPDE_PROVIDES_PURE_INSTS = true;
 
   [[nodiscard]] u32 func_count() const noexcept {
     return mod->getFunctionList().size();
@@ -267,6 +278,21 @@ struct LLVMAdaptor {
     return func->isWeakForLinker();
   }
 
+  /// Whether the function can use a private calling convention, i.e. it has
+  /// local linkage, is defined in this module, and is only used as callee of
+  /// direct calls.
+  [[nodiscard]] bool func_has_private_cc(const llvm::Function *fn) noexcept;
+
+private:
+  /// Whether a value of the type can be returned in registers by the private
+  /// calling convention; otherwise, the C convention is used.
+  bool private_cc_ret_fits(llvm::Type *ret_ty) noexcept;
+
+public:
+  [[nodiscard]] bool cur_has_private_cc() const noexcept {
+    return func_private_cc;
+  }
+
   [[nodiscard]] bool cur_needs_unwind_info() const noexcept {
     return cur_func->needsUnwindTableEntry();
   }
@@ -328,6 +354,15 @@ struct LLVMAdaptor {
                       block_succ_indices.data() + end};
   }
 
+  [[nodiscard]] bool block_is_cold(const IRBlockRef block) const noexcept {
+    return blocks[block].cold;
+  }
+
+  [[nodiscard]] IRBlockRef
+      block_likely_succ(const IRBlockRef block) const noexcept {
+    return blocks[block].likely_succ;
+  }
+
   [[nodiscard]] auto block_insts(const IRBlockRef block) const noexcept {
     const auto &aux = blocks[block].aux;
     return std::ranges::subrange(aux.phi_end, blocks[block].block->end()) |
@@ -582,6 +617,11 @@ public:
     return val_info(inst).fused;
   }
 
+  [[nodiscard]] bool inst_is_pure(const IRInstRef inst) const noexcept {
+    return !inst->mayHaveSideEffects() && !inst->isTerminator() &&
+           !inst->isEHPad();
+  }
+
   void inst_set_fused(const IRInstRef value, const bool fused) noexcept {
     values[inst_lookup_idx(value)].fused = fused;
   }
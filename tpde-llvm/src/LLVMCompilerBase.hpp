@@ -4,11 +4,13 @@
 #pragma once
 
 #include <elf.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/Analysis/ConstantFolding.h>
 #include <llvm/IR/Comdat.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/GlobalIFunc.h>
 #include <llvm/IR/GlobalObject.h>
 #include <llvm/IR/GlobalValue.h>
@@ -25,6 +27,7 @@
 
 
 #include "tpde/CompilerBase.hpp"
+#include "tpde/ElfLinker.hpp"
 #include "tpde/ValLocalIdx.hpp"
 #include "tpde/ValueAssignment.hpp"
 #include "tpde/base.hpp"
@@ -232,6 +235,24 @@ struct LLVMCompilerBase : public LLVMCompiler,
 
   llvm::TimeTraceProfilerEntry *time_entry;
 
+  /// Whether instructions with only constant operands are folded instead of
+  /// being computed at run time.
+  bool fold_constants = false;
+
+  /// Whether a line table is emitted from the debug locations.
+  bool emit_line_table = false;
+  /// Line table file index for every file of a debug location.
+  llvm::DenseMap<const llvm::DIFile *, u32> line_files;
+  /// Debug location of the last line table row, to skip repeated lookups.
+  const llvm::DILocation *last_line_loc = nullptr;
+
+  /// Whether mapped functions are recorded in the perf map.
+  bool perf_map = false;
+  /// Whether mapped functions are recorded in the jitdump file.
+  bool jitdump = false;
+  /// Whether mapped modules are registered with the GDB JIT interface.
+  bool gdb_jit = false;
+
   LLVMCompilerBase(LLVMAdaptor *adaptor) : Base{adaptor} {
     static_assert(tpde::Compiler<Derived, Config>);
     static_assert(std::is_same_v<Adaptor, LLVMAdaptor>);
@@ -387,6 +408,17 @@ public:
     // Reuse/release memory for stored constants from previous function
     const_allocator.reset();
 
+    // These conventions are only supported for calls; the prologue can't save
+    // the additional callee-saved registers.
+    switch (func->getCallingConv()) {
+    case llvm::CallingConv::PreserveMost:
+    case llvm::CallingConv::PreserveAll:
+      TPDE_LOG_ERR("unsupported calling convention for function {}",
+                   std::string_view(func->getName()));
+      return false;
+    default: break;
+    }
+
     SecRef sec = this->select_section(this->func_syms[idx], func, true);
     if (!sec.valid()) [[unlikely]] {
       TPDE_LOG_ERR("unable to determine section for function {}",
@@ -413,12 +445,27 @@ public:
 
   bool compile_inst(const llvm::Instruction *, InstRange) noexcept;
 
+  /// Start a line table row for the debug location of the instruction.
+  void set_line(const llvm::Instruction *) noexcept;
+
+  /// Fold an instruction with only constant operands to a constant and
+  /// replace all its uses, so that no code needs to be emitted for it and its
+  /// users see an immediate operand. Returns true if the instruction was
+  /// folded.
+  bool try_fold_inst(const llvm::Instruction *) noexcept;
+
   bool compile_unreachable(const llvm::Instruction *,
                            const ValInfo &,
                            u64) noexcept;
   bool compile_ret(const llvm::Instruction *, const ValInfo &, u64) noexcept;
   bool compile_load_generic(const llvm::LoadInst *,
                             GenericValuePart &&) noexcept;
+  /// Try to fold a single-use load into its user, which immediately follows
+  /// the load, e.g. as memory operand. Returns true if the user was compiled;
+  /// the address must only be consumed in that case.
+  bool try_fold_load(const llvm::LoadInst *, GenericValuePart &) noexcept {
+    return false;
+  }
   bool compile_load(const llvm::Instruction *, const ValInfo &, u64) noexcept;
   bool compile_store_generic(const llvm::StoreInst *,
                              GenericValuePart &&) noexcept;
@@ -483,13 +530,38 @@ public:
                            const ValInfo &,
                            u64) noexcept;
 
+  /// Conditional branch that only tests an i1 element of an aggregate result,
+  /// see find_flag_branch.
+  struct FlagBranch {
+    const llvm::BranchInst *br = nullptr;
+    /// Extractvalue of element 0 whose result must be computed, or nullptr.
+    const llvm::ExtractValueInst *val = nullptr;
+  };
+
+  /// Find a conditional branch on element flag_idx of the aggregate result of
+  /// inst that can consume the flag directly. Only extractvalues of inst may
+  /// be placed between inst and the branch, which must be the only users of
+  /// inst; the flag must only be used by the branch.
+  FlagBranch find_flag_branch(const llvm::Instruction *inst,
+                              unsigned flag_idx) noexcept;
+  /// Mark the extractvalues and the branch found by find_flag_branch as fused.
+  void fuse_flag_branch(const llvm::Instruction *inst,
+                        const FlagBranch &) noexcept;
+
+  bool compile_cmpxchg_generic(const llvm::AtomicCmpXchgInst *,
+                               GenericValuePart &&) noexcept;
   bool
       compile_cmpxchg(const llvm::Instruction *, const ValInfo &, u64) noexcept;
+  bool compile_atomicrmw_generic(const llvm::AtomicRMWInst *,
+                                 GenericValuePart &&) noexcept;
   bool compile_atomicrmw(const llvm::Instruction *,
                          const ValInfo &,
                          u64) noexcept;
   bool compile_fence(const llvm::Instruction *, const ValInfo &, u64) noexcept;
   bool compile_freeze(const llvm::Instruction *, const ValInfo &, u64) noexcept;
+  /// Return the ret instruction if the call can be compiled as tail call
+  /// independent of argument passing, otherwise nullptr.
+  const llvm::ReturnInst *tail_call_ret(const llvm::CallInst *) noexcept;
   bool compile_call(const llvm::Instruction *, const ValInfo &, u64) noexcept;
   bool compile_select(const llvm::Instruction *, const ValInfo &, u64) noexcept;
   bool compile_alloca(const llvm::Instruction *, const ValInfo &, u64) noexcept;
@@ -522,8 +594,45 @@ public:
 
   bool handle_intrin(const llvm::IntrinsicInst *) noexcept { return false; }
 
+  void set_split_cold_code(bool enable) noexcept override {
+    this->split_cold_code = enable;
+  }
+
+  void set_eliminate_dead_code(bool enable) noexcept override {
+    this->analyzer.eliminate_dead_insts = enable;
+  }
+
+  void set_fold_constants(bool enable) noexcept override {
+    fold_constants = enable;
+  }
+
+  void set_elide_redundant_ext(bool enable) noexcept override {
+    this->elide_redundant_ext = enable;
+  }
+
+  void set_emit_line_table(bool enable) noexcept override {
+    emit_line_table = enable;
+  }
+
+  void set_perf_map(bool enable) noexcept override { perf_map = enable; }
+
+  void set_jitdump(bool enable) noexcept override { jitdump = enable; }
+
+  void set_gdb_jit(bool enable) noexcept override { gdb_jit = enable; }
+
   bool compile_to_elf(llvm::Module &mod,
                       std::vector<uint8_t> &buf) noexcept override;
+  bool compile_to_elf(
+      llvm::Module &mod,
+      std::function<bool(std::span<const uint8_t>)> write) noexcept override;
+  bool compile_to_shared(
+      llvm::Module &mod,
+      const LinkOptions &options,
+      std::function<bool(std::span<const uint8_t>)> write) noexcept override;
+  bool compile_to_executable(
+      llvm::Module &mod,
+      const LinkOptions &options,
+      std::function<bool(std::span<const uint8_t>)> write) noexcept override;
 
   JITMapper compile_and_map(
       llvm::Module &mod,
@@ -1039,6 +1148,22 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::
       }
     }
 
+    // Unnamed constants in default sections go to mergeable sections, so that
+    // identical strings and constants are stored only once.
+    if (!is_zero && relocs.empty() && gv->isConstant() &&
+        gv->hasGlobalUnnamedAddr() && !gv->hasSection() && !gv->hasComdat() &&
+        !gv->isThreadLocal() && !used_globals.contains(gv)) {
+      auto *cds = llvm::dyn_cast<llvm::ConstantDataSequential>(init);
+      if (cds && cds->isCString() && align == 1) {
+        this->assembler.sym_def_predef_merge(sym, data, true);
+        continue;
+      }
+      if ((size == 4 || size == 8 || size == 16) && align <= size) {
+        this->assembler.sym_def_predef_merge(sym, data, false);
+        continue;
+      }
+    }
+
     SecRef sec = this->select_section(sym, gv, !relocs.empty());
     if (!sec.valid()) [[unlikely]] {
       std::string global_str;
@@ -1304,6 +1429,8 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile(
   global_syms.clear();
   group_secs.clear();
   libfunc_syms.fill({});
+  line_files.clear();
+  last_line_loc = nullptr;
 
   if (!Base::compile()) {
     return false;
@@ -1416,12 +1543,80 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_inst(
     return res;
   }();
 
+  if (emit_line_table) [[unlikely]] {
+    set_line(i);
+  }
+
+  if (fold_constants && try_fold_inst(i)) {
+    return true;
+  }
+
   const ValInfo &val_info = this->adaptor->val_info(i);
   assert(i->getOpcode() < fns.size());
   const auto [compile_fn, arg] = fns[i->getOpcode()];
   return (derived()->*compile_fn)(i, val_info, arg);
 }
 
+template <typename Adaptor, typename Derived, typename Config>
+void LLVMCompilerBase<Adaptor, Derived, Config>::set_line(
+    const llvm::Instruction *inst) noexcept {
+  const llvm::DILocation *loc = inst->getDebugLoc().get();
+  // The row list is empty at the start of every function.
+  if (!loc || (loc == last_line_loc && !this->text_writer.line_rows.empty())) {
+    return;
+  }
+  last_line_loc = loc;
+
+  const llvm::DIFile *file = loc->getFile();
+  auto [it, inserted] = line_files.try_emplace(file, 0);
+  if (inserted) {
+    std::string_view dir, name;
+    if (file) {
+      dir = file->getDirectory();
+      name = file->getFilename();
+    }
+    it->second = this->assembler.line_add_file(dir, name);
+  }
+  this->text_writer.set_line(it->second, loc->getLine(), loc->getColumn());
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::try_fold_inst(
+    const llvm::Instruction *inst) noexcept {
+  if (!llvm::isa<llvm::BinaryOperator,
+                 llvm::UnaryOperator,
+                 llvm::CastInst,
+                 llvm::CmpInst,
+                 llvm::SelectInst>(inst)) {
+    return false;
+  }
+  for (const llvm::Use &op : inst->operands()) {
+    // Global addresses are only known after linking.
+    if (!llvm::isa<llvm::Constant>(op) || llvm::isa<llvm::GlobalValue>(op)) {
+      return false;
+    }
+  }
+
+  auto *mut_inst = const_cast<llvm::Instruction *>(inst);
+  llvm::Constant *folded =
+      llvm::ConstantFoldInstruction(mut_inst, this->adaptor->data_layout);
+  // Only accept constants that val_ref_constant can materialize.
+  if (!folded ||
+      !llvm::isa<llvm::ConstantInt,
+                 llvm::ConstantFP,
+                 llvm::ConstantPointerNull,
+                 llvm::UndefValue,
+                 llvm::ConstantAggregateZero,
+                 llvm::ConstantDataVector>(folded)) {
+    return false;
+  }
+
+  TPDE_LOG_TRACE("Folded {} to constant", this->adaptor->inst_fmt_ref(inst));
+  // The instruction has no assignment, so its references are never consumed.
+  mut_inst->replaceAllUsesWith(folded);
+  return true;
+}
+
 template <typename Adaptor, typename Derived, typename Config>
 bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_unreachable(
     const llvm::Instruction *, const ValInfo &, u64) noexcept {
@@ -1531,6 +1726,18 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_load_generic(
     return true;
   }
 
+  if (!load->isVolatile() && load->hasOneUse()) {
+    // The user must immediately follow the load, so that the memory access
+    // stays at the same position relative to all other memory accesses and
+    // all other operands of the user are already computed.
+    const llvm::Instruction *next = load->getNextNode();
+    if (*load->user_begin() == next &&
+        derived()->try_fold_load(load, ptr_op)) {
+      this->adaptor->inst_set_fused(next, true);
+      return true;
+    }
+  }
+
   unsigned num_bits;
   bool sext = false;
   const llvm::Instruction *target = load;
@@ -1583,7 +1790,13 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_load_generic(
       return res;
     }();
     EncodeFnTy fn = fns[(num_bits - 1) / 8][sext];
-    (derived()->*fn)(std::move(ptr_op), this->result_ref(target).part(0));
+    ValueRef res = this->result_ref(target);
+    (derived()->*fn)(std::move(ptr_op), res.part(0));
+    // 8/16/32-bit loads zero-extend to the full register.
+    if (!sext && !llvm::isa<llvm::TruncInst>(target) && num_bits <= 32 &&
+        (num_bits & (num_bits - 1)) == 0) {
+      res.part(0).set_upper_bits_zero();
+    }
     break;
   }
   case v8i1:
@@ -1630,14 +1843,20 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_load_generic(
         &this->adaptor->complex_part_types[ty_idx + 1];
     unsigned part_count = part_descs[-1].desc.num_parts;
 
-    // TODO: fuse expr; not easy, because we lose the GVP
+    // Only materialize base and index; the displacement of a fused address is
+    // folded into the accesses of the individual parts.
+    tpde::i64 disp = 0;
+    using Expr = typename GenericValuePart::Expr;
+    if (auto *expr = std::get_if<Expr>(&ptr_op.state)) {
+      disp = expr->disp;
+      expr->disp = 0;
+    }
     AsmReg ptr_reg = this->gval_as_reg(ptr_op);
 
     ValueRef res = this->result_ref(target);
     unsigned off = 0;
     for (unsigned i = 0; i < part_count; i++) {
-      auto part_addr =
-          typename GenericValuePart::Expr{ptr_reg, static_cast<tpde::i32>(off)};
+      auto part_addr = Expr{ptr_reg, disp + off};
       auto part_ty = part_descs[i].part.type;
       switch (part_ty) {
       case i1:
@@ -1851,14 +2070,20 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_store_generic(
         &this->adaptor->complex_part_types[ty_idx + 1];
     unsigned part_count = part_descs[-1].desc.num_parts;
 
-    // TODO: fuse expr; not easy, because we lose the GVP
+    // Only materialize base and index; the displacement of a fused address is
+    // folded into the accesses of the individual parts.
+    tpde::i64 disp = 0;
+    using Expr = typename GenericValuePart::Expr;
+    if (auto *expr = std::get_if<Expr>(&ptr_op.state)) {
+      disp = expr->disp;
+      expr->disp = 0;
+    }
     AsmReg ptr_reg = this->gval_as_reg(ptr_op);
 
     unsigned off = 0;
     for (unsigned i = 0; i < part_count; i++) {
       auto part_ref = op_ref.part(i);
-      auto part_addr =
-          typename GenericValuePart::Expr{ptr_reg, static_cast<tpde::i32>(off)};
+      auto part_addr = Expr{ptr_reg, disp + off};
       // Note: val_ref might call val_ref_special, which calls val_parts, which
       // calls lower_type, which will invalidate part_descs.
       // TODO: don't recompute value parts for every constant part
@@ -2627,7 +2852,11 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_int_ext(
     }
   }
 
-  res.part(0).set_value(std::move(low));
+  ValuePartRef res_low = res.part(0);
+  res_low.set_value(std::move(low));
+  if (!sign) {
+    res_low.set_upper_bits_zero();
+  }
   return true;
 }
 
@@ -2635,6 +2864,9 @@ template <typename Adaptor, typename Derived, typename Config>
 bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_ptr_to_int(
     const llvm::Instruction *inst, const ValInfo &val_info, u64) noexcept {
   ValueRef src = this->val_ref(inst->getOperand(0));
+  if (this->try_alias_value(src, inst)) {
+    return true;
+  }
   ValueRef res = this->result_ref(inst);
 
   llvm::Type *dst_ty = inst->getType();
@@ -2665,6 +2897,9 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_int_to_ptr(
   const auto bit_width = src_val->getType()->getIntegerBitWidth();
 
   auto src_ref = this->val_ref(src_val);
+  if (this->try_alias_value(src_ref, inst)) {
+    return true;
+  }
   auto [res_vr, res_ref] = this->result_ref_single(inst);
   if (bit_width == 64) {
     // no-op
@@ -2684,6 +2919,9 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_bitcast(
     const llvm::Instruction *inst, const ValInfo &val_info, u64) noexcept {
   const auto src = inst->getOperand(0);
   ValueRef src_ref = this->val_ref(src);
+  if (this->try_alias_value(src_ref, inst)) {
+    return true;
+  }
   ValueRef res_ref = this->result_ref(inst);
 
   const auto src_part_count = this->adaptor->val_parts(src).count();
@@ -3206,9 +3444,54 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_icmp_vector(
 }
 
 template <typename Adaptor, typename Derived, typename Config>
-bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_cmpxchg(
-    const llvm::Instruction *inst, const ValInfo &, u64) noexcept {
-  const auto *cmpxchg = llvm::cast<llvm::AtomicCmpXchgInst>(inst);
+typename LLVMCompilerBase<Adaptor, Derived, Config>::FlagBranch
+    LLVMCompilerBase<Adaptor, Derived, Config>::find_flag_branch(
+        const llvm::Instruction *inst, unsigned flag_idx) noexcept {
+  FlagBranch res{};
+  const llvm::ExtractValueInst *flag = nullptr;
+  unsigned num_uses = 0;
+  const llvm::Instruction *next = inst->getNextNode();
+  while (auto *ev = llvm::dyn_cast<llvm::ExtractValueInst>(next)) {
+    if (ev->getAggregateOperand() != inst || ev->getNumIndices() != 1) {
+      return {};
+    }
+    unsigned idx = ev->getIndices()[0];
+    if (ev->use_empty()) {
+      // Unused extractvalue, nothing to compute.
+    } else if (idx == flag_idx && !flag && ev->hasOneUse()) {
+      flag = ev;
+    } else if (idx == 0 && !res.val) {
+      res.val = ev;
+    } else {
+      return {};
+    }
+    ++num_uses;
+    next = next->getNextNode();
+  }
+
+  const auto *br = llvm::dyn_cast<llvm::BranchInst>(next);
+  if (!flag || !br || !br->isConditional() || br->getCondition() != flag ||
+      !inst->hasNUses(num_uses)) {
+    return {};
+  }
+  res.br = br;
+  return res;
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+void LLVMCompilerBase<Adaptor, Derived, Config>::fuse_flag_branch(
+    const llvm::Instruction *inst, const FlagBranch &fb) noexcept {
+  for (auto *next = inst->getNextNode(); next != fb.br;
+       next = next->getNextNode()) {
+    this->adaptor->inst_set_fused(next, true);
+  }
+  this->adaptor->inst_set_fused(fb.br, true);
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_cmpxchg_generic(
+    const llvm::AtomicCmpXchgInst *cmpxchg,
+    GenericValuePart &&ptr_op) noexcept {
   auto *new_val = cmpxchg->getNewValOperand();
   auto *val_ty = new_val->getType();
   unsigned width = 64;
@@ -3261,38 +3544,67 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_cmpxchg(
     return res;
   }();
 
-  auto ptr_ref = this->val_ref(cmpxchg->getPointerOperand());
-  auto cmp_ref = this->val_ref(cmpxchg->getCompareOperand());
-  auto new_ref = this->val_ref(new_val);
-  auto res = this->result_ref(cmpxchg);
-
   llvm::AtomicOrdering order = cmpxchg->getMergedOrdering();
   EncodeFnTy encode_fn = fns[width_idx][size_t(order)];
   assert(encode_fn && "invalid cmpxchg ordering");
-  if (!(derived()->*encode_fn)(ptr_ref.part(0),
-                               cmp_ref.part(0),
-                               new_ref.part(0),
-                               res.part(0),
-                               res.part(1))) {
-    return false;
+
+  // Loops generated by clang branch on the success flag directly:
+  //   %4 = cmpxchg ptr %0, i64 %3, i64 1 seq_cst seq_cst, align 8
+  //   %5 = extractvalue { i64, i1 } %4, 1
+  //   %6 = extractvalue { i64, i1 } %4, 0
+  //   br i1 %5, label %7, label %2, !llvm.loop !3
+  // In this case, the aggregate is never materialized and the branch tests the
+  // success register.
+  FlagBranch fb = find_flag_branch(cmpxchg, 1);
+  if (!fb.br) {
+    auto cmp_ref = this->val_ref(cmpxchg->getCompareOperand());
+    auto new_ref = this->val_ref(new_val);
+    auto res = this->result_ref(cmpxchg);
+    return (derived()->*encode_fn)(std::move(ptr_op),
+                                   cmp_ref.part(0),
+                                   new_ref.part(0),
+                                   res.part(0),
+                                   res.part(1));
+  }
+
+  ValuePartRef orig{this, Config::GP_BANK};
+  ValuePartRef success{this, Config::GP_BANK};
+  {
+    auto cmp_ref = this->val_ref(cmpxchg->getCompareOperand());
+    auto new_ref = this->val_ref(new_val);
+    if (!(derived()->*encode_fn)(std::move(ptr_op),
+                                 cmp_ref.part(0),
+                                 new_ref.part(0),
+                                 std::move(orig),
+                                 std::move(success))) {
+      return false;
+    }
   }
 
-  // clang-format off
-    // TODO(ts): fusing with subsequent extractvalues + br's
-    // e.g. clang generates
-    // %4 = cmpxchg ptr %0, i64 %3, i64 1 seq_cst seq_cst, align 8
-    // %5 = extractvalue { i64, i1 } %4, 1
-    // %6 = extractvalue { i64, i1 } %4, 0
-    // br i1 %5, label %7, label %2, !llvm.loop !3
-  // clang-format on
+  fuse_flag_branch(cmpxchg, fb);
+  if (fb.val) {
+    this->result_ref(fb.val).part(0).set_value(std::move(orig));
+  }
+  orig.reset();
 
+  auto jump = derived()->generate_bool_test(success.cur_reg());
+  auto true_block = this->adaptor->block_lookup_idx(fb.br->getSuccessor(0));
+  auto false_block = this->adaptor->block_lookup_idx(fb.br->getSuccessor(1));
+  derived()->generate_conditional_branch(jump, true_block, false_block);
   return true;
 }
 
 template <typename Adaptor, typename Derived, typename Config>
-bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_atomicrmw(
-    const llvm::Instruction *inst, const ValInfo &val_info, u64) noexcept {
-  const auto *rmw = llvm::cast<llvm::AtomicRMWInst>(inst);
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_cmpxchg(
+    const llvm::Instruction *inst, const ValInfo &, u64) noexcept {
+  const auto *cmpxchg = llvm::cast<llvm::AtomicCmpXchgInst>(inst);
+  auto [_, ptr_ref] = this->val_ref_single(cmpxchg->getPointerOperand());
+  return compile_cmpxchg_generic(cmpxchg, std::move(ptr_ref));
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_atomicrmw_generic(
+    const llvm::AtomicRMWInst *rmw, GenericValuePart &&ptr_op) noexcept {
   llvm::Type *ty = rmw->getType();
   unsigned size = this->adaptor->mod->getDataLayout().getTypeSizeInBits(ty);
   // This is checked by the IR verifier.
@@ -3311,165 +3623,116 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_atomicrmw(
     return false;
   }
 
-  auto bvt = val_info.type;
+  auto bvt = this->adaptor->val_info(rmw).type;
+
+  unsigned ord_idx;
+  switch (rmw->getOrdering()) {
+    using enum llvm::AtomicOrdering;
+  case Monotonic: ord_idx = 0; break;
+  case Acquire: ord_idx = 1; break;
+  case Release: ord_idx = 2; break;
+  case AcquireRelease: ord_idx = 3; break;
+  case SequentiallyConsistent: ord_idx = 4; break;
+  default: TPDE_UNREACHABLE("invalid atomicrmw ordering");
+  }
+
+  // If the old value is not used, add/sub/and/or/xor don't need to fetch it,
+  // which avoids cmpxchg loops for and/or/xor on x86-64.
+  bool noret = rmw->use_empty();
 
-  // TODO: implement non-seq_cst orderings more efficiently
-  // TODO: use more efficient implementation when the result is not used. On
-  // x86-64, the current implementation gives many cmpxchg loops.
+  // ptr, val, old_val
   bool (Derived::*fn)(GenericValuePart &&, GenericValuePart &&, ValuePart &&) =
       nullptr;
+  // ptr, val
+  bool (Derived::*fn_noret)(GenericValuePart &&, GenericValuePart &&) =
+      nullptr;
+
+#define ORD_FN(name)                                                           \
+  std::array{&Derived::encode_atomic_##name##_monotonic,                       \
+             &Derived::encode_atomic_##name##_acquire,                         \
+             &Derived::encode_atomic_##name##_release,                         \
+             &Derived::encode_atomic_##name##_acqrel,                          \
+             &Derived::encode_atomic_##name##_seqcst}[ord_idx]
+#define INT_FN(op, sign)                                                       \
+  switch (bvt) {                                                               \
+    using enum LLVMBasicValType;                                               \
+  case i8: fn = ORD_FN(op##_##sign##8); break;                                 \
+  case i16: fn = ORD_FN(op##_##sign##16); break;                               \
+  case i32: fn = ORD_FN(op##_##sign##32); break;                               \
+  case i64: fn = ORD_FN(op##_##sign##64); break;                               \
+  default: return false;                                                       \
+  }
+#define INT_NORET_FN(op)                                                       \
+  if (noret) {                                                                 \
+    switch (bvt) {                                                             \
+      using enum LLVMBasicValType;                                             \
+    case i8: fn_noret = ORD_FN(op##_u8_noret); break;                          \
+    case i16: fn_noret = ORD_FN(op##_u16_noret); break;                        \
+    case i32: fn_noret = ORD_FN(op##_u32_noret); break;                        \
+    case i64: fn_noret = ORD_FN(op##_u64_noret); break;                        \
+    default: return false;                                                     \
+    }                                                                          \
+  } else {                                                                     \
+    INT_FN(op, u)                                                              \
+  }
+#define FP_FN(op)                                                              \
+  switch (bvt) {                                                               \
+    using enum LLVMBasicValType;                                               \
+  case f32: fn = ORD_FN(op##_f32); break;                                      \
+  case f64: fn = ORD_FN(op##_f64); break;                                      \
+  default: return false;                                                       \
+  }
+
   switch (rmw->getOperation()) {
   case llvm::AtomicRMWInst::Xchg:
-    // TODO: support f32/f64
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_xchg_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_xchg_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_xchg_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_xchg_u64_seqcst; break;
-    case ptr: fn = &Derived::encode_atomic_xchg_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Add:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_add_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_add_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_add_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_add_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Sub:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_sub_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_sub_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_sub_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_sub_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::And:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_and_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_and_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_and_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_and_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Nand:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_nand_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_nand_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_nand_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_nand_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Or:
     switch (bvt) {
       using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_or_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_or_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_or_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_or_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Xor:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_xor_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_xor_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_xor_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_xor_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Min:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_min_i8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_min_i16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_min_i32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_min_i64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::Max:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_max_i8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_max_i16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_max_i32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_max_i64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::UMin:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_min_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_min_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_min_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_min_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::UMax:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case i8: fn = &Derived::encode_atomic_max_u8_seqcst; break;
-    case i16: fn = &Derived::encode_atomic_max_u16_seqcst; break;
-    case i32: fn = &Derived::encode_atomic_max_u32_seqcst; break;
-    case i64: fn = &Derived::encode_atomic_max_u64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::FAdd:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case f32: fn = &Derived::encode_atomic_add_f32_seqcst; break;
-    case f64: fn = &Derived::encode_atomic_add_f64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::FSub:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case f32: fn = &Derived::encode_atomic_sub_f32_seqcst; break;
-    case f64: fn = &Derived::encode_atomic_sub_f64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::FMin:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case f32: fn = &Derived::encode_atomic_min_f32_seqcst; break;
-    case f64: fn = &Derived::encode_atomic_min_f64_seqcst; break;
-    default: return false;
-    }
-    break;
-  case llvm::AtomicRMWInst::FMax:
-    switch (bvt) {
-      using enum LLVMBasicValType;
-    case f32: fn = &Derived::encode_atomic_max_f32_seqcst; break;
-    case f64: fn = &Derived::encode_atomic_max_f64_seqcst; break;
+    case i8: fn = ORD_FN(xchg_u8); break;
+    case i16: fn = ORD_FN(xchg_u16); break;
+    case i32: fn = ORD_FN(xchg_u32); break;
+    case i64: fn = ORD_FN(xchg_u64); break;
+    case ptr: fn = ORD_FN(xchg_u64); break;
+    case f32: fn = ORD_FN(xchg_f32); break;
+    case f64: fn = ORD_FN(xchg_f64); break;
     default: return false;
     }
     break;
+  case llvm::AtomicRMWInst::Add: INT_NORET_FN(add) break;
+  case llvm::AtomicRMWInst::Sub: INT_NORET_FN(sub) break;
+  case llvm::AtomicRMWInst::And: INT_NORET_FN(and) break;
+  case llvm::AtomicRMWInst::Nand: INT_FN(nand, u) break;
+  case llvm::AtomicRMWInst::Or: INT_NORET_FN(or) break;
+  case llvm::AtomicRMWInst::Xor: INT_NORET_FN(xor) break;
+  case llvm::AtomicRMWInst::Min: INT_FN(min, i) break;
+  case llvm::AtomicRMWInst::Max: INT_FN(max, i) break;
+  case llvm::AtomicRMWInst::UMin: INT_FN(min, u) break;
+  case llvm::AtomicRMWInst::UMax: INT_FN(max, u) break;
+  case llvm::AtomicRMWInst::FAdd: FP_FN(add) break;
+  case llvm::AtomicRMWInst::FSub: FP_FN(sub) break;
+  case llvm::AtomicRMWInst::FMin: FP_FN(min) break;
+  case llvm::AtomicRMWInst::FMax: FP_FN(max) break;
   default: return false;
   }
 
-  auto ptr_ref = this->val_ref(rmw->getPointerOperand());
+#undef FP_FN
+#undef INT_NORET_FN
+#undef INT_FN
+#undef ORD_FN
+
   auto val_ref = this->val_ref(rmw->getValOperand());
+  if (fn_noret) {
+    return (derived()->*fn_noret)(std::move(ptr_op), val_ref.part(0));
+  }
   auto res_ref = this->result_ref(rmw);
-  return (derived()->*fn)(ptr_ref.part(0), val_ref.part(0), res_ref.part(0));
+  return (derived()->*fn)(std::move(ptr_op), val_ref.part(0), res_ref.part(0));
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_atomicrmw(
+    const llvm::Instruction *inst, const ValInfo &, u64) noexcept {
+  const auto *rmw = llvm::cast<llvm::AtomicRMWInst>(inst);
+  auto [_, ptr_ref] = this->val_ref_single(rmw->getPointerOperand());
+  return compile_atomicrmw_generic(rmw, std::move(ptr_ref));
 }
 
 template <typename Adaptor, typename Derived, typename Config>
@@ -3498,6 +3761,9 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_freeze(
     const llvm::Instruction *inst, const ValInfo &, u64) noexcept {
   // essentially a no-op
   auto src_ref = this->val_ref(inst->getOperand(0));
+  if (this->try_alias_value(src_ref, inst)) {
+    return true;
+  }
   auto res_ref = this->result_ref(inst);
   const auto part_count = res_ref.assignment()->part_count;
   for (u32 part_idx = 0; part_idx < part_count; ++part_idx) {
@@ -3507,6 +3773,37 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_freeze(
   return true;
 }
 
+template <typename Adaptor, typename Derived, typename Config>
+const llvm::ReturnInst *
+    LLVMCompilerBase<Adaptor, Derived, Config>::tail_call_ret(
+        const llvm::CallInst *call) noexcept {
+  // The call must be immediately followed by a return of its result.
+  auto *ret = llvm::dyn_cast_or_null<llvm::ReturnInst>(call->getNextNode());
+  if (!ret) {
+    return nullptr;
+  }
+  if (ret->getNumOperands() != 0 && ret->getOperand(0) != call) {
+    return nullptr;
+  }
+
+  // Forwarding variadic arguments is not supported.
+  if (this->adaptor->cur_is_vararg() && call->isMustTailCall()) {
+    return nullptr;
+  }
+
+  // The caller must not be responsible for extending the return value.
+  if (ret->getNumOperands() != 0) {
+    llvm::AttributeList attrs = this->adaptor->cur_func->getAttributes();
+    llvm::AttributeSet ret_attrs = attrs.getRetAttrs();
+    for (auto kind : {llvm::Attribute::ZExt, llvm::Attribute::SExt}) {
+      if (ret_attrs.hasAttribute(kind) && !call->hasRetAttr(kind)) {
+        return nullptr;
+      }
+    }
+  }
+  return ret;
+}
+
 template <typename Adaptor, typename Derived, typename Config>
 bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_call(
     const llvm::Instruction *inst, const ValInfo &info, u64) noexcept {
@@ -3515,7 +3812,7 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_call(
     return compile_intrin(intrin, info);
   }
 
-  if (call->isMustTailCall() || call->hasOperandBundles()) {
+  if (call->hasOperandBundles()) {
     return false;
   }
 
@@ -3523,6 +3820,16 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_call(
     return derived()->compile_inline_asm(call);
   }
 
+  const bool must_tail = call->isMustTailCall();
+  const llvm::ReturnInst *tail_ret = nullptr;
+  if (auto *ci = llvm::dyn_cast<llvm::CallInst>(call); ci && ci->isTailCall()) {
+    tail_ret = tail_call_ret(ci);
+  }
+  if (must_tail && !tail_ret) {
+    TPDE_LOG_ERR("unsupported musttail call");
+    return false;
+  }
+
   auto cb = derived()->create_call_builder(call);
   if (!cb) {
     return false;
@@ -3580,6 +3887,27 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_call(
     cb->add_arg(arg, this->adaptor->type_part_count(ty, ty_idx));
   }
 
+  std::optional<IRValueRef> tail_ret_val;
+  if (tail_ret && tail_ret->getNumOperands() != 0) {
+    tail_ret_val = call;
+  }
+  if (tail_ret && cb->can_tail_call(tail_ret_val)) {
+    llvm::Value *target = call->getCalledOperand();
+    if (auto *global = llvm::dyn_cast<llvm::GlobalValue>(target)) {
+      cb->tail_call(global_sym(global));
+    } else {
+      auto [_, tgt_vp] = this->val_ref_single(target);
+      cb->tail_call(std::move(tgt_vp));
+    }
+    // The result is only used by the return, which is now part of the call.
+    this->adaptor->inst_set_fused(tail_ret, true);
+    return true;
+  }
+  if (must_tail) {
+    TPDE_LOG_ERR("musttail call with incompatible arguments or convention");
+    return false;
+  }
+
   llvm::Value *target = call->getCalledOperand();
   if (auto *global = llvm::dyn_cast<llvm::GlobalValue>(target)) {
     cb->call(global_sym(global));
@@ -3847,6 +4175,17 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_gep(
     this->adaptor->inst_set_fused(next_val, true);
     return compile_load_generic(load, std::move(addr));
   }
+  if (auto *rmw = llvm::dyn_cast_if_present<llvm::AtomicRMWInst>(next_val);
+      rmw && rmw->getPointerOperand() == gep) {
+    this->adaptor->inst_set_fused(next_val, true);
+    return compile_atomicrmw_generic(rmw, std::move(addr));
+  }
+  if (auto *cmpxchg =
+          llvm::dyn_cast_if_present<llvm::AtomicCmpXchgInst>(next_val);
+      cmpxchg && cmpxchg->getPointerOperand() == gep) {
+    this->adaptor->inst_set_fused(next_val, true);
+    return compile_cmpxchg_generic(cmpxchg, std::move(addr));
+  }
 
   auto [res_vr, res_ref] = this->result_ref_single(gep);
 
@@ -4025,6 +4364,10 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_switch(
     width_is_32 = width <= 32;
     if (u32 dst_width = tpde::util::align_up(width, 32); width != dst_width) {
       cmp_ref = std::move(arg_ref).into_extended(false, width, dst_width);
+      if (cmp_ref.has_assignment()) {
+        // Extension was a no-op; the register is modified below.
+        cmp_ref = std::move(cmp_ref).into_temporary();
+      }
     } else if (arg_ref.has_assignment()) {
       cmp_ref = std::move(arg_ref).into_temporary();
     } else {
@@ -4055,22 +4398,69 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_switch(
     return lhs.first < rhs.first;
   });
 
-  // because some blocks might have PHI-values we need to first jump to a
-  // label which then fixes the registers and then jumps to the block
-  // TODO(ts): check which blocks need PHIs and otherwise jump directly to
-  // them? probably better for branch predictor
+  // Cases jump directly to target blocks without PHI nodes. Cases whose
+  // target has PHI nodes jump to a label, shared per target, that moves the
+  // values into the PHI nodes and then jumps to the block. The map is keyed
+  // by block index, phi_targets keeps the order for emitting the moves.
+  tpde::util::SmallVector<std::pair<IRBlockRef, tpde::Label>, 8> phi_targets;
+  llvm::SmallDenseMap<u32, tpde::Label, 8> phi_target_labels;
+  const auto target_label = [&, this](IRBlockRef target) {
+    const auto target_idx = this->analyzer.block_idx(target);
+    if (!this->analyzer.block_has_phis(target_idx)) {
+      return this->block_labels[u32(target_idx)];
+    }
+    auto [it, inserted] = phi_target_labels.try_emplace(u32(target_idx));
+    if (inserted) {
+      it->second = this->text_writer.label_create();
+      phi_targets.emplace_back(target, it->second);
+    }
+    return it->second;
+  };
 
   tpde::util::SmallVector<tpde::Label, 64> case_labels;
-  for (auto i = 0u; i < cases.size(); ++i) {
-    case_labels.push_back(this->text_writer.label_create());
+  for (const auto &[_, target] : cases) {
+    case_labels.push_back(target_label(target));
   }
 
-  const auto default_label = this->text_writer.label_create();
+  const auto default_label = target_label(
+      this->adaptor->block_lookup_idx(switch_inst->getDefaultDest()));
 
   const auto build_range = [&,
                             this](size_t begin, size_t end, const auto &self) {
     assert(begin <= end);
     const auto num_cases = end - begin;
+    if (num_cases >= 3 && cases[end - 1].first - cases[begin].first < 64) {
+      // The cases fit into a 64-bit mask, so test the value against one mask
+      // per distinct target if there are few targets.
+      const u64 base = cases[end - 1].first < 64 ? 0 : cases[begin].first;
+      tpde::util::SmallVector<std::pair<u64, tpde::Label>, 4> tests;
+      for (auto i = begin; i < end && tests.size() <= 3; ++i) {
+        const u64 bit = u64{1} << (cases[i].first - base);
+        auto it = std::find_if(tests.begin(), tests.end(), [&](const auto &t) {
+          return t.second == case_labels[i];
+        });
+        if (it != tests.end()) {
+          it->first |= bit;
+        } else {
+          tests.emplace_back(bit, case_labels[i]);
+        }
+      }
+      // Same thresholds as LLVM: a bit test must replace enough compares.
+      const bool use_bit_tests = (tests.size() == 1 && num_cases >= 3) ||
+                                 (tests.size() == 2 && num_cases >= 5) ||
+                                 (tests.size() == 3 && num_cases >= 6);
+      if (use_bit_tests &&
+          derived()->switch_emit_bit_test(default_label,
+                                          std::span{tests.data(), tests.size()},
+                                          cmp_reg,
+                                          tmp_reg,
+                                          base,
+                                          cases[end - 1].first,
+                                          width_is_32)) {
+        return;
+      }
+    }
+
     if (num_cases <= 4) {
       // if there are four or less cases we just compare the values
       // against each of them
@@ -4148,19 +4538,11 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_switch(
 
   build_range(0, case_labels.size(), build_range);
 
-  // write out the labels
-  this->label_place(default_label);
-  // TODO(ts): factor into arch-code?
-  derived()->generate_branch_to_block(
-      Derived::Jump::jmp,
-      this->adaptor->block_lookup_idx(switch_inst->getDefaultDest()),
-      false,
-      false);
-
-  for (auto i = 0u; i < cases.size(); ++i) {
-    this->label_place(case_labels[i]);
+  // write out the labels for targets with PHI nodes
+  for (const auto &[target, label] : phi_targets) {
+    this->label_place(label);
     derived()->generate_branch_to_block(
-        Derived::Jump::jmp, cases[i].second, false, false);
+        Derived::Jump::jmp, target, false, false);
   }
 
   this->end_branch_region();
@@ -5119,15 +5501,14 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_is_fpclass(
 template <typename Adaptor, typename Derived, typename Config>
 bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_overflow_intrin(
     const llvm::IntrinsicInst *inst, OverflowOp op) noexcept {
-  ValueRef lhs = this->val_ref(inst->getOperand(0));
-  ValueRef rhs = this->val_ref(inst->getOperand(1));
-  ValueRef res = this->result_ref(inst);
-
   auto *ty = inst->getOperand(0)->getType();
   assert(ty->isIntegerTy());
   const auto width = ty->getIntegerBitWidth();
 
   if (width == 128) {
+    ValueRef lhs = this->val_ref(inst->getOperand(0));
+    ValueRef rhs = this->val_ref(inst->getOperand(1));
+    ValueRef res = this->result_ref(inst);
     if (!derived()->handle_overflow_intrin_128(op,
                                                lhs.part(0),
                                                lhs.part(1),
@@ -5182,7 +5563,48 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_overflow_intrin(
   };
 
   EncodeFnTy encode_fn = encode_fns[static_cast<u32>(op)][width_idx];
-  (derived()->*encode_fn)(lhs.part(0), rhs.part(0), res.part(0), res.part(1));
+
+  FlagBranch fb = find_flag_branch(inst, 1);
+  if (!fb.br) {
+    ValueRef lhs = this->val_ref(inst->getOperand(0));
+    ValueRef rhs = this->val_ref(inst->getOperand(1));
+    ValueRef res = this->result_ref(inst);
+    (derived()->*encode_fn)(lhs.part(0), rhs.part(0), res.part(0), res.part(1));
+    return true;
+  }
+
+  // The overflow flag is only used by a conditional branch. Additions and
+  // subtractions branch on the CPU flags, other operations on the register
+  // holding the flag.
+  fuse_flag_branch(inst, fb);
+  bool use_flags = width >= 32 && op != OverflowOp::umul &&
+                   op != OverflowOp::smul;
+  ValuePartRef val{this, Config::GP_BANK};
+  ValuePartRef of{this, Config::GP_BANK};
+  std::optional<typename Derived::Jump> jump;
+  {
+    auto [lhs_vr, lhs] = this->val_ref_single(inst->getOperand(0));
+    auto [rhs_vr, rhs] = this->val_ref_single(inst->getOperand(1));
+    if (use_flags) {
+      jump = derived()->generate_overflow_flags(
+          op, width == 64, std::move(lhs), std::move(rhs), val);
+    } else {
+      (derived()->*encode_fn)(
+          std::move(lhs), std::move(rhs), std::move(val), std::move(of));
+    }
+  }
+
+  if (fb.val) {
+    this->result_ref(fb.val).part(0).set_value(std::move(val));
+  }
+  val.reset();
+
+  if (!use_flags) {
+    jump = derived()->generate_bool_test(of.cur_reg());
+  }
+  auto true_block = this->adaptor->block_lookup_idx(fb.br->getSuccessor(0));
+  auto false_block = this->adaptor->block_lookup_idx(fb.br->getSuccessor(1));
+  derived()->generate_conditional_branch(*jump, true_block, false_block);
   return true;
 }
 
@@ -5250,6 +5672,64 @@ bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_to_elf(
   return true;
 }
 
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_to_elf(
+    llvm::Module &mod,
+    std::function<bool(std::span<const uint8_t>)> write) noexcept {
+  if (this->adaptor->mod) {
+    derived()->reset();
+  }
+  if (!compile(mod)) {
+    return false;
+  }
+
+  llvm::TimeTraceScope time_scope("TPDE_EmitObj");
+  return this->assembler.write_object_file(write);
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_to_shared(
+    llvm::Module &mod,
+    const LinkOptions &options,
+    std::function<bool(std::span<const uint8_t>)> write) noexcept {
+  if (this->adaptor->mod) {
+    derived()->reset();
+  }
+  if (!compile(mod)) {
+    return false;
+  }
+
+  llvm::TimeTraceScope time_scope("TPDE_Link");
+  tpde::ElfLinker::Options link_options{
+      .soname = options.soname,
+      .needed = options.needed,
+  };
+  return tpde::ElfLinker::link_shared(this->assembler, link_options, write);
+}
+
+template <typename Adaptor, typename Derived, typename Config>
+bool LLVMCompilerBase<Adaptor, Derived, Config>::compile_to_executable(
+    llvm::Module &mod,
+    const LinkOptions &options,
+    std::function<bool(std::span<const uint8_t>)> write) noexcept {
+  if (this->adaptor->mod) {
+    derived()->reset();
+  }
+  if (!compile(mod)) {
+    return false;
+  }
+
+  llvm::TimeTraceScope time_scope("TPDE_Link");
+  tpde::ElfLinker::Options link_options{
+      .soname = options.soname,
+      .needed = options.needed,
+      .entry = options.entry,
+      .interp = options.interp,
+  };
+  return tpde::ElfLinker::link_executable(
+      this->assembler, link_options, write);
+}
+
 template <typename Adaptor, typename Derived, typename Config>
 JITMapper LLVMCompilerBase<Adaptor, Derived, Config>::compile_and_map(
     llvm::Module &mod,
@@ -5261,7 +5741,18 @@ JITMapper LLVMCompilerBase<Adaptor, Derived, Config>::compile_and_map(
     return JITMapper{nullptr};
   }
 
+  // Functions using the private calling convention cannot be called through a
+  // pointer from outside, so lookup_global must not return them.
+  for (const llvm::Function &fn : mod) {
+    if (this->adaptor->func_has_private_cc(&fn)) {
+      global_syms.erase(&fn);
+    }
+  }
+
   auto res = std::make_unique<JITMapperImpl>(std::move(global_syms));
+  res->set_perf_map(perf_map);
+  res->set_jitdump(jitdump);
+  res->set_gdb_jit(gdb_jit);
   if (!res->map(this->assembler, resolver)) {
     return JITMapper{nullptr};
   }
@@ -50,7 +50,14 @@ struct LLVMCompilerArm64 : tpde::a64::CompilerA64<LLVMAdaptor,
 
   std::unique_ptr<LLVMAdaptor> adaptor;
 
-  std::variant<std::monostate, tpde::a64::CCAssignerAAPCS> cc_assigners;
+  std::variant<std::monostate,
+               tpde::a64::CCAssignerAAPCS,
+               tpde::a64::CCAssignerPreserveMost,
+               tpde::a64::CCAssignerPreserveAll,
+               tpde::a64::CCAssignerPrivate>
+      cc_assigners;
+  /// Assigner for the current function if it uses the private convention.
+  tpde::a64::CCAssignerPrivate private_cc_assigner;
 
   static constexpr std::array<AsmReg, 2> LANDING_PAD_RES_REGS = {AsmReg::R0,
                                                                  AsmReg::R1};
@@ -82,6 +89,13 @@ struct LLVMCompilerArm64 : tpde::a64::CompilerA64<LLVMAdaptor,
   void load_address_of_var_reference(AsmReg dst,
                                      tpde::AssignmentPartRef ap) noexcept;
 
+  tpde::CCAssigner *cur_cc_assigner() noexcept {
+    if (this->adaptor->cur_has_private_cc()) {
+      return &private_cc_assigner;
+    }
+    return Base::cur_cc_assigner();
+  }
+
   std::optional<CallBuilder>
       create_call_builder(const llvm::CallBase * = nullptr) noexcept;
 
@@ -101,6 +115,16 @@ struct LLVMCompilerArm64 : tpde::a64::CompilerA64<LLVMAdaptor,
   bool compile_inline_asm(const llvm::CallBase *) noexcept;
   bool compile_icmp(const llvm::Instruction *, const ValInfo &, u64) noexcept;
   void compile_i32_cmp_zero(AsmReg reg, llvm::CmpInst::Predicate p) noexcept;
+  /// Compute an overflowing addition or subtraction into res, setting the
+  /// flags; returns the condition that indicates an overflow.
+  Jump generate_overflow_flags(OverflowOp op,
+                               bool is_64,
+                               ValuePartRef &&lhs,
+                               ValuePartRef &&rhs,
+                               ValuePartRef &res) noexcept;
+  /// Test the boolean in reg; returns the condition that indicates true. The
+  /// register must stay allocated until the branch is emitted.
+  Jump generate_bool_test(AsmReg reg) noexcept;
 
   GenericValuePart create_addr_for_alloca(tpde::AssignmentPartRef ap) noexcept;
 
@@ -120,6 +144,14 @@ struct LLVMCompilerArm64 : tpde::a64::CompilerA64<LLVMAdaptor,
                               u64 low_bound,
                               u64 high_bound,
                               bool width_is_32) noexcept;
+  bool switch_emit_bit_test(
+      tpde::Label default_label,
+      std::span<const std::pair<u64, tpde::Label>> tests,
+      AsmReg cmp_reg,
+      AsmReg tmp_reg,
+      u64 base,
+      u64 high_bound,
+      bool width_is_32) noexcept;
   void switch_emit_binary_step(tpde::Label case_label,
                                tpde::Label gt_label,
                                AsmReg cmp_reg,
@@ -183,6 +215,12 @@ std::optional<LLVMCompilerArm64::CallBuilder>
   llvm::CallingConv::ID cc = llvm::CallingConv::C;
   if (cb) {
     cc = cb->getCallingConv();
+    const llvm::Function *callee = cb->getCalledFunction();
+    if (callee && this->adaptor->func_has_private_cc(callee)) {
+      cc_assigners = tpde::a64::CCAssignerPrivate();
+      return CallBuilder{
+          *this, std::get<tpde::a64::CCAssignerPrivate>(cc_assigners)};
+    }
   }
   switch (cc) {
   case llvm::CallingConv::C:
@@ -191,6 +229,14 @@ std::optional<LLVMCompilerArm64::CallBuilder>
     cc_assigners = tpde::a64::CCAssignerAAPCS();
     return CallBuilder{*this,
                        std::get<tpde::a64::CCAssignerAAPCS>(cc_assigners)};
+  case llvm::CallingConv::PreserveMost:
+    cc_assigners = tpde::a64::CCAssignerPreserveMost();
+    return CallBuilder{
+        *this, std::get<tpde::a64::CCAssignerPreserveMost>(cc_assigners)};
+  case llvm::CallingConv::PreserveAll:
+    cc_assigners = tpde::a64::CCAssignerPreserveAll();
+    return CallBuilder{
+        *this, std::get<tpde::a64::CCAssignerPreserveAll>(cc_assigners)};
   default: return std::nullopt;
   }
 }
@@ -562,8 +608,61 @@ void LLVMCompilerArm64::compile_i32_cmp_zero(
   ASM(CSETw, reg, cond);
 }
 
-LLVMCompilerArm64::GenericValuePart LLVMCompilerArm64::create_addr_for_alloca(
-    tpde::AssignmentPartRef ap) noexcept {
+LLVMCompilerArm64::Jump
+    LLVMCompilerArm64::generate_overflow_flags(OverflowOp op,
+                                               bool is_64,
+                                               ValuePartRef &&lhs,
+                                               ValuePartRef &&rhs,
+                                               ValuePartRef &res) noexcept {
+  bool is_add = op == OverflowOp::uadd || op == OverflowOp::sadd;
+  bool is_signed = op == OverflowOp::sadd || op == OverflowOp::ssub;
+  assert(is_add || op == OverflowOp::usub || op == OverflowOp::ssub);
+
+  AsmReg lhs_reg = lhs.load_to_reg();
+  AsmReg res_reg = res.alloc_try_reuse(lhs);
+  bool done = false;
+  if (rhs.is_const() && !rhs.has_reg()) {
+    u64 imm = rhs.const_data()[0];
+    if (is_add) {
+      done = is_64 ? ASMIF(ADDSxi, res_reg, lhs_reg, imm)
+                   : ASMIF(ADDSwi, res_reg, lhs_reg, imm);
+    } else {
+      done = is_64 ? ASMIF(SUBSxi, res_reg, lhs_reg, imm)
+                   : ASMIF(SUBSwi, res_reg, lhs_reg, imm);
+    }
+  }
+  if (!done) {
+    AsmReg rhs_reg = rhs.has_reg() ? rhs.cur_reg() : rhs.load_to_reg();
+    if (is_add) {
+      if (is_64) {
+        ASM(ADDSx, res_reg, lhs_reg, rhs_reg);
+      } else {
+        ASM(ADDSw, res_reg, lhs_reg, rhs_reg);
+      }
+    } else {
+      if (is_64) {
+        ASM(SUBSx, res_reg, lhs_reg, rhs_reg);
+      } else {
+        ASM(SUBSw, res_reg, lhs_reg, rhs_reg);
+      }
+    }
+  }
+
+  // Unsigned subtraction overflows if there is a borrow, i.e. carry is clear.
+  if (is_signed) {
+    return Jump::Jvs;
+  }
+  return is_add ? Jump::Jcs : Jump::Jcc;
+}
+
+LLVMCompilerArm64::Jump
+    LLVMCompilerArm64::generate_bool_test(AsmReg reg) noexcept {
+  return Jump(Jump::Tbnz, reg, u8(0));
+}
+
+LLVMCompilerArm64::GenericValuePart
+    LLVMCompilerArm64::create_addr_for_alloca(
+        tpde::AssignmentPartRef ap) noexcept {
   return GenericValuePart::Expr{AsmReg::R29, ap.variable_stack_off()};
 }
 
@@ -644,6 +743,44 @@ bool LLVMCompilerArm64::switch_emit_jump_table(tpde::Label default_label,
   return false;
 }
 
+bool LLVMCompilerArm64::switch_emit_bit_test(
+    tpde::Label default_label,
+    std::span<const std::pair<u64, tpde::Label>> tests,
+    AsmReg cmp_reg,
+    AsmReg tmp_reg,
+    u64 base,
+    u64 high_bound,
+    bool width_is_32) noexcept {
+  // NB: we must not evict any registers here.
+  if (base != 0) {
+    switch_emit_cmp(cmp_reg, tmp_reg, base, width_is_32);
+    generate_raw_jump(Jump::Jlo, default_label);
+  }
+  switch_emit_cmp(cmp_reg, tmp_reg, high_bound, width_is_32);
+  generate_raw_jump(Jump::Jhi, default_label);
+
+  // lslv only uses the low six bits of the shift amount, so the upper bits of
+  // cmp_reg don't matter.
+  if (base != 0 && !ASMIF(SUBxi, cmp_reg, cmp_reg, base)) {
+    materialize_constant(base, CompilerConfig::GP_BANK, 8, tmp_reg);
+    ASM(SUBx, cmp_reg, cmp_reg, tmp_reg);
+  }
+  ASM(MOVZx, tmp_reg, 1);
+  ASM(LSLVx, tmp_reg, tmp_reg, cmp_reg);
+
+  // cmp_reg is no longer needed and can hold masks that are not encodable as
+  // logical immediate.
+  for (const auto &[mask, label] : tests) {
+    if (!ASMIF(TSTxi, tmp_reg, mask)) {
+      materialize_constant(mask, CompilerConfig::GP_BANK, 8, cmp_reg);
+      ASM(TSTx, tmp_reg, cmp_reg);
+    }
+    generate_raw_jump(Jump::Jne, label);
+  }
+  generate_raw_jump(Jump::jmp, default_label);
+  return true;
+}
+
 void LLVMCompilerArm64::switch_emit_binary_step(
     const tpde::Label case_label,
     const tpde::Label gt_label,
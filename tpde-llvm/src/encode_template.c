@@ -664,58 +664,54 @@ void TARGET_V1 atomic_store_u16_seqcst(u16* ptr, u16 v) { __atomic_store_n(ptr,
 void TARGET_V1 atomic_store_u32_seqcst(u32* ptr, u32 v) { __atomic_store_n(ptr, v, __ATOMIC_SEQ_CST); }
 void TARGET_V1 atomic_store_u64_seqcst(u64* ptr, u64 v) { __atomic_store_n(ptr, v, __ATOMIC_SEQ_CST); }
 
-u32 TARGET_V1 atomic_xchg_u8_seqcst(u8 *p, u8 v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_add_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_sub_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_and_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_and(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_nand_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_nand(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_or_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_xor_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_xor(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_min_i8_seqcst(i8 *p, i8 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_max_i8_seqcst(i8 *p, i8 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_min_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_max_u8_seqcst(u8 *p, u8 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_xchg_u16_seqcst(u16 *p, u16 v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_add_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_sub_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_and_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_and(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_nand_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_nand(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_or_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_xor_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_xor(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_min_i16_seqcst(i16 *p, i16 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_max_i16_seqcst(i16 *p, i16 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_min_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_max_u16_seqcst(u16 *p, u16 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_xchg_u32_seqcst(u32 *p, u32 v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_add_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_sub_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_and_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_and(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_nand_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_nand(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_or_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_xor_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_xor(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_min_i32_seqcst(i32 *p, i32 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_max_i32_seqcst(i32 *p, i32 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_min_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u32 TARGET_V1 atomic_max_u32_seqcst(u32 *p, u32 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_xchg_u64_seqcst(u64 *p, u64 v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_add_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_sub_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_and_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_and(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_nand_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_nand(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_or_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_or(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_xor_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_xor(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_min_i64_seqcst(i64 *p, i64 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_max_i64_seqcst(i64 *p, i64 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_min_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-u64 TARGET_V1 atomic_max_u64_seqcst(u64 *p, u64 v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-float TARGET_V1 atomic_add_f32_seqcst(float *p, float v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
-float TARGET_V1 atomic_sub_f32_seqcst(float *p, float v) { return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST); }
-float TARGET_V1 atomic_min_f32_seqcst(float *p, float v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-float TARGET_V1 atomic_max_f32_seqcst(float *p, float v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
-double TARGET_V1 atomic_add_f64_seqcst(double *p, double v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
-double TARGET_V1 atomic_sub_f64_seqcst(double *p, double v) { return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST); }
-double TARGET_V1 atomic_min_f64_seqcst(double *p, double v) { return __atomic_fetch_min(p, v, __ATOMIC_SEQ_CST); }
-double TARGET_V1 atomic_max_f64_seqcst(double *p, double v) { return __atomic_fetch_max(p, v, __ATOMIC_SEQ_CST); }
+#define RMW(rty, op, fn, name, ty, ord, ORD) \
+  rty TARGET_V1 atomic_##op##_##name##_##ord(ty *p, ty v) { return fn(p, v, ORD); }
+// Variants for unused results, which avoid cmpxchg loops on x86-64.
+#define RMW_NORET(op, name, ty, ord, ORD) \
+  void TARGET_V1 atomic_##op##_##name##_noret_##ord(ty *p, ty v) { (void)__atomic_fetch_##op(p, v, ORD); }
+#define RMW_INT(rty, bits, ord, ORD) \
+  RMW(rty, xchg, __atomic_exchange_n, u##bits, u##bits, ord, ORD) \
+  RMW(rty, add, __atomic_fetch_add, u##bits, u##bits, ord, ORD) \
+  RMW(rty, sub, __atomic_fetch_sub, u##bits, u##bits, ord, ORD) \
+  RMW(rty, and, __atomic_fetch_and, u##bits, u##bits, ord, ORD) \
+  RMW(rty, nand, __atomic_fetch_nand, u##bits, u##bits, ord, ORD) \
+  RMW(rty, or, __atomic_fetch_or, u##bits, u##bits, ord, ORD) \
+  RMW(rty, xor, __atomic_fetch_xor, u##bits, u##bits, ord, ORD) \
+  RMW(rty, min, __atomic_fetch_min, i##bits, i##bits, ord, ORD) \
+  RMW(rty, max, __atomic_fetch_max, i##bits, i##bits, ord, ORD) \
+  RMW(rty, min, __atomic_fetch_min, u##bits, u##bits, ord, ORD) \
+  RMW(rty, max, __atomic_fetch_max, u##bits, u##bits, ord, ORD) \
+  RMW_NORET(add, u##bits, u##bits, ord, ORD) \
+  RMW_NORET(sub, u##bits, u##bits, ord, ORD) \
+  RMW_NORET(and, u##bits, u##bits, ord, ORD) \
+  RMW_NORET(or, u##bits, u##bits, ord, ORD) \
+  RMW_NORET(xor, u##bits, u##bits, ord, ORD)
+// Floating-point exchange is an integer exchange, no cmpxchg loop.
+#define RMW_FP(name, ty, ord, ORD) \
+  ty TARGET_V1 atomic_xchg_##name##_##ord(ty *p, ty v) { ty r; __atomic_exchange(p, &v, &r, ORD); return r; } \
+  RMW(ty, add, __atomic_fetch_add, name, ty, ord, ORD) \
+  RMW(ty, sub, __atomic_fetch_sub, name, ty, ord, ORD) \
+  RMW(ty, min, __atomic_fetch_min, name, ty, ord, ORD) \
+  RMW(ty, max, __atomic_fetch_max, name, ty, ord, ORD)
+#define RMW_ALL(ord, ORD) \
+  RMW_INT(u32, 8, ord, ORD) \
+  RMW_INT(u32, 16, ord, ORD) \
+  RMW_INT(u32, 32, ord, ORD) \
+  RMW_INT(u64, 64, ord, ORD) \
+  RMW_FP(f32, float, ord, ORD) \
+  RMW_FP(f64, double, ord, ORD)
+
+RMW_ALL(monotonic, __ATOMIC_RELAXED)
+RMW_ALL(acquire, __ATOMIC_ACQUIRE)
+RMW_ALL(release, __ATOMIC_RELEASE)
+RMW_ALL(acqrel, __ATOMIC_ACQ_REL)
+RMW_ALL(seqcst, __ATOMIC_SEQ_CST)
+
+#undef RMW_ALL
+#undef RMW_FP
+#undef RMW_INT
+#undef RMW_NORET
+#undef RMW
 
 void TARGET_V1 fence_acq(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
 void TARGET_V1 fence_rel(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
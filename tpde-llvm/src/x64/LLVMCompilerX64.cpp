@@ -52,7 +52,14 @@ struct LLVMCompilerX64 : tpde::x64::CompilerX64<LLVMAdaptor,
 
   std::unique_ptr<LLVMAdaptor> adaptor;
 
-  std::variant<std::monostate, tpde::x64::CCAssignerSysV> cc_assigners;
+  std::variant<std::monostate,
+               tpde::x64::CCAssignerSysV,
+               tpde::x64::CCAssignerPreserveMost,
+               tpde::x64::CCAssignerPreserveAll,
+               tpde::x64::CCAssignerPrivate>
+      cc_assigners;
+  /// Assigner for the current function if it uses the private convention.
+  tpde::x64::CCAssignerPrivate private_cc_assigner;
 
   static constexpr std::array<AsmReg, 2> LANDING_PAD_RES_REGS = {AsmReg::AX,
                                                                  AsmReg::DX};
@@ -84,6 +91,13 @@ struct LLVMCompilerX64 : tpde::x64::CompilerX64<LLVMAdaptor,
   void load_address_of_var_reference(AsmReg dst,
                                      tpde::AssignmentPartRef ap) noexcept;
 
+  tpde::CCAssigner *cur_cc_assigner() noexcept {
+    if (this->adaptor->cur_has_private_cc()) {
+      return &private_cc_assigner;
+    }
+    return Base::cur_cc_assigner();
+  }
+
   std::optional<CallBuilder>
       create_call_builder(const llvm::CallBase * = nullptr) noexcept;
 
@@ -93,7 +107,22 @@ struct LLVMCompilerX64 : tpde::x64::CompilerX64<LLVMAdaptor,
                                    IRBlockRef false_target) noexcept;
   bool compile_inline_asm(const llvm::CallBase *) noexcept;
   bool compile_icmp(const llvm::Instruction *, const ValInfo &, u64) noexcept;
+  static Jump icmp_jump(llvm::CmpInst::Predicate) noexcept;
+  /// Materialize the result of an integer comparison from the flags, fusing a
+  /// following conditional branch or extension.
+  void compile_icmp_result(const llvm::ICmpInst *, Jump) noexcept;
   void compile_i32_cmp_zero(AsmReg reg, llvm::CmpInst::Predicate p) noexcept;
+  /// Compute an overflowing addition or subtraction into res, setting the
+  /// flags; returns the condition that indicates an overflow.
+  Jump generate_overflow_flags(OverflowOp op,
+                               bool is_64,
+                               ValuePartRef &&lhs,
+                               ValuePartRef &&rhs,
+                               ValuePartRef &res) noexcept;
+  /// Test the boolean in reg; returns the condition that indicates true.
+  Jump generate_bool_test(AsmReg reg) noexcept;
+
+  bool try_fold_load(const llvm::LoadInst *, GenericValuePart &) noexcept;
 
   GenericValuePart create_addr_for_alloca(tpde::AssignmentPartRef ap) noexcept;
 
@@ -113,6 +142,14 @@ struct LLVMCompilerX64 : tpde::x64::CompilerX64<LLVMAdaptor,
                               u64 low_bound,
                               u64 high_bound,
                               bool width_is_32) noexcept;
+  bool switch_emit_bit_test(
+      tpde::Label default_label,
+      std::span<const std::pair<u64, tpde::Label>> tests,
+      AsmReg cmp_reg,
+      AsmReg tmp_reg,
+      u64 base,
+      u64 high_bound,
+      bool width_is_32) noexcept;
   void switch_emit_binary_step(tpde::Label case_label,
                                tpde::Label gt_label,
                                AsmReg cmp_reg,
@@ -169,7 +206,7 @@ void LLVMCompilerX64::load_address_of_var_reference(
   if (!use_local_access(global)) {
     // mov the ptr from the GOT
     ASM(MOV64rm, dst, FE_MEM(FE_IP, 0, FE_NOREG, -1));
-    reloc_text(sym, R_X86_64_GOTPCREL, text_writer.offset() - 4, -4);
+    reloc_text(sym, R_X86_64_REX_GOTPCRELX, text_writer.offset() - 4, -4);
   } else {
     // emit lea with relocation
     ASM(LEA64rm, dst, FE_MEM(FE_IP, 0, FE_NOREG, -1));
@@ -183,6 +220,12 @@ std::optional<LLVMCompilerX64::CallBuilder>
   llvm::CallingConv::ID cc = llvm::CallingConv::C;
   if (cb) {
     cc = cb->getCallingConv();
+    const llvm::Function *callee = cb->getCalledFunction();
+    if (callee && this->adaptor->func_has_private_cc(callee)) {
+      cc_assigners = tpde::x64::CCAssignerPrivate();
+      return CallBuilder{
+          *this, std::get<tpde::x64::CCAssignerPrivate>(cc_assigners)};
+    }
   }
   switch (cc) {
   case llvm::CallingConv::C:
@@ -191,6 +234,14 @@ std::optional<LLVMCompilerX64::CallBuilder>
     cc_assigners = tpde::x64::CCAssignerSysV(var_arg);
     return CallBuilder{*this,
                        std::get<tpde::x64::CCAssignerSysV>(cc_assigners)};
+  case llvm::CallingConv::PreserveMost:
+    cc_assigners = tpde::x64::CCAssignerPreserveMost(var_arg);
+    return CallBuilder{
+        *this, std::get<tpde::x64::CCAssignerPreserveMost>(cc_assigners)};
+  case llvm::CallingConv::PreserveAll:
+    cc_assigners = tpde::x64::CCAssignerPreserveAll(var_arg);
+    return CallBuilder{
+        *this, std::get<tpde::x64::CCAssignerPreserveAll>(cc_assigners)};
   default: return std::nullopt;
   }
 }
@@ -291,49 +342,8 @@ bool LLVMCompilerX64::compile_icmp(const llvm::Instruction *inst,
     int_width = cmp_ty->getIntegerBitWidth();
   }
 
-  Jump jump;
-  bool is_signed = false;
-  switch (cmp->getPredicate()) {
-    using enum llvm::CmpInst::Predicate;
-  case ICMP_EQ: jump = Jump::je; break;
-  case ICMP_NE: jump = Jump::jne; break;
-  case ICMP_UGT: jump = Jump::ja; break;
-  case ICMP_UGE: jump = Jump::jae; break;
-  case ICMP_ULT: jump = Jump::jb; break;
-  case ICMP_ULE: jump = Jump::jbe; break;
-  case ICMP_SGT:
-    jump = Jump::jg;
-    is_signed = true;
-    break;
-  case ICMP_SGE:
-    jump = Jump::jge;
-    is_signed = true;
-    break;
-  case ICMP_SLT:
-    jump = Jump::jl;
-    is_signed = true;
-    break;
-  case ICMP_SLE:
-    jump = Jump::jle;
-    is_signed = true;
-    break;
-  default: TPDE_UNREACHABLE("invalid icmp predicate");
-  }
-
-  const llvm::BranchInst *fuse_br = nullptr;
-  const llvm::Instruction *fuse_ext = nullptr;
-
-  bool single_use = cmp->hasNUses(1);
-  const llvm::Instruction *next = cmp->getNextNode();
-  if (auto *br = llvm::dyn_cast<llvm::BranchInst>(next);
-      br && br->isConditional() && br->getCondition() == cmp) {
-    fuse_br = br;
-  } else if (single_use && *cmp->user_begin() == next) {
-    if (llvm::isa<llvm::ZExtInst, llvm::SExtInst>(next) &&
-        next->getType()->getIntegerBitWidth() <= 64) {
-      fuse_ext = next;
-    }
-  }
+  Jump jump = icmp_jump(cmp->getPredicate());
+  bool is_signed = cmp->isSigned();
 
   auto lhs = this->val_ref(cmp->getOperand(0));
   auto rhs = this->val_ref(cmp->getOperand(1));
@@ -419,6 +429,45 @@ bool LLVMCompilerX64::compile_icmp(const llvm::Instruction *inst,
   lhs.reset();
   rhs.reset();
 
+  compile_icmp_result(cmp, jump);
+  return true;
+}
+
+LLVMCompilerX64::Jump
+    LLVMCompilerX64::icmp_jump(llvm::CmpInst::Predicate pred) noexcept {
+  switch (pred) {
+    using enum llvm::CmpInst::Predicate;
+  case ICMP_EQ: return Jump::je;
+  case ICMP_NE: return Jump::jne;
+  case ICMP_UGT: return Jump::ja;
+  case ICMP_UGE: return Jump::jae;
+  case ICMP_ULT: return Jump::jb;
+  case ICMP_ULE: return Jump::jbe;
+  case ICMP_SGT: return Jump::jg;
+  case ICMP_SGE: return Jump::jge;
+  case ICMP_SLT: return Jump::jl;
+  case ICMP_SLE: return Jump::jle;
+  default: TPDE_UNREACHABLE("invalid icmp predicate");
+  }
+}
+
+void LLVMCompilerX64::compile_icmp_result(const llvm::ICmpInst *cmp,
+                                          Jump jump) noexcept {
+  const llvm::BranchInst *fuse_br = nullptr;
+  const llvm::Instruction *fuse_ext = nullptr;
+
+  bool single_use = cmp->hasNUses(1);
+  const llvm::Instruction *next = cmp->getNextNode();
+  if (auto *br = llvm::dyn_cast<llvm::BranchInst>(next);
+      br && br->isConditional() && br->getCondition() == cmp) {
+    fuse_br = br;
+  } else if (single_use && *cmp->user_begin() == next) {
+    if (llvm::isa<llvm::ZExtInst, llvm::SExtInst>(next) &&
+        next->getType()->getIntegerBitWidth() <= 64) {
+      fuse_ext = next;
+    }
+  }
+
   if (fuse_br) {
     if (!single_use) {
       (void)result_ref(cmp); // ref-count for branch
@@ -441,7 +490,214 @@ bool LLVMCompilerX64::compile_icmp(const llvm::Instruction *inst,
     auto [_, res_ref] = result_ref_single(cmp);
     generate_raw_set(jump, res_ref.alloc_reg(), /*zext=*/false);
   }
+}
+
+LLVMCompilerX64::Jump
+    LLVMCompilerX64::generate_overflow_flags(OverflowOp op,
+                                             bool is_64,
+                                             ValuePartRef &&lhs,
+                                             ValuePartRef &&rhs,
+                                             ValuePartRef &res) noexcept {
+  bool is_add = op == OverflowOp::uadd || op == OverflowOp::sadd;
+  bool is_signed = op == OverflowOp::sadd || op == OverflowOp::ssub;
+  assert(is_add || op == OverflowOp::usub || op == OverflowOp::ssub);
+
+  AsmReg lhs_reg = lhs.load_to_reg();
+  std::optional<i32> rhs_imm;
+  AsmReg rhs_reg = AsmReg::make_invalid();
+  if (rhs.is_const() && !rhs.has_reg()) {
+    u64 imm = rhs.const_data()[0];
+    if (!is_64 || i64(i32(imm)) == i64(imm)) {
+      rhs_imm = i32(imm);
+    }
+  }
+  if (!rhs_imm) {
+    rhs_reg = rhs.has_reg() ? rhs.cur_reg() : rhs.load_to_reg();
+  }
+
+  AsmReg res_reg = res.alloc_try_reuse(lhs);
+  if (res_reg != lhs_reg) {
+    this->mov(res_reg, lhs_reg, is_64 ? 8 : 4);
+  }
+
+  if (rhs_imm && is_add) {
+    if (is_64) {
+      ASM(ADD64ri, res_reg, *rhs_imm);
+    } else {
+      ASM(ADD32ri, res_reg, *rhs_imm);
+    }
+  } else if (rhs_imm) {
+    if (is_64) {
+      ASM(SUB64ri, res_reg, *rhs_imm);
+    } else {
+      ASM(SUB32ri, res_reg, *rhs_imm);
+    }
+  } else if (is_add) {
+    if (is_64) {
+      ASM(ADD64rr, res_reg, rhs_reg);
+    } else {
+      ASM(ADD32rr, res_reg, rhs_reg);
+    }
+  } else {
+    if (is_64) {
+      ASM(SUB64rr, res_reg, rhs_reg);
+    } else {
+      ASM(SUB32rr, res_reg, rhs_reg);
+    }
+  }
+  return is_signed ? Jump::jo : Jump::jb;
+}
+
+LLVMCompilerX64::Jump LLVMCompilerX64::generate_bool_test(AsmReg reg) noexcept {
+  ASM(TEST8ri, reg, 1);
+  return Jump::jne;
+}
+
+bool LLVMCompilerX64::try_fold_load(const llvm::LoadInst *load,
+                                    GenericValuePart &addr) noexcept {
+  const llvm::Instruction *user = load->getNextNode();
+  llvm::Type *ty = load->getType();
+
+  if (const auto *cmp = llvm::dyn_cast<llvm::ICmpInst>(user)) {
+    unsigned width = 64;
+    if (ty->isIntegerTy()) {
+      width = ty->getIntegerBitWidth();
+    } else if (!ty->isPointerTy()) {
+      return false;
+    }
+    if (width != 8 && width != 16 && width != 32 && width != 64) {
+      return false;
+    }
+
+    // Compare the memory operand with the other operand, swapping the
+    // condition if the load is the right-hand side.
+    Jump jump = icmp_jump(cmp->getPredicate());
+    const llvm::Value *other = cmp->getOperand(1);
+    if (other == load) {
+      other = cmp->getOperand(0);
+      jump = swap_jump(jump);
+    }
 
+    auto [other_vr, other_ref] = this->val_ref_single(other);
+    if (other_ref.is_const()) {
+      u64 imm = other_ref.const_data()[0];
+      if (width == 64 && i64(i32(imm)) != i64(imm)) {
+        other_ref.load_to_reg();
+      }
+    }
+
+    FeMem mem = gval_as_mem(addr);
+    if (other_ref.is_const() && !other_ref.has_reg()) {
+      u64 imm = other_ref.const_data()[0];
+      switch (width) {
+      case 8: ASM(CMP8mi, mem, i8(imm)); break;
+      case 16: ASM(CMP16mi, mem, i16(imm)); break;
+      case 32: ASM(CMP32mi, mem, i32(imm)); break;
+      case 64: ASM(CMP64mi, mem, i32(imm)); break;
+      default: TPDE_UNREACHABLE("invalid icmp width");
+      }
+    } else {
+      AsmReg reg =
+          other_ref.has_reg() ? other_ref.cur_reg() : other_ref.load_to_reg();
+      switch (width) {
+      case 8: ASM(CMP8mr, mem, reg); break;
+      case 16: ASM(CMP16mr, mem, reg); break;
+      case 32: ASM(CMP32mr, mem, reg); break;
+      case 64: ASM(CMP64mr, mem, reg); break;
+      default: TPDE_UNREACHABLE("invalid icmp width");
+      }
+    }
+    other_ref.reset();
+    addr.reset();
+
+    compile_icmp_result(cmp, jump);
+    return true;
+  }
+
+  const auto *bin = llvm::dyn_cast<llvm::BinaryOperator>(user);
+  if (!bin) {
+    return false;
+  }
+  const llvm::Value *other = bin->getOperand(0);
+  if (other == load) {
+    if (!bin->isCommutative()) {
+      return false;
+    }
+    other = bin->getOperand(1);
+  }
+
+  using EncodeGP = unsigned (*)(u8 *, int, FeRegGP, FeMem);
+  using EncodeXMM = unsigned (*)(u8 *, int, FeRegXMM, FeMem);
+  EncodeGP enc_gp = nullptr;
+  EncodeXMM enc_xmm = nullptr;
+  if (ty->isIntegerTy(32) || ty->isIntegerTy(64)) {
+    bool is64 = ty->isIntegerTy(64);
+    switch (bin->getOpcode()) {
+    case llvm::Instruction::Add:
+      enc_gp = is64 ? fe64_ADD64rm : fe64_ADD32rm;
+      break;
+    case llvm::Instruction::Sub:
+      enc_gp = is64 ? fe64_SUB64rm : fe64_SUB32rm;
+      break;
+    case llvm::Instruction::Mul:
+      enc_gp = is64 ? fe64_IMUL64rm : fe64_IMUL32rm;
+      break;
+    case llvm::Instruction::And:
+      enc_gp = is64 ? fe64_AND64rm : fe64_AND32rm;
+      break;
+    case llvm::Instruction::Or:
+      enc_gp = is64 ? fe64_OR64rm : fe64_OR32rm;
+      break;
+    case llvm::Instruction::Xor:
+      enc_gp = is64 ? fe64_XOR64rm : fe64_XOR32rm;
+      break;
+    default: return false;
+    }
+  } else if (ty->isFloatTy() || ty->isDoubleTy()) {
+    bool is_double = ty->isDoubleTy();
+    switch (bin->getOpcode()) {
+    case llvm::Instruction::FAdd:
+      enc_xmm = is_double ? fe64_SSE_ADDSDrm : fe64_SSE_ADDSSrm;
+      break;
+    case llvm::Instruction::FSub:
+      enc_xmm = is_double ? fe64_SSE_SUBSDrm : fe64_SSE_SUBSSrm;
+      break;
+    case llvm::Instruction::FMul:
+      enc_xmm = is_double ? fe64_SSE_MULSDrm : fe64_SSE_MULSSrm;
+      break;
+    case llvm::Instruction::FDiv:
+      enc_xmm = is_double ? fe64_SSE_DIVSDrm : fe64_SSE_DIVSSrm;
+      break;
+    default: return false;
+    }
+  } else {
+    return false;
+  }
+
+  if (enc_gp) {
+    // If the other operand is also used in the address, its register is
+    // locked and can't be reused for the result.
+    const llvm::Value *ptr = load->getPointerOperand();
+    while (const auto *gep = llvm::dyn_cast<llvm::GetElementPtrInst>(ptr)) {
+      if (llvm::is_contained(gep->operands(), other)) {
+        return false;
+      }
+      ptr = gep->getPointerOperand();
+    }
+  }
+
+  auto [other_vr, other_ref] = this->val_ref_single(other);
+  ValuePartRef tmp = std::move(other_ref).into_temporary();
+  FeMem mem = gval_as_mem(addr);
+  if (enc_gp) {
+    this->asm_helper(enc_gp).encode(16, 0, tmp.cur_reg(), mem);
+  } else {
+    this->asm_helper(enc_xmm).encode(16, 0, tmp.cur_reg(), mem);
+  }
+  addr.reset();
+
+  auto [res_vr, res_ref] = this->result_ref_single(bin);
+  res_ref.set_value(std::move(tmp));
   return true;
 }
 
@@ -552,6 +808,48 @@ bool LLVMCompilerX64::switch_emit_jump_table(tpde::Label default_label,
   return true;
 }
 
+bool LLVMCompilerX64::switch_emit_bit_test(
+    tpde::Label default_label,
+    std::span<const std::pair<u64, tpde::Label>> tests,
+    AsmReg cmp_reg,
+    AsmReg tmp_reg,
+    u64 base,
+    u64 high_bound,
+    bool width_is_32) noexcept {
+  // NB: we must not evict any registers here.
+  if (base != 0) {
+    switch_emit_cmp(cmp_reg, tmp_reg, base, width_is_32);
+    generate_raw_jump(Jump::jb, default_label);
+  }
+  switch_emit_cmp(cmp_reg, tmp_reg, high_bound, width_is_32);
+  generate_raw_jump(Jump::ja, default_label);
+
+  // bt only uses the low six bits of the bit offset, so the upper bits of
+  // cmp_reg don't matter.
+  if (base != 0) {
+    if (width_is_32) {
+      ASM(SUB32ri, cmp_reg, base);
+    } else if ((i64)((i32)base) == (i64)base) {
+      ASM(SUB64ri, cmp_reg, base);
+    } else {
+      ValuePartRef const_ref{this, &base, 8, CompilerConfig::GP_BANK};
+      ASM(SUB64rr, cmp_reg, const_ref.reload_into_specific_fixed(tmp_reg));
+    }
+  }
+
+  for (const auto &[mask, label] : tests) {
+    if (mask <= 0xffff'ffff) {
+      ASM(MOV32ri, tmp_reg, mask);
+    } else {
+      ASM(MOV64ri, tmp_reg, mask);
+    }
+    ASM(BT64rr, tmp_reg, cmp_reg);
+    generate_raw_jump(Jump::jb, label);
+  }
+  generate_raw_jump(Jump::jmp, default_label);
+  return true;
+}
+
 void LLVMCompilerX64::switch_emit_binary_step(const tpde::Label case_label,
                                               const tpde::Label gt_label,
                                               const AsmReg cmp_reg,
@@ -0,0 +1,45 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 --exe --needed=libc.so.6 < %s | llvm-readelf -hld --dyn-syms - | FileCheck %s -check-prefixes=CHECK,X64
+; RUN: tpde-llc --target=aarch64 --exe --needed=libc.so.6 < %s | llvm-readelf -hld --dyn-syms - | FileCheck %s -check-prefixes=CHECK,ARM64
+; RUN: tpde-llc --target=x86_64 --exe --dynamic-linker=/custom/ld.so < %s | llvm-readelf -l - | FileCheck %s -check-prefixes=INTERP
+
+; CHECK: Type: DYN (Shared object file)
+; CHECK-NOT: Entry point address:{{ *}}0x0{{$}}
+
+; CHECK: Program Headers:
+; CHECK-NEXT: Type
+; CHECK-NEXT: PHDR
+; CHECK-NEXT: INTERP
+; X64-NEXT: [Requesting program interpreter: /lib64/ld-linux-x86-64.so.2]
+; ARM64-NEXT: [Requesting program interpreter: /lib/ld-linux-aarch64.so.1]
+; CHECK-NEXT: LOAD {{.*}} R   0x
+; CHECK-NEXT: LOAD {{.*}} R E 0x
+; CHECK-NEXT: LOAD {{.*}} RW  0x
+; CHECK-NEXT: DYNAMIC
+; CHECK-NEXT: GNU_EH_FRAME
+; CHECK-NEXT: GNU_STACK
+
+; CHECK: Dynamic section at offset
+; CHECK-DAG: (NEEDED) Shared library: [libc.so.6]
+; CHECK-DAG: (DEBUG) 0x0
+; CHECK-DAG: (FLAGS_1) NOW PIE
+
+; Nothing is exported, main is started through __libc_start_main.
+; CHECK: Symbol table '.dynsym' contains 3 entries:
+; CHECK-DAG: UND puts
+; CHECK-DAG: UND __libc_start_main
+; CHECK-NOT: {{ main$}}
+
+; INTERP: [Requesting program interpreter: /custom/ld.so]
+
+@str = private unnamed_addr constant [6 x i8] c"hello\00"
+
+declare i32 @puts(ptr)
+
+define i32 @main() {
+  %r = call i32 @puts(ptr @str)
+  ret i32 0
+}
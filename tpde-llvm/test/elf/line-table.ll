@@ -0,0 +1,59 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 -g < %s | llvm-dwarfdump --debug-line --debug-info - | FileCheck %s
+; RUN: tpde-llc --target=aarch64 -g < %s | llvm-dwarfdump --debug-line --debug-info - | FileCheck %s
+; RUN: tpde-llc --target=x86_64 < %s | llvm-readelf -S - | FileCheck %s -check-prefix=NOLINES
+; RUN: tpde-llc --target=x86_64 -g --shared < %s | llvm-dwarfdump --debug-line --debug-info - | FileCheck %s
+; RUN: tpde-llc --target=aarch64 -g --shared < %s | llvm-dwarfdump --debug-line --debug-info - | FileCheck %s
+; RUN: tpde-llc --target=x86_64 -g --shared < %s | llvm-dwarfdump --debug-aranges - | FileCheck %s -check-prefix=LINKED
+
+; CHECK: DW_TAG_compile_unit
+; CHECK-NEXT: DW_AT_producer ("TPDE")
+; CHECK-NEXT: DW_AT_name ("test.c")
+; CHECK-NEXT: DW_AT_comp_dir ("/src")
+; CHECK-NEXT: DW_AT_stmt_list (0x00000000)
+
+; CHECK: version: 5
+; CHECK: include_directories[ 0] = "/src"
+; CHECK: file_names[ 0]:
+; CHECK-NEXT: name: "test.c"
+; CHECK-NEXT: dir_index: 0
+; CHECK: file_names[ 1]:
+; CHECK-NEXT: name: "inc.h"
+; CHECK-NEXT: dir_index: 0
+
+; CHECK: Address Line Column File
+; CHECK: 0x{{[0-9a-f]+}} 3 5 0 {{.*}} is_stmt
+; CHECK: 0x{{[0-9a-f]+}} 4 7 0 {{.*}} is_stmt
+; CHECK: 0x{{[0-9a-f]+}} 10 1 1 {{.*}} is_stmt
+; CHECK: 0x{{[0-9a-f]+}} 10 1 1 {{.*}} is_stmt end_sequence
+
+; NOLINES-NOT: .debug_line
+
+; Linked text starts after the headers, so addresses are not zero.
+; LINKED: [0x{{0*[1-9a-f][0-9a-f]*}}, 0x
+
+define void @f(ptr %p, i32 %a) !dbg !5 {
+  store volatile i32 %a, ptr %p, !dbg !8
+  store volatile i32 0, ptr %p, !dbg !9
+  store volatile i32 1, ptr %p, !dbg !10
+  ret void, !dbg !10
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C11, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!1 = !DIFile(filename: "test.c", directory: "/src")
+!2 = !DIFile(filename: "inc.h", directory: "/src")
+!3 = !{i32 7, !"Dwarf Version", i32 5}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = distinct !DISubprogram(name: "f", scope: !1, file: !1, line: 2, type: !6, scopeLine: 2, spFlags: DISPFlagDefinition, unit: !0)
+!6 = !DISubroutineType(types: !7)
+!7 = !{}
+!8 = !DILocation(line: 3, column: 5, scope: !5)
+!9 = !DILocation(line: 4, column: 7, scope: !5)
+!10 = !DILocation(line: 10, column: 1, scope: !11)
+!11 = distinct !DILexicalBlockFile(scope: !5, file: !2, discriminator: 0)
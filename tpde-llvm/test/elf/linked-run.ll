@@ -0,0 +1,35 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; Run linked outputs for the host. The module defines main but does not
+; reference __libc_start_main, so the linker adds the start stub and symbol.
+
+; RUN: rm -f %t.exe %t.so
+; RUN: tpde-llc --exe --needed=libc.so.6 -o %t.exe < %s
+; RUN: chmod +x %t.exe
+; RUN: %t.exe | FileCheck %s -check-prefix=EXE
+; RUN: tpde-llc --shared --needed=libc.so.6 -o %t.so < %s
+; RUN: python3 -c "import ctypes; print(ctypes.CDLL('%t.so').twice(21))" | FileCheck %s -check-prefix=SO
+
+; EXE: twice: 42
+; SO: 42
+
+@fmt = private constant [11 x i8] c"twice: %d\0A\00", align 1
+@counter = global i32 0, align 4
+
+declare i32 @printf(ptr, ...)
+
+define i32 @twice(i32 %x) {
+  %c = load i32, ptr @counter, align 4
+  %c1 = add i32 %c, 1
+  store i32 %c1, ptr @counter, align 4
+  %r = shl i32 %x, 1
+  ret i32 %r
+}
+
+define i32 @main() {
+  %v = call i32 @twice(i32 21)
+  %p = call i32 (ptr, ...) @printf(ptr @fmt, i32 %v)
+  ret i32 0
+}
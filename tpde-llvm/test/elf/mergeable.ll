@@ -0,0 +1,53 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 < %s | llvm-readelf -Ss - | FileCheck %s
+; RUN: tpde-llc --target=aarch64 < %s | llvm-readelf -Ss - | FileCheck %s
+
+; Identical strings and constants are stored only once.
+; CHECK: Section Headers:
+; CHECK-DAG: [{{ *}}[[STR_IDX:[0-9]+]]] .rodata.str1.1 PROGBITS {{[0-9a-f]+}} {{[0-9a-f]+}} 00000c 01 AMS 0 0 1
+; CHECK-DAG: [{{ *}}[[CST8_IDX:[0-9]+]]] .rodata.cst8 PROGBITS {{[0-9a-f]+}} {{[0-9a-f]+}} 000008 08 AM 0 0 8
+; CHECK-DAG: [{{ *}}[[CST16_IDX:[0-9]+]]] .rodata.cst16 PROGBITS {{[0-9a-f]+}} {{[0-9a-f]+}} 000010 10 AM 0 0 16
+
+; CHECK: Symbol table '.symtab'
+; CHECK-DAG: 6 OBJECT  LOCAL  DEFAULT [[STR_IDX]]  .str.a
+; CHECK-DAG: 6 OBJECT  LOCAL  DEFAULT [[STR_IDX]]  .str.b
+; CHECK-DAG: 6 OBJECT  LOCAL  DEFAULT [[STR_IDX]]  .str.c
+; CHECK-DAG: 8 OBJECT  LOCAL  DEFAULT [[CST8_IDX]] .dbl.a
+; CHECK-DAG: 8 OBJECT  LOCAL  DEFAULT [[CST8_IDX]] .dbl.b
+
+@.str.a = private unnamed_addr constant [6 x i8] c"hello\00", align 1
+@.str.b = private unnamed_addr constant [6 x i8] c"hello\00", align 1
+@.str.c = private unnamed_addr constant [6 x i8] c"world\00", align 1
+@.dbl.a = private unnamed_addr constant double 1.5, align 8
+@.dbl.b = private unnamed_addr constant double 1.5, align 8
+
+define ptr @str_a() {
+  ret ptr @.str.a
+}
+
+define ptr @str_b() {
+  ret ptr @.str.b
+}
+
+define ptr @str_c() {
+  ret ptr @.str.c
+}
+
+define ptr @dbl_a() {
+  ret ptr @.dbl.a
+}
+
+define ptr @dbl_b() {
+  ret ptr @.dbl.b
+}
+
+define <4 x float> @vec_a() {
+  ret <4 x float> <float 1.0, float 2.0, float 3.0, float 4.0>
+}
+
+define <4 x float> @vec_b() {
+  ret <4 x float> <float 1.0, float 2.0, float 3.0, float 4.0>
+}
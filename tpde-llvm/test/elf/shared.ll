@@ -0,0 +1,77 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 --shared --soname=libtest.so --needed=libc.so.6 < %s | llvm-readelf -hld - | FileCheck %s
+; RUN: tpde-llc --target=aarch64 --shared --soname=libtest.so --needed=libc.so.6 < %s | llvm-readelf -hld - | FileCheck %s
+; RUN: tpde-llc --target=x86_64 --shared < %s | llvm-readelf -r --dyn-syms - | FileCheck %s -check-prefixes=SYMS,X64
+; RUN: tpde-llc --target=aarch64 --shared < %s | llvm-readelf -r --dyn-syms - | FileCheck %s -check-prefixes=SYMS,ARM64
+
+; CHECK: Type: DYN (Shared object file)
+; CHECK: Entry point address: 0x0
+
+; CHECK: Program Headers:
+; CHECK: LOAD {{.*}} R   0x
+; CHECK: LOAD {{.*}} R E 0x
+; CHECK: LOAD {{.*}} RW  0x
+; CHECK: DYNAMIC
+; CHECK: GNU_EH_FRAME
+; CHECK: GNU_STACK
+
+; CHECK: Dynamic section at offset
+; CHECK-DAG: (NEEDED) Shared library: [libc.so.6]
+; CHECK-DAG: (SONAME) Library soname: [libtest.so]
+; CHECK-DAG: (GNU_HASH)
+; CHECK-DAG: (RELACOUNT)
+; CHECK-DAG: (INIT_ARRAY)
+; CHECK-DAG: (FLAGS) BIND_NOW
+
+; Relocations: RELATIVE for the pointer to exported_var and the constructor,
+; GLOB_DAT for the GOT entries of ext_fn and ext_var.
+; X64: R_X86_64_RELATIVE
+; X64-DAG: R_X86_64_GLOB_DAT {{.*}} ext_fn
+; X64-DAG: R_X86_64_GLOB_DAT {{.*}} ext_var
+; ARM64: R_AARCH64_RELATIVE
+; ARM64-DAG: R_AARCH64_GLOB_DAT {{.*}} ext_fn
+; ARM64-DAG: R_AARCH64_GLOB_DAT {{.*}} ext_var
+
+; Imports come first, followed by the exported symbols.
+; SYMS: Symbol table '.dynsym' contains 7 entries:
+; SYMS-DAG: NOTYPE  GLOBAL DEFAULT   UND ext_fn
+; SYMS-DAG: NOTYPE  GLOBAL DEFAULT   UND ext_var
+; SYMS-DAG: FUNC    GLOBAL DEFAULT   {{[0-9]+}} exported_fn
+; SYMS-DAG: FUNC    GLOBAL PROTECTED {{[0-9]+}} protected_fn
+; SYMS-DAG: OBJECT  GLOBAL DEFAULT   {{[0-9]+}} exported_var
+; SYMS-DAG: OBJECT  GLOBAL DEFAULT   {{[0-9]+}} exported_ptr
+; SYMS-NOT: hidden_fn
+; SYMS-NOT: internal_fn
+
+@llvm.global_ctors = appending global [1 x { i32, ptr, ptr }] [{ i32, ptr, ptr } { i32 65535, ptr @internal_fn, ptr null }]
+
+@ext_var = external global i32
+@exported_var = global i32 1
+@exported_ptr = global ptr @exported_var
+
+declare void @ext_fn()
+
+define internal void @internal_fn() {
+  call void @ext_fn()
+  ret void
+}
+
+define hidden void @hidden_fn() {
+  ret void
+}
+
+define void @exported_fn() {
+  call void @internal_fn()
+  call void @hidden_fn()
+  ret void
+}
+
+define protected i32 @protected_fn() {
+  %v = load i32, ptr @ext_var
+  %w = load i32, ptr @exported_var
+  %r = add i32 %v, %w
+  ret i32 %r
+}
@@ -0,0 +1,284 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+; atomicrmw without users is lowered to a plain lock-prefixed op on x86-64
+; and to an LSE atomic whose result register is not used on AArch64. The
+; result register on AArch64 is picked by the register allocator.
+
+define void @atomicrmw_add_i8_seq_cst_nouse(ptr %p, i8 %a) {
+; X64-LABEL: <atomicrmw_add_i8_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: add byte ptr [rdi], sil
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_add_i8_seq_cst_nouse>:
+; ARM64: ldaddalb w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw add ptr %p, i8 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_add_i16_seq_cst_nouse(ptr %p, i16 %a) {
+; X64-LABEL: <atomicrmw_add_i16_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: add word ptr [rdi], si
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_add_i16_seq_cst_nouse>:
+; ARM64: ldaddalh w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw add ptr %p, i16 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_add_i32_seq_cst_nouse(ptr %p, i32 %a) {
+; X64-LABEL: <atomicrmw_add_i32_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: add dword ptr [rdi], esi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_add_i32_seq_cst_nouse>:
+; ARM64: ldaddal w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw add ptr %p, i32 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_add_i64_seq_cst_nouse(ptr %p, i64 %a) {
+; X64-LABEL: <atomicrmw_add_i64_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: add qword ptr [rdi], rsi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_add_i64_seq_cst_nouse>:
+; ARM64: ldaddal x1, x{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw add ptr %p, i64 %a seq_cst
+  ret void
+}
+
+
+define void @atomicrmw_and_i8_seq_cst_nouse(ptr %p, i8 %a) {
+; X64-LABEL: <atomicrmw_and_i8_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: and byte ptr [rdi], sil
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_and_i8_seq_cst_nouse>:
+; ARM64: mvn w1, w1
+; ARM64-NEXT: ldclralb w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw and ptr %p, i8 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_and_i16_seq_cst_nouse(ptr %p, i16 %a) {
+; X64-LABEL: <atomicrmw_and_i16_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: and word ptr [rdi], si
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_and_i16_seq_cst_nouse>:
+; ARM64: mvn w1, w1
+; ARM64-NEXT: ldclralh w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw and ptr %p, i16 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_and_i32_seq_cst_nouse(ptr %p, i32 %a) {
+; X64-LABEL: <atomicrmw_and_i32_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: and dword ptr [rdi], esi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_and_i32_seq_cst_nouse>:
+; ARM64: mvn w1, w1
+; ARM64-NEXT: ldclral w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw and ptr %p, i32 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_and_i64_seq_cst_nouse(ptr %p, i64 %a) {
+; X64-LABEL: <atomicrmw_and_i64_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: and qword ptr [rdi], rsi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_and_i64_seq_cst_nouse>:
+; ARM64: mvn x1, x1
+; ARM64-NEXT: ldclral x1, x{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw and ptr %p, i64 %a seq_cst
+  ret void
+}
+
+
+define void @atomicrmw_or_i8_seq_cst_nouse(ptr %p, i8 %a) {
+; X64-LABEL: <atomicrmw_or_i8_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: or byte ptr [rdi], sil
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_or_i8_seq_cst_nouse>:
+; ARM64: ldsetalb w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw or ptr %p, i8 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_or_i16_seq_cst_nouse(ptr %p, i16 %a) {
+; X64-LABEL: <atomicrmw_or_i16_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: or word ptr [rdi], si
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_or_i16_seq_cst_nouse>:
+; ARM64: ldsetalh w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw or ptr %p, i16 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_or_i32_seq_cst_nouse(ptr %p, i32 %a) {
+; X64-LABEL: <atomicrmw_or_i32_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: or dword ptr [rdi], esi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_or_i32_seq_cst_nouse>:
+; ARM64: ldsetal w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw or ptr %p, i32 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_or_i64_seq_cst_nouse(ptr %p, i64 %a) {
+; X64-LABEL: <atomicrmw_or_i64_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: or qword ptr [rdi], rsi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_or_i64_seq_cst_nouse>:
+; ARM64: ldsetal x1, x{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw or ptr %p, i64 %a seq_cst
+  ret void
+}
+
+
+define void @atomicrmw_sub_i8_seq_cst_nouse(ptr %p, i8 %a) {
+; X64-LABEL: <atomicrmw_sub_i8_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: sub byte ptr [rdi], sil
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_sub_i8_seq_cst_nouse>:
+; ARM64: neg w1, w1
+; ARM64-NEXT: ldaddalb w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw sub ptr %p, i8 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_sub_i16_seq_cst_nouse(ptr %p, i16 %a) {
+; X64-LABEL: <atomicrmw_sub_i16_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: sub word ptr [rdi], si
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_sub_i16_seq_cst_nouse>:
+; ARM64: neg w1, w1
+; ARM64-NEXT: ldaddalh w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw sub ptr %p, i16 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_sub_i32_seq_cst_nouse(ptr %p, i32 %a) {
+; X64-LABEL: <atomicrmw_sub_i32_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: sub dword ptr [rdi], esi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_sub_i32_seq_cst_nouse>:
+; ARM64: neg w1, w1
+; ARM64-NEXT: ldaddal w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw sub ptr %p, i32 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_sub_i64_seq_cst_nouse(ptr %p, i64 %a) {
+; X64-LABEL: <atomicrmw_sub_i64_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: sub qword ptr [rdi], rsi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_sub_i64_seq_cst_nouse>:
+; ARM64: neg x1, x1
+; ARM64-NEXT: ldaddal x1, x{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw sub ptr %p, i64 %a seq_cst
+  ret void
+}
+
+
+define void @atomicrmw_xor_i8_seq_cst_nouse(ptr %p, i8 %a) {
+; X64-LABEL: <atomicrmw_xor_i8_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: xor byte ptr [rdi], sil
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_xor_i8_seq_cst_nouse>:
+; ARM64: ldeoralb w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw xor ptr %p, i8 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_xor_i16_seq_cst_nouse(ptr %p, i16 %a) {
+; X64-LABEL: <atomicrmw_xor_i16_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: xor word ptr [rdi], si
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_xor_i16_seq_cst_nouse>:
+; ARM64: ldeoralh w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw xor ptr %p, i16 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_xor_i32_seq_cst_nouse(ptr %p, i32 %a) {
+; X64-LABEL: <atomicrmw_xor_i32_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: xor dword ptr [rdi], esi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_xor_i32_seq_cst_nouse>:
+; ARM64: ldeoral w1, w{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw xor ptr %p, i32 %a seq_cst
+  ret void
+}
+
+define void @atomicrmw_xor_i64_seq_cst_nouse(ptr %p, i64 %a) {
+; X64-LABEL: <atomicrmw_xor_i64_seq_cst_nouse>:
+; X64: lock
+; X64-NEXT: xor qword ptr [rdi], rsi
+; X64-NEXT: add rsp
+;
+; ARM64-LABEL: <atomicrmw_xor_i64_seq_cst_nouse>:
+; ARM64: ldeoral x1, x{{[0-9]+}}, [x0]
+; ARM64-NEXT: ldp x29, x30
+  %r = atomicrmw xor ptr %p, i64 %a seq_cst
+  ret void
+}
+
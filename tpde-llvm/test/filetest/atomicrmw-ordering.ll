@@ -0,0 +1,64 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+define i32 @add_monotonic(ptr %p, i32 %a) {
+; X64-LABEL: <add_monotonic>:
+; X64:         lock
+; X64-NEXT:    xadd dword ptr [rdi], esi
+;
+; ARM64-LABEL: <add_monotonic>:
+; ARM64:         ldadd w1, w{{[0-9]+}}, [x0]
+  %r = atomicrmw add ptr %p, i32 %a monotonic
+  ret i32 %r
+}
+
+define i64 @add_acquire(ptr %p, i64 %a) {
+; ARM64-LABEL: <add_acquire>:
+; ARM64:         ldadda x1, x{{[0-9]+}}, [x0]
+  %r = atomicrmw add ptr %p, i64 %a acquire
+  ret i64 %r
+}
+
+define i32 @xchg_release(ptr %p, i32 %a) {
+; ARM64-LABEL: <xchg_release>:
+; ARM64:         swpl w1, w{{[0-9]+}}, [x0]
+  %r = atomicrmw xchg ptr %p, i32 %a release
+  ret i32 %r
+}
+
+define i32 @or_acq_rel(ptr %p, i32 %a) {
+; ARM64-LABEL: <or_acq_rel>:
+; ARM64:         ldsetal w1, w{{[0-9]+}}, [x0]
+  %r = atomicrmw or ptr %p, i32 %a acq_rel
+  ret i32 %r
+}
+
+; Without a use of the old value, no cmpxchg loop is needed.
+define void @and_monotonic_nouse(ptr %p, i64 %a) {
+; X64-LABEL: <and_monotonic_nouse>:
+; X64-NOT:     cmpxchg
+; X64:         lock
+; X64-NEXT:    and qword ptr [rdi], rsi
+; X64-NOT:     cmpxchg
+; X64:         ret
+  %r = atomicrmw and ptr %p, i64 %a monotonic
+  ret void
+}
+
+define double @xchg_f64(ptr %p, double %a) {
+; X64-LABEL: <xchg_f64>:
+; X64-NOT:     cmpxchg
+; X64:         xchg qword ptr [rdi]
+; X64-NOT:     cmpxchg
+; X64:         ret
+;
+; ARM64-LABEL: <xchg_f64>:
+; ARM64:         swpal x{{[0-9]+}}, x{{[0-9]+}}, [x0]
+  %r = atomicrmw xchg ptr %p, double %a seq_cst
+  ret double %r
+}
@@ -0,0 +1,84 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare void @abort()
+declare void @cold_fn()
+declare i1 @llvm.expect.i1(i1, i1)
+
+; Blocks ending in unreachable are moved after the return.
+define i32 @unreachable_last(i32 %a) {
+; X64-LABEL: <unreachable_last>:
+; X64:         ret
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 abort-0x4
+; X64-LABEL: <weights_last>:
+;
+; ARM64-LABEL: <unreachable_last>:
+; ARM64:         ret
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 abort
+; ARM64-LABEL: <weights_last>:
+entry:
+  %c = icmp eq i32 %a, 0
+  br i1 %c, label %fail, label %ok
+fail:
+  call void @abort()
+  unreachable
+ok:
+  ret i32 %a
+}
+
+; The unlikely successor is placed after the likely one.
+define i32 @weights_last(i32 %a) {
+; X64-LABEL: <weights_last>:
+; X64:         ret
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 cold_fn-0x4
+; X64:         ret
+; X64-LABEL: <expect_last>:
+;
+; ARM64-LABEL: <weights_last>:
+; ARM64:         ret
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 cold_fn
+; ARM64:         ret
+; ARM64-LABEL: <expect_last>:
+entry:
+  %c = icmp eq i32 %a, 0
+  br i1 %c, label %slow, label %fast, !prof !0
+slow:
+  call void @cold_fn()
+  ret i32 0
+fast:
+  ret i32 %a
+}
+
+define i32 @expect_last(i32 %a) {
+; X64-LABEL: <expect_last>:
+; X64:         ret
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 cold_fn-0x4
+; X64:         ret
+;
+; ARM64-LABEL: <expect_last>:
+; ARM64:         ret
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 cold_fn
+; ARM64:         ret
+entry:
+  %c = icmp eq i32 %a, 0
+  %e = call i1 @llvm.expect.i1(i1 %c, i1 false)
+  br i1 %e, label %slow, label %fast
+slow:
+  call void @cold_fn()
+  ret i32 0
+fast:
+  ret i32 %a
+}
+
+!0 = !{!"branch_weights", i32 1, i32 2000}
@@ -0,0 +1,42 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare preserve_mostcc void @fn_most()
+declare preserve_allcc void @fn_all()
+
+; %b stays in a caller-saved register across the call.
+define i64 @call_most(i64 %a, i64 %b) {
+; X64-LABEL: <call_most>:
+; X64-NOT:     mov qword ptr [rbp
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 fn_most-0x4
+; X64-NOT:     mov {{.*}}, qword ptr [rbp
+; X64:         ret
+;
+; ARM64-LABEL: <call_most>:
+; ARM64-NOT:     str x1
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 fn_most
+; ARM64-NOT:     ldr {{.*}}, [x29
+; ARM64:         ret
+  call preserve_mostcc void @fn_most()
+  %r = add i64 %a, %b
+  ret i64 %r
+}
+
+define double @call_all(double %a, double %b) {
+; X64-LABEL: <call_all>:
+; X64-NOT:     movsd qword ptr [rbp
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 fn_all-0x4
+; X64-NOT:     movsd {{.*}}, qword ptr [rbp
+; X64:         ret
+  call preserve_allcc void @fn_all()
+  %r = fadd double %a, %b
+  ret double %r
+}
@@ -0,0 +1,94 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+; Internal functions whose address is not taken use more argument and return
+; registers than the C calling convention. Calls to them are resolved without
+; relocations.
+
+define internal i64 @internal_9xi64(i64 %a, i64 %b, i64 %c, i64 %d, i64 %e, i64 %f, i64 %g, i64 %h, i64 %i) {
+; X64-LABEL: <internal_9xi64>:
+; X64-NOT:     qword ptr [rbp + 0x10]
+; X64:         r11
+; X64:         ret
+;
+; ARM64-LABEL: <internal_9xi64>:
+; ARM64-NOT:     ldr x{{[0-9]+}}, [x17
+; ARM64:         x8
+; ARM64:         ret
+  %ab = add i64 %a, %b
+  %abi = add i64 %ab, %i
+  ret i64 %abi
+}
+
+define i64 @call_internal_9xi64(i64 %a) {
+; X64-LABEL: <call_internal_9xi64>:
+; X64-NOT:     mov qword ptr [rsp
+; X64:         r11,
+; X64:         call {{.*}} <internal_9xi64>
+; X64-NOT:      R_X86_64_PLT32
+; X64:         ret
+;
+; ARM64-LABEL: <call_internal_9xi64>:
+; ARM64-NOT:     str x{{[0-9]+}}, [sp
+; ARM64:         x8,
+; ARM64:         bl {{.*}} <internal_9xi64>
+; ARM64-NOT:      R_AARCH64_CALL26
+; ARM64:         ret
+  %r = call i64 @internal_9xi64(i64 %a, i64 %a, i64 %a, i64 %a, i64 %a, i64 %a, i64 %a, i64 %a, i64 %a)
+  ret i64 %r
+}
+
+define internal { i64, i64, i64 } @internal_ret3(i64 %a) {
+; X64-LABEL: <internal_ret3>:
+; X64:         rcx
+; X64:         ret
+;
+; ARM64-LABEL: <internal_ret3>:
+; ARM64:         x2
+; ARM64:         ret
+  %s0 = insertvalue { i64, i64, i64 } poison, i64 %a, 0
+  %s1 = insertvalue { i64, i64, i64 } %s0, i64 1, 1
+  %s2 = insertvalue { i64, i64, i64 } %s1, i64 2, 2
+  ret { i64, i64, i64 } %s2
+}
+
+define i64 @call_internal_ret3(i64 %a) {
+; X64-LABEL: <call_internal_ret3>:
+; X64:         call {{.*}} <internal_ret3>
+; X64-NOT:      R_X86_64_PLT32
+; X64:         rcx
+; X64:         ret
+;
+; ARM64-LABEL: <call_internal_ret3>:
+; ARM64:         bl {{.*}} <internal_ret3>
+; ARM64-NOT:      R_AARCH64_CALL26
+; ARM64:         x2
+; ARM64:         ret
+  %s = call { i64, i64, i64 } @internal_ret3(i64 %a)
+  %e0 = extractvalue { i64, i64, i64 } %s, 0
+  %e2 = extractvalue { i64, i64, i64 } %s, 2
+  %r = add i64 %e0, %e2
+  ret i64 %r
+}
+
+; The address escapes, so the C calling convention is used.
+define internal i64 @internal_escaped_9xi64(i64 %a, i64 %b, i64 %c, i64 %d, i64 %e, i64 %f, i64 %g, i64 %h, i64 %i) {
+; X64-LABEL: <internal_escaped_9xi64>:
+; X64:         [rbp + 0x10]
+; X64:         ret
+;
+; ARM64-LABEL: <internal_escaped_9xi64>:
+; ARM64:         ldr x{{[0-9]+}}, [x17
+; ARM64:         ret
+  %abi = add i64 %a, %i
+  ret i64 %abi
+}
+
+define ptr @escape() {
+  ret ptr @internal_escaped_9xi64
+}
@@ -0,0 +1,63 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --fold-constants --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --fold-constants --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+; Chains of instructions with constant operands fold to a single constant,
+; which is then used as immediate operand.
+define i64 @fold_chain(i64 %a) {
+; X64-LABEL: <fold_chain>:
+; X64-NOT:     imul
+; X64:         lea {{.*}}, [{{.*}} + 0x1a]
+; X64:         ret
+;
+; ARM64-LABEL: <fold_chain>:
+; ARM64-NOT:     mul
+; ARM64:         add {{x[0-9]+}}, {{x[0-9]+}}, #0x1a
+; ARM64:         ret
+  %x = add i64 5, 8
+  %y = mul i64 %x, 2
+  %r = add i64 %a, %y
+  ret i64 %r
+}
+
+define i32 @fold_cmp_select(i32 %a) {
+; X64-LABEL: <fold_cmp_select>:
+; X64-NOT:     cmp
+; X64-NOT:     cmov
+; X64:         lea {{.*}}, [{{.*}} + 0x7]
+; X64:         ret
+;
+; ARM64-LABEL: <fold_cmp_select>:
+; ARM64-NOT:     cmp
+; ARM64-NOT:     csel
+; ARM64:         add {{w[0-9]+}}, {{w[0-9]+}}, #0x7
+; ARM64:         ret
+  %c = icmp slt i32 3, 4
+  %s = select i1 %c, i32 7, i32 9
+  %z = zext i1 %c to i32
+  %t = add i32 %s, %z
+  %u = sub i32 %t, 1
+  %r = add i32 %a, %u
+  ret i32 %r
+}
+
+define double @fold_float(double %a) {
+; X64-LABEL: <fold_float>:
+; X64-NOT:     mulsd
+; X64:         addsd
+; X64:         ret
+;
+; ARM64-LABEL: <fold_float>:
+; ARM64-NOT:     fmul
+; ARM64:         fadd
+; ARM64:         ret
+  %x = fmul double 1.5, 2.0
+  %y = sitofp i32 2 to double
+  %z = fadd double %x, %y
+  %r = fadd double %a, %z
+  ret double %r
+}
@@ -1503,18 +1503,14 @@ define i32 @phi_gep_insert_after_earlier_phi() {
 ; X64-NEXT:    je <L0>
 ; X64-NEXT:    cmp ecx, 0x1
 ; X64-NEXT:    je <L1>
-; X64-NEXT:    jmp <L2>
-; X64-NEXT:  <L2>:
-; X64-NEXT:    jmp <L3>
-; X64-NEXT:  <L0>:
-; X64-NEXT:    jmp <L3>
+; X64-NEXT:    jmp <L0>
 ; X64-NEXT:  <L1>:
 ; X64-NEXT:    mov rbx, rax
-; X64-NEXT:    jmp <L4>
-; X64-NEXT:  <L3>:
+; X64-NEXT:    jmp <L2>
+; X64-NEXT:  <L0>:
 ; X64-NEXT:    mov eax, 0x0
 ; X64-NEXT:    mov rbx, rax
-; X64-NEXT:  <L4>:
+; X64-NEXT:  <L2>:
 ; X64-NEXT:    mov eax, 0x0
 ; X64-NEXT:    add rsp, 0x28
 ; X64-NEXT:    pop rbx
@@ -1532,14 +1528,12 @@ define i32 @phi_gep_insert_after_earlier_phi() {
 ; ARM64-NEXT:    add x0, x0, #0x28
 ; ARM64-NEXT:    mov w1, #0x0 // =0
 ; ARM64-NEXT:    cmp w1, #0x0
-; ARM64-NEXT:    b.eq 0xb8c <phi_gep_insert_after_earlier_phi+0x3c>
-; ARM64-NEXT:    cmp w1, #0x1
 ; ARM64-NEXT:    b.eq 0xb90 <phi_gep_insert_after_earlier_phi+0x40>
-; ARM64-NEXT:    b 0xb88 <phi_gep_insert_after_earlier_phi+0x38>
-; ARM64-NEXT:    b 0xb98 <phi_gep_insert_after_earlier_phi+0x48>
-; ARM64-NEXT:    b 0xb98 <phi_gep_insert_after_earlier_phi+0x48>
+; ARM64-NEXT:    cmp w1, #0x1
+; ARM64-NEXT:    b.eq 0xb88 <phi_gep_insert_after_earlier_phi+0x38>
+; ARM64-NEXT:    b 0xb90 <phi_gep_insert_after_earlier_phi+0x40>
 ; ARM64-NEXT:    mov x19, x0
-; ARM64-NEXT:    b 0xba0 <phi_gep_insert_after_earlier_phi+0x50>
+; ARM64-NEXT:    b 0xb98 <phi_gep_insert_after_earlier_phi+0x48>
 ; ARM64-NEXT:    mov w0, #0x0 // =0
 ; ARM64-NEXT:    mov x19, x0
 ; ARM64-NEXT:    mov w0, #0x0 // =0
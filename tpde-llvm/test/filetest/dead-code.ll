@@ -0,0 +1,50 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --eliminate-dead-code --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --eliminate-dead-code --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare i64 @use(i64)
+
+; The whole chain is unused, including the load feeding the division.
+define i64 @dead_chain(i64 %a, i64 %b, ptr %p) {
+; X64-LABEL: <dead_chain>:
+; X64-NOT:     div
+; X64-NOT:     ptr [rsi
+; X64-NOT:     ptr [rdx
+; X64:         ret
+;
+; ARM64-LABEL: <dead_chain>:
+; ARM64-NOT:     udiv
+; ARM64-NOT:     ldr
+; ARM64:         ret
+entry:
+  %g = getelementptr i64, ptr %p, i64 %b
+  %l = load i64, ptr %g
+  %d = udiv i64 %a, %l
+  br label %next
+next:
+  %x = xor i64 %d, %b
+  ret i64 %a
+}
+
+; Instructions with side effects are kept even if their result is unused.
+define void @keep_side_effects(i64 %a, ptr %p) {
+; X64-LABEL: <keep_side_effects>:
+; X64:         mov {{.*}}, qword ptr [rsi]
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 use-0x4
+; X64:         ret
+;
+; ARM64-LABEL: <keep_side_effects>:
+; ARM64:         ldr
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 use
+; ARM64:         ret
+entry:
+  %l = load volatile i64, ptr %p
+  %c = call i64 @use(i64 %a)
+  ret void
+}
@@ -0,0 +1,41 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --elide-redundant-ext --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --elide-redundant-ext --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare void @use8(i8 zeroext)
+
+; The load already zero-extends, so the argument needs no extension.
+define void @load_arg(ptr %p) {
+; X64-LABEL: <load_arg>:
+; X64:         movzx {{.*}}, byte ptr
+; X64-NOT:     movzx
+; X64:         call
+;
+; ARM64-LABEL: <load_arg>:
+; ARM64:         ldrb
+; ARM64-NOT:     {{ubfx|uxtb}}
+; ARM64:         bl
+  %a = load i8, ptr %p
+  call void @use8(i8 zeroext %a)
+  ret void
+}
+
+; The second zext operates on an already zero-extended value.
+define i64 @zext_chain(i8 %a) {
+; X64-LABEL: <zext_chain>:
+; X64:         movzx
+; X64-NOT:     mov e{{[a-z0-9]+}}, e{{[a-z0-9]+}}
+; X64:         ret
+;
+; ARM64-LABEL: <zext_chain>:
+; ARM64:         {{ubfx|uxtb}}
+; ARM64-NOT:     {{ubfx|uxtw|mov w}}
+; ARM64:         ret
+  %b = zext i8 %a to i32
+  %c = zext i32 %b to i64
+  ret i64 %c
+}
@@ -0,0 +1,104 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare void @f()
+
+; Branches on the overflow flag of additions/subtractions use the CPU flags.
+define i32 @sadd_br(i32 %a, i32 %b) {
+; X64-LABEL: <sadd_br>:
+; X64:         add e{{[a-z0-9]+}}, e{{[a-z0-9]+}}
+; X64-NOT:     seto
+; X64-NOT:     test
+; X64:         j{{n?}}o
+;
+; ARM64-LABEL: <sadd_br>:
+; ARM64:         adds w{{[0-9]+}}, w{{[0-9]+}}, w{{[0-9]+}}
+; ARM64-NOT:     cset
+; ARM64-NOT:     tst
+; ARM64:         b.{{vs|vc}}
+entry:
+  %r = call { i32, i1 } @llvm.sadd.with.overflow.i32(i32 %a, i32 %b)
+  %v = extractvalue { i32, i1 } %r, 0
+  %o = extractvalue { i32, i1 } %r, 1
+  br i1 %o, label %trap, label %cont
+trap:
+  call void @f()
+  unreachable
+cont:
+  ret i32 %v
+}
+
+define i64 @usub_imm_br(i64 %a) {
+; X64-LABEL: <usub_imm_br>:
+; X64:         sub r{{[a-z0-9]+}}, 0x10
+; X64-NOT:     setb
+; X64-NOT:     test
+; X64:         j{{b|ae}}
+;
+; ARM64-LABEL: <usub_imm_br>:
+; ARM64:         subs x{{[0-9]+}}, x{{[0-9]+}}, #0x10
+; ARM64-NOT:     cset
+; ARM64-NOT:     tst
+; ARM64:         b.{{lo|hs}}
+entry:
+  %r = call { i64, i1 } @llvm.usub.with.overflow.i64(i64 %a, i64 16)
+  %o = extractvalue { i64, i1 } %r, 1
+  %v = extractvalue { i64, i1 } %r, 0
+  br i1 %o, label %trap, label %cont
+trap:
+  call void @f()
+  unreachable
+cont:
+  ret i64 %v
+}
+
+; Other operations branch on the register holding the flag.
+define i32 @umul_br(i32 %a, i32 %b) {
+; X64-LABEL: <umul_br>:
+; X64:         test {{[a-z0-9]+}}, 0x1
+; X64-NEXT:    j{{n?}}e
+;
+; ARM64-LABEL: <umul_br>:
+; ARM64-NOT:     tst
+; ARM64:         tb{{n?}}z w{{[0-9]+}}, #0x0
+entry:
+  %r = call { i32, i1 } @llvm.umul.with.overflow.i32(i32 %a, i32 %b)
+  %v = extractvalue { i32, i1 } %r, 0
+  %o = extractvalue { i32, i1 } %r, 1
+  br i1 %o, label %trap, label %cont
+trap:
+  call void @f()
+  unreachable
+cont:
+  ret i32 %v
+}
+
+; The success flag of cmpxchg is not materialized in the aggregate.
+define void @cmpxchg_loop(ptr %p) {
+; X64-LABEL: <cmpxchg_loop>:
+; X64:         lock
+; X64-NEXT:    cmpxchg qword ptr [{{[a-z0-9]+}}], {{[a-z0-9]+}}
+; X64:         test {{[a-z0-9]+}}, 0x1
+; X64-NEXT:    j{{n?}}e
+;
+; ARM64-LABEL: <cmpxchg_loop>:
+; ARM64:         casal
+; ARM64-NOT:     tst
+; ARM64:         tb{{n?}}z w{{[0-9]+}}, #0x0
+entry:
+  br label %loop
+loop:
+  %c = phi i64 [ 0, %entry ], [ %old, %loop ]
+  %n = add i64 %c, 1
+  %pair = cmpxchg ptr %p, i64 %c, i64 %n seq_cst seq_cst
+  %ok = extractvalue { i64, i1 } %pair, 1
+  %old = extractvalue { i64, i1 } %pair, 0
+  br i1 %ok, label %done, label %loop
+done:
+  ret void
+}
@@ -0,0 +1,86 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+%struct.s = type { i64, i32 }
+
+; The displacement of the GEP chain is folded into every part access.
+define { i64, i32 } @load_struct_gep(ptr %p) {
+; X64-LABEL: <load_struct_gep>:
+; X64:         mov {{.*}}, qword ptr [rdi + 0x20]
+; X64-NEXT:    mov {{.*}}, dword ptr [rdi + 0x28]
+;
+; ARM64-LABEL: <load_struct_gep>:
+; ARM64:         ldr {{x[0-9]+}}, [x0, #0x20]
+; ARM64-NEXT:    ldr {{w[0-9]+}}, [x0, #0x28]
+  %g = getelementptr %struct.s, ptr %p, i64 1
+  %h = getelementptr i8, ptr %g, i64 16
+  %v = load { i64, i32 }, ptr %h
+  ret { i64, i32 } %v
+}
+
+define void @store_struct_gep(ptr %p, i64 %a, i32 %b) {
+; X64-LABEL: <store_struct_gep>:
+; X64:         mov qword ptr [rdi + 0x10], rsi
+; X64-NEXT:    mov dword ptr [rdi + 0x18], edx
+;
+; ARM64-LABEL: <store_struct_gep>:
+; ARM64:         str x1, [x0, #0x10]
+; ARM64-NEXT:    str w2, [x0, #0x18]
+  %g = getelementptr %struct.s, ptr %p, i64 1
+  %v0 = insertvalue { i64, i32 } poison, i64 %a, 0
+  %v1 = insertvalue { i64, i32 } %v0, i32 %b, 1
+  store { i64, i32 } %v1, ptr %g
+  ret void
+}
+
+; Atomic operations use the fused address directly.
+define i32 @atomicrmw_gep(ptr %p, i32 %v) {
+; X64-LABEL: <atomicrmw_gep>:
+; X64:         lock
+; X64-NEXT:    xadd dword ptr [rdi + 0x8], {{.*}}
+; X64:         ret
+;
+; ARM64-LABEL: <atomicrmw_gep>:
+; ARM64:         add [[ADDR:x[0-9]+]], x0, #0x8
+; ARM64:         ldaddal w1, {{w[0-9]+}}, {{\[}}[[ADDR]]{{\]}}
+; ARM64:         ret
+  %g = getelementptr %struct.s, ptr %p, i64 0, i32 1
+  %old = atomicrmw add ptr %g, i32 %v seq_cst
+  ret i32 %old
+}
+
+define void @atomicrmw_gep_nouse(ptr %p, i32 %v) {
+; X64-LABEL: <atomicrmw_gep_nouse>:
+; X64:         lock
+; X64-NEXT:    add dword ptr [rdi + 0x8], esi
+; X64:         ret
+;
+; ARM64-LABEL: <atomicrmw_gep_nouse>:
+; ARM64:         add [[ADDR:x[0-9]+]], x0, #0x8
+; ARM64:         ldaddal w1, {{w[0-9]+}}, {{\[}}[[ADDR]]{{\]}}
+; ARM64:         ret
+  %g = getelementptr %struct.s, ptr %p, i64 0, i32 1
+  %old = atomicrmw add ptr %g, i32 %v seq_cst
+  ret void
+}
+
+define i32 @cmpxchg_gep(ptr %p, i32 %c, i32 %n) {
+; X64-LABEL: <cmpxchg_gep>:
+; X64:         lock
+; X64-NEXT:    cmpxchg dword ptr [rdi + 0x8], {{.*}}
+; X64:         ret
+;
+; ARM64-LABEL: <cmpxchg_gep>:
+; ARM64:         add [[ADDR:x[0-9]+]], x0, #0x8
+; ARM64:         casal {{w[0-9]+}}, {{w[0-9]+}}, {{\[}}[[ADDR]]{{\]}}
+; ARM64:         ret
+  %g = getelementptr %struct.s, ptr %p, i64 0, i32 1
+  %pair = cmpxchg ptr %g, i32 %c, i32 %n seq_cst seq_cst
+  %old = extractvalue { i32, i1 } %pair, 0
+  ret i32 %old
+}
@@ -13,7 +13,7 @@ define ptr @ret_dec_glob_external() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_dec_glob_external+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL dec_glob_external-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX dec_glob_external-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -69,7 +69,7 @@ define ptr @ret_dec_glob_extern_weak() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_dec_glob_extern_weak+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL dec_glob_extern_weak-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX dec_glob_extern_weak-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -97,7 +97,7 @@ define ptr @ret_dec_glob_extern_weak_dso_local() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_dec_glob_extern_weak_dso_local+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL dec_glob_extern_weak_dso_local-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX dec_glob_extern_weak_dso_local-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -125,7 +125,7 @@ define ptr @ret_def_glob_external() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_external+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_external-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_external-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -153,7 +153,7 @@ define ptr @ret_def_glob_external_dso_local() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_external_dso_local+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_external_dso_local-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_external_dso_local-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -321,7 +321,7 @@ define ptr @ret_def_glob_available_externally() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_available_externally+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_available_externally-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_available_externally-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -377,7 +377,7 @@ define ptr @ret_def_glob_linkonce() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_linkonce+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_linkonce-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_linkonce-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -433,7 +433,7 @@ define ptr @ret_def_glob_weak() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_weak+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_weak-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_weak-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -489,7 +489,7 @@ define ptr @ret_def_glob_common() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_common+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_common-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_common-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -545,7 +545,7 @@ define ptr @ret_def_glob_linkonce_odr() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_linkonce_odr+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_linkonce_odr-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_linkonce_odr-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -601,7 +601,7 @@ define ptr @ret_def_glob_weak_odr() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <ret_def_glob_weak_odr+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL def_glob_weak_odr-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX def_glob_weak_odr-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -58,8 +58,7 @@ define i32 @load_basic_int_twice() {
 ; X64-NEXT:    lea rax, <load_basic_int_twice+0x13>
 ; X64-NEXT:     R_X86_64_PC32 basic_int-0x4
 ; X64-NEXT:    mov ecx, dword ptr [rax]
-; X64-NEXT:    mov edx, dword ptr [rax]
-; X64-NEXT:    lea ecx, [rcx + rdx]
+; X64-NEXT:    add ecx, dword ptr [rax]
 ; X64-NEXT:    mov eax, ecx
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
@@ -94,7 +93,7 @@ define i32 @load_global_int() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <load_global_int+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL global_int-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX global_int-0x4
 ; X64-NEXT:    mov ecx, dword ptr [rax]
 ; X64-NEXT:    mov eax, ecx
 ; X64-NEXT:    add rsp, 0x30
@@ -126,7 +125,7 @@ define i32 @load_global_dso_local_int() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <load_global_dso_local_int+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL global_dso_local_int-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX global_dso_local_int-0x4
 ; X64-NEXT:    mov ecx, dword ptr [rax]
 ; X64-NEXT:    mov eax, ecx
 ; X64-NEXT:    add rsp, 0x30
@@ -158,7 +157,7 @@ define ptr @load_func_ptr() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <load_func_ptr+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL func_ptr-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX func_ptr-0x4
 ; X64-NEXT:    mov rcx, qword ptr [rax]
 ; X64-NEXT:    mov rax, rcx
 ; X64-NEXT:    add rsp, 0x30
@@ -191,7 +190,7 @@ define void @store_global_ptr(ptr %0) {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <store_global_ptr+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL global_ptr-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX global_ptr-0x4
 ; X64-NEXT:    mov qword ptr [rax], rdi
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
@@ -250,7 +249,7 @@ define ptr @get_func1() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <get_func1+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL func_ptr-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX func_ptr-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -278,7 +277,7 @@ define ptr @get_func2() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <get_func2+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL some_func-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX some_func-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
@@ -306,7 +305,7 @@ define {ptr, ptr} @get_struct1() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <get_struct1+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL func_ptr-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX func_ptr-0x4
 ; X64-NEXT:    lea rdx, <get_struct1+0x1a>
 ; X64-NEXT:     R_X86_64_PC32 basic_int-0x4
 ; X64-NEXT:    add rsp, 0x30
@@ -339,9 +338,9 @@ define {ptr, ptr} @get_struct2() {
 ; X64-NEXT:    nop word ptr [rax + rax]
 ; X64-NEXT:    sub rsp, 0x30
 ; X64-NEXT:    mov rax, qword ptr <get_struct2+0x13>
-; X64-NEXT:     R_X86_64_GOTPCREL some_func-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX some_func-0x4
 ; X64-NEXT:    mov rdx, qword ptr <get_struct2+0x1a>
-; X64-NEXT:     R_X86_64_GOTPCREL get_struct2-0x4
+; X64-NEXT:     R_X86_64_REX_GOTPCRELX get_struct2-0x4
 ; X64-NEXT:    add rsp, 0x30
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
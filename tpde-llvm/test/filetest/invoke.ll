@@ -302,6 +302,11 @@ define i32 @main(ptr %0, i64 %1) personality ptr @__gxx_personality_v0 {
 ; X64-NEXT:    call <L0>
 ; X64-NEXT:     R_X86_64_PLT32 fn_ptr_i64-0x4
 ; X64-NEXT:    mov qword ptr [rbp - 0x30], rax
+; X64-NEXT:    mov rax, qword ptr [rbp - 0x30]
+; X64-NEXT:    lea rax, [rax + 0x8]
+; X64-NEXT:  <L1>:
+; X64-NEXT:    mov eax, 0x0
+; X64-NEXT:    movzx eax, byte ptr [rbx + r12]
 ; X64-NEXT:    jmp <L1>
 ; X64-NEXT:    mov eax, 0x0
 ; X64-NEXT:    lea rsp, [rbp - 0x10]
@@ -309,14 +314,6 @@ define i32 @main(ptr %0, i64 %1) personality ptr @__gxx_personality_v0 {
 ; X64-NEXT:    pop rbx
 ; X64-NEXT:    pop rbp
 ; X64-NEXT:    ret
-; X64-NEXT:    nop word ptr [rax + rax]
-; X64-NEXT:  <L1>:
-; X64-NEXT:    mov rax, qword ptr [rbp - 0x30]
-; X64-NEXT:    lea rax, [rax + 0x8]
-; X64-NEXT:  <L2>:
-; X64-NEXT:    mov eax, 0x0
-; X64-NEXT:    movzx eax, byte ptr [rbx + r12]
-; X64-NEXT:    jmp <L2>
 ;
 ; ARM64-LABEL: <main>:
 ; ARM64:         sub sp, sp, #0xb0
@@ -329,20 +326,18 @@ define i32 @main(ptr %0, i64 %1) personality ptr @__gxx_personality_v0 {
 ; ARM64-NEXT:    bl 0x20c <main+0x1c>
 ; ARM64-NEXT:     R_AARCH64_CALL26 fn_ptr_i64
 ; ARM64-NEXT:    str x0, [x29, #0xa0]
-; ARM64-NEXT:    b 0x250 <main+0x60>
+; ARM64-NEXT:    ldr x0, [x29, #0xa0]
+; ARM64-NEXT:    add x0, x0, #0x8
+; ARM64-NEXT:    mov w0, #0x0 // =0
+; ARM64-NEXT:    add x0, x19, x20
+; ARM64-NEXT:    ldrb w0, [x0]
+; ARM64-NEXT:    b 0x{{[0-9a-f]+}} <main+0x{{[0-9a-f]+}}>
 ; ARM64-NEXT:    mov w0, #0x0 // =0
 ; ARM64-NEXT:    mov sp, x29
 ; ARM64-NEXT:    ldp x19, x20, [x29, #0x10]
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    add sp, sp, #0xb0
 ; ARM64-NEXT:    ret
-; ARM64-NEXT:     ...
-; ARM64-NEXT:    ldr x0, [x29, #0xa0]
-; ARM64-NEXT:    add x0, x0, #0x8
-; ARM64-NEXT:    mov w0, #0x0 // =0
-; ARM64-NEXT:    add x0, x19, x20
-; ARM64-NEXT:    ldrb w0, [x0]
-; ARM64-NEXT:    b 0x258 <main+0x68>
   %3 = invoke ptr @fn_ptr_i64(i64 0)
           to label %6 unwind label %4
 
@@ -0,0 +1,67 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+
+; Single-use loads immediately followed by their user are folded into the
+; user as memory operand.
+
+define i64 @add_load(i64 %a, ptr %p) {
+; X64-LABEL: <add_load>:
+; X64:         add {{.*}}, qword ptr [rsi + 0x8]
+; X64:         ret
+  %g = getelementptr i64, ptr %p, i64 1
+  %v = load i64, ptr %g
+  %r = add i64 %v, %a
+  ret i64 %r
+}
+
+define i32 @sub_load(i32 %a, ptr %p) {
+; X64-LABEL: <sub_load>:
+; X64:         sub {{.*}}, dword ptr [rsi]
+; X64:         ret
+  %v = load i32, ptr %p
+  %r = sub i32 %a, %v
+  ret i32 %r
+}
+
+define double @fadd_load(double %a, ptr %p) {
+; X64-LABEL: <fadd_load>:
+; X64:         addsd xmm{{[0-9]+}}, qword ptr [rdi]
+; X64:         ret
+  %v = load double, ptr %p
+  %r = fadd double %a, %v
+  ret double %r
+}
+
+define i1 @icmp_load_imm(ptr %p) {
+; X64-LABEL: <icmp_load_imm>:
+; X64:         cmp dword ptr [rdi], 0x2a
+; X64:         ret
+  %v = load i32, ptr %p
+  %r = icmp slt i32 %v, 42
+  ret i1 %r
+}
+
+; The memory operand is the first operand, so the condition is swapped.
+define i1 @icmp_load_rhs(i64 %a, ptr %p) {
+; X64-LABEL: <icmp_load_rhs>:
+; X64:         cmp qword ptr [rsi], rdi
+; X64-NEXT:    setg
+; X64:         ret
+  %v = load i64, ptr %p
+  %r = icmp slt i64 %a, %v
+  ret i1 %r
+}
+
+; Volatile loads are never folded.
+define i32 @add_load_volatile(i32 %a, ptr %p) {
+; X64-LABEL: <add_load_volatile>:
+; X64:         mov {{.*}}, dword ptr [rsi]
+; X64:         ret
+  %v = load volatile i32, ptr %p
+  %r = add i32 %a, %v
+  ret i32 %r
+}
@@ -0,0 +1,40 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --split-cold --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --split-cold --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare void @abort()
+
+; The cold block is moved into .text.unlikely and reached through a relocation.
+define i32 @split(i32 %a) {
+; X64-LABEL: <split>:
+; X64:         je
+; X64-NEXT:     R_X86_64_PC32 split.cold-0x4
+; X64:         ret
+; X64-NOT:     abort
+; X64-LABEL: Disassembly of section .text.unlikely:
+; X64-LABEL: <split.cold>:
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 abort-0x4
+;
+; ARM64-LABEL: <split>:
+; ARM64:         ret
+; ARM64:         b
+; ARM64-NEXT:     R_AARCH64_JUMP26 split.cold
+; ARM64-NOT:     abort
+; ARM64-LABEL: Disassembly of section .text.unlikely:
+; ARM64-LABEL: <split.cold>:
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 abort
+entry:
+  %c = icmp eq i32 %a, 0
+  br i1 %c, label %fail, label %ok
+fail:
+  call void @abort()
+  unreachable
+ok:
+  ret i32 %a
+}
@@ -0,0 +1,122 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+; Cases with few distinct targets in a range of at most 64 values are lowered
+; to one bit test per target.
+
+define i32 @bittest_one(i32 %a) {
+; X64-LABEL: <bittest_one>:
+; X64:         cmp {{.*}}, 0x9
+; X64-NEXT:    ja <L0>
+; X64-NEXT:    mov {{.*}}, 0x2aa
+; X64-NEXT:    bt {{.*}}
+; X64-NEXT:    jb <L1>
+; X64-NEXT:    jmp <L0>
+; X64-NOT:     cmp
+; X64:         ret
+;
+; ARM64-LABEL: <bittest_one>:
+; ARM64:         cmp {{w[0-9]+}}, #0x9
+; ARM64-NEXT:    b.hi
+; ARM64-NEXT:    mov [[BIT:x[0-9]+]], #0x1
+; ARM64-NEXT:    lsl [[BIT]], [[BIT]], [[IDX:x[0-9]+]]
+; ARM64-NEXT:    mov [[IDX]], #0x2aa
+; ARM64-NEXT:    tst [[BIT]], [[IDX]]
+; ARM64-NEXT:    b.ne
+; ARM64-NEXT:    b
+; ARM64-NOT:     cmp
+; ARM64:         ret
+entry:
+  switch i32 %a, label %default [
+    i32 1, label %odd
+    i32 3, label %odd
+    i32 5, label %odd
+    i32 7, label %odd
+    i32 9, label %odd
+  ]
+odd:
+  ret i32 1
+default:
+  ret i32 0
+}
+
+; The range does not start at zero, so the value is rebased first.
+define i32 @bittest_two(i64 %a) {
+; X64-LABEL: <bittest_two>:
+; X64:         cmp {{.*}}, 0x64
+; X64-NEXT:    jb <L0>
+; X64-NEXT:    cmp {{.*}}, 0x6e
+; X64-NEXT:    ja <L0>
+; X64-NEXT:    sub {{.*}}, 0x64
+; X64-NEXT:    mov {{.*}}, 0x15
+; X64-NEXT:    bt
+; X64-NEXT:    jb <L1>
+; X64-NEXT:    mov {{.*}}, 0x42a
+; X64-NEXT:    bt
+; X64-NEXT:    jb <L2>
+; X64-NEXT:    jmp <L0>
+; X64:         ret
+;
+; ARM64-LABEL: <bittest_two>:
+; ARM64:         cmp [[IDX:x[0-9]+]], #0x64
+; ARM64-NEXT:    b.lo
+; ARM64-NEXT:    cmp [[IDX]], #0x6e
+; ARM64-NEXT:    b.hi
+; ARM64-NEXT:    sub [[IDX]], [[IDX]], #0x64
+; ARM64-NEXT:    mov [[BIT:x[0-9]+]], #0x1
+; ARM64-NEXT:    lsl [[BIT]], [[BIT]], [[IDX]]
+; ARM64-NEXT:    mov [[IDX]], #0x15
+; ARM64-NEXT:    tst [[BIT]], [[IDX]]
+; ARM64-NEXT:    b.ne
+; ARM64-NEXT:    mov [[IDX]], #0x42a
+; ARM64-NEXT:    tst [[BIT]], [[IDX]]
+; ARM64-NEXT:    b.ne
+; ARM64-NEXT:    b
+; ARM64:         ret
+entry:
+  switch i64 %a, label %default [
+    i64 100, label %a0
+    i64 102, label %a0
+    i64 104, label %a0
+    i64 101, label %a1
+    i64 103, label %a1
+    i64 105, label %a1
+    i64 110, label %a1
+  ]
+a0:
+  ret i32 1
+a1:
+  ret i32 2
+default:
+  ret i32 0
+}
+
+; Targets with PHI nodes are reached through one shared label per target.
+define i32 @shared_phi_target(i32 %a) {
+; X64-LABEL: <shared_phi_target>:
+; X64:         je <L0>
+; X64:         je <L0>
+; X64:         jmp <L1>
+; X64-NEXT:  <L0>:
+; X64-NEXT:    mov
+; X64-NEXT:    jmp
+;
+; ARM64-LABEL: <shared_phi_target>:
+; ARM64:         b.eq [[TARGET:0x[0-9a-f]+]]
+; ARM64:         b.eq [[TARGET]]
+entry:
+  switch i32 %a, label %default [
+    i32 1, label %join
+    i32 40, label %join
+  ]
+default:
+  br label %join
+join:
+  %r = phi i32 [ %a, %entry ], [ %a, %entry ], [ 0, %default ]
+  ret i32 %r
+}
@@ -14,13 +14,12 @@ define i32 @empty_switch(i32 %0) {
 ; X64-NEXT:    d: 48 81 ec 30 00 00 00 sub rsp, 0x30
 ; X64-NEXT:    14: e9 00 00 00 00 jmp <L0>
 ; X64-NEXT:  <L0>:
-; X64-NEXT:    19: e9 00 00 00 00 jmp <L1>
-; X64-NEXT:  <L1>:
-; X64-NEXT:    1e: b8 ff ff ff ff mov eax, 0xffffffff
-; X64-NEXT:    23: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    27: 5d pop rbp
-; X64-NEXT:    28: c3 ret
-; X64-NEXT:    29: 0f 1f 80 00 00 00 00 nop dword ptr [rax]
+; X64-NEXT:    19: b8 ff ff ff ff mov eax, 0xffffffff
+; X64-NEXT:    1e: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    22: 5d pop rbp
+; X64-NEXT:    23: c3 ret
+; X64-NEXT:    24: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    2d: 0f 1f 00 nop dword ptr [rax]
 ;
 ; ARM64-LABEL: <empty_switch>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -28,7 +27,6 @@ define i32 @empty_switch(i32 %0) {
 ; ARM64-NEXT:    mov x29, sp
 ; ARM64-NEXT:    nop
 ; ARM64-NEXT:    b 0x34 <empty_switch+0x14>
-; ARM64-NEXT:    b 0x38 <empty_switch+0x18>
 ; ARM64-NEXT:    mov x0, #0xffffffff // =4294967295
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    add sp, sp, #0xa0
@@ -46,47 +44,40 @@ define i32 @basic_switch(i32 %0) {
 ; X64-NEXT:    34: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
 ; X64-NEXT:    3d: 48 81 ec 30 00 00 00 sub rsp, 0x30
 ; X64-NEXT:    44: 83 ff 00 cmp edi, 0x0
-; X64-NEXT:    47: 0f 84 1c 00 00 00 je <L0>
+; X64-NEXT:    47: 0f 84 17 00 00 00 je <L0>
 ; X64-NEXT:    4d: 83 ff 01 cmp edi, 0x1
-; X64-NEXT:    50: 0f 84 18 00 00 00 je <L1>
+; X64-NEXT:    50: 0f 84 25 00 00 00 je <L1>
 ; X64-NEXT:    56: 83 ff 02 cmp edi, 0x2
-; X64-NEXT:    59: 0f 84 14 00 00 00 je <L2>
-; X64-NEXT:    5f: e9 00 00 00 00 jmp <L3>
-; X64-NEXT:  <L3>:
-; X64-NEXT:    64: e9 54 00 00 00 jmp <L4>
+; X64-NEXT:    59: 0f 84 33 00 00 00 je <L2>
+; X64-NEXT:    5f: e9 45 00 00 00 jmp <L3>
 ; X64-NEXT:  <L0>:
-; X64-NEXT:    69: e9 0a 00 00 00 jmp <L5>
+; X64-NEXT:    64: b8 00 00 00 00 mov eax, 0x0
+; X64-NEXT:    69: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    6d: 5d pop rbp
+; X64-NEXT:    6e: c3 ret
+; X64-NEXT:    6f: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    78: 0f 1f 00 nop dword ptr [rax]
 ; X64-NEXT:  <L1>:
-; X64-NEXT:    6e: e9 1c 00 00 00 jmp <L6>
+; X64-NEXT:    7b: b8 01 00 00 00 mov eax, 0x1
+; X64-NEXT:    80: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    84: 5d pop rbp
+; X64-NEXT:    85: c3 ret
+; X64-NEXT:    86: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    8f: 0f 1f 00 nop dword ptr [rax]
 ; X64-NEXT:  <L2>:
-; X64-NEXT:    73: e9 2e 00 00 00 jmp <L7>
-; X64-NEXT:  <L5>:
-; X64-NEXT:    78: b8 00 00 00 00 mov eax, 0x0
-; X64-NEXT:    7d: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    81: 5d pop rbp
-; X64-NEXT:    82: c3 ret
-; X64-NEXT:    83: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    8c: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L6>:
-; X64-NEXT:    8f: b8 01 00 00 00 mov eax, 0x1
-; X64-NEXT:    94: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    98: 5d pop rbp
-; X64-NEXT:    99: c3 ret
-; X64-NEXT:    9a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    a3: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L7>:
-; X64-NEXT:    a6: b8 02 00 00 00 mov eax, 0x2
-; X64-NEXT:    ab: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    af: 5d pop rbp
-; X64-NEXT:    b0: c3 ret
-; X64-NEXT:    b1: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    ba: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L4>:
-; X64-NEXT:    bd: b8 ff ff ff ff mov eax, 0xffffffff
-; X64-NEXT:    c2: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    c6: 5d pop rbp
-; X64-NEXT:    c7: c3 ret
-; X64-NEXT:    c8: 0f 1f 84 00 00 00 00 00 nop dword ptr [rax + rax]
+; X64-NEXT:    92: b8 02 00 00 00 mov eax, 0x2
+; X64-NEXT:    97: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    9b: 5d pop rbp
+; X64-NEXT:    9c: c3 ret
+; X64-NEXT:    9d: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    a6: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:  <L3>:
+; X64-NEXT:    a9: b8 ff ff ff ff mov eax, 0xffffffff
+; X64-NEXT:    ae: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    b2: 5d pop rbp
+; X64-NEXT:    b3: c3 ret
+; X64-NEXT:    b4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    bd: 0f 1f 00 nop dword ptr [rax]
 ;
 ; ARM64-LABEL: <basic_switch>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -94,16 +85,12 @@ define i32 @basic_switch(i32 %0) {
 ; ARM64-NEXT:    mov x29, sp
 ; ARM64-NEXT:    nop
 ; ARM64-NEXT:    cmp w0, #0x0
-; ARM64-NEXT:    b.eq 0xa0 <basic_switch+0x30>
+; ARM64-NEXT:    b.eq 0x9c <basic_switch+0x2c>
 ; ARM64-NEXT:    cmp w0, #0x1
-; ARM64-NEXT:    b.eq 0xa4 <basic_switch+0x34>
+; ARM64-NEXT:    b.eq 0xd0 <basic_switch+0x60>
 ; ARM64-NEXT:    cmp w0, #0x2
-; ARM64-NEXT:    b.eq 0xa8 <basic_switch+0x38>
-; ARM64-NEXT:    b 0x9c <basic_switch+0x2c>
-; ARM64-NEXT:    b 0x148 <basic_switch+0xd8>
-; ARM64-NEXT:    b 0xac <basic_switch+0x3c>
-; ARM64-NEXT:    b 0xe0 <basic_switch+0x70>
-; ARM64-NEXT:    b 0x114 <basic_switch+0xa4>
+; ARM64-NEXT:    b.eq 0x104 <basic_switch+0x94>
+; ARM64-NEXT:    b 0x138 <basic_switch+0xc8>
 ; ARM64-NEXT:    mov w0, #0x0 // =0
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    add sp, sp, #0xa0
@@ -207,86 +194,72 @@ define i32 @switch_table(i32 %0) {
 ; x64:    1b3: c3 ret
 ; x64:     ...
 ; X64-LABEL: <switch_table>:
-; X64:         d0: 55 push rbp
-; X64-NEXT:    d1: 48 89 e5 mov rbp, rsp
-; X64-NEXT:    d4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    dd: 48 81 ec 30 00 00 00 sub rsp, 0x30
-; X64-NEXT:    e4: 83 ff 06 cmp edi, 0x6
-; X64-NEXT:    e7: 0f 87 2f 00 00 00 ja <L0>
-; X64-NEXT:    ed: 89 ff mov edi, edi
-; X64-NEXT:    ef: 48 8d 05 0a 00 00 00 lea rax, <switch_table+0x30>
-; X64-NEXT:    f6: 48 63 3c b8 movsxd rdi, dword ptr [rax + 4*rdi]
-; X64-NEXT:    fa: 48 01 f8 add rax, rdi
-; X64-NEXT:    fd: ff e0 jmp rax
-; X64-NEXT:    ff: 90 nop
-; X64-NEXT:    100: 21 00 and dword ptr [rax], eax
-; X64-NEXT:    102: 00 00 add byte ptr [rax], al
-; X64-NEXT:    104: 26 00 00 add byte ptr es:[rax], al
-; X64-NEXT:    107: 00 2b add byte ptr [rbx], ch
-; X64-NEXT:    109: 00 00 add byte ptr [rax], al
-; X64-NEXT:    10b: 00 1c 00 add byte ptr [rax + rax], bl
-; X64-NEXT:    10e: 00 00 add byte ptr [rax], al
-; X64-NEXT:    110: 30 00 xor byte ptr [rax], al
-; X64-NEXT:    112: 00 00 add byte ptr [rax], al
-; X64-NEXT:    114: 35 00 00 00 3a xor eax, 0x3a000000
-; X64-NEXT:    119: 00 00 add byte ptr [rax], al
-; X64-NEXT:    11b: 00 e9 add cl, ch
-; X64-NEXT:    11d: a8 00 test al, 0x0
-; X64-NEXT:    11f: 00 00 add byte ptr [rax], al
-; X64-NEXT:    121: e9 19 00 00 00 jmp <L1>
-; X64-NEXT:    126: e9 2b 00 00 00 jmp <L2>
-; X64-NEXT:    12b: e9 3d 00 00 00 jmp <L3>
-; X64-NEXT:    130: e9 4f 00 00 00 jmp <L4>
-; X64-NEXT:    135: e9 61 00 00 00 jmp <L5>
-; X64-NEXT:    13a: e9 73 00 00 00 jmp <L6>
-; X64-NEXT:  <L1>:
-; X64-NEXT:    13f: b8 00 00 00 00 mov eax, 0x0
-; X64-NEXT:    144: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    148: 5d pop rbp
-; X64-NEXT:    149: c3 ret
-; X64-NEXT:    14a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    153: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L2>:
-; X64-NEXT:    156: b8 01 00 00 00 mov eax, 0x1
-; X64-NEXT:    15b: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    15f: 5d pop rbp
-; X64-NEXT:    160: c3 ret
-; X64-NEXT:    161: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    16a: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L3>:
-; X64-NEXT:    16d: b8 02 00 00 00 mov eax, 0x2
-; X64-NEXT:    172: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    176: 5d pop rbp
-; X64-NEXT:    177: c3 ret
-; X64-NEXT:    178: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    181: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L4>:
-; X64-NEXT:    184: b8 04 00 00 00 mov eax, 0x4
-; X64-NEXT:    189: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    18d: 5d pop rbp
-; X64-NEXT:    18e: c3 ret
-; X64-NEXT:    18f: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    198: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L5>:
-; X64-NEXT:    19b: b8 05 00 00 00 mov eax, 0x5
-; X64-NEXT:    1a0: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    1a4: 5d pop rbp
-; X64-NEXT:    1a5: c3 ret
-; X64-NEXT:    1a6: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    1af: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L6>:
-; X64-NEXT:    1b2: b8 06 00 00 00 mov eax, 0x6
-; X64-NEXT:    1b7: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    1bb: 5d pop rbp
-; X64-NEXT:    1bc: c3 ret
-; X64-NEXT:    1bd: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    1c6: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:    1c9: b8 ff ff ff ff mov eax, 0xffffffff
-; X64-NEXT:    1ce: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    1d2: 5d pop rbp
-; X64-NEXT:    1d3: c3 ret
-; X64-NEXT:    1d4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    1dd: 0f 1f 00 nop dword ptr [rax]
+; X64:         c0: 55 push rbp
+; X64-NEXT:    c1: 48 89 e5 mov rbp, rsp
+; X64-NEXT:    c4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    cd: 48 81 ec 30 00 00 00 sub rsp, 0x30
+; X64-NEXT:    d4: 83 ff 06 cmp edi, 0x6
+; X64-NEXT:    d7: 0f 87 b9 00 00 00 ja <L0>
+; X64-NEXT:    dd: 89 ff mov edi, edi
+; X64-NEXT:    df: 48 8d 05 0a 00 00 00 lea rax, <switch_table+0x30>
+; X64-NEXT:    e6: 48 63 3c b8 movsxd rdi, dword ptr [rax + 4*rdi]
+; X64-NEXT:    ea: 48 01 f8 add rax, rdi
+; X64-NEXT:    ed: ff e0 jmp rax
+; X64-NEXT:    ef: 90 nop
+; X64-NEXT:    f0: 1c 00 sbb al, 0x0
+; X64-NEXT:    f2: 00 00 add byte ptr [rax], al
+; X64-NEXT:    f4: 33 00 xor eax, dword ptr [rax]
+; X64-NEXT:    f6: 00 00 add byte ptr [rax], al
+; X64-NEXT:    f8: 4a 00 00 add byte ptr [rax], al
+; X64-NEXT:    fb: 00 a6 00 00 00 61 add byte ptr [rsi + 0x61000000], ah
+; X64-NEXT:    101: 00 00 add byte ptr [rax], al
+; X64-NEXT:    103: 00 78 00 add byte ptr [rax], bh
+; X64-NEXT:    106: 00 00 add byte ptr [rax], al
+; X64-NEXT:    108: 8f 00 pop qword ptr [rax]
+; X64-NEXT:    10a: 00 00 add byte ptr [rax], al
+; X64-NEXT:    10c: b8 00 00 00 00 mov eax, 0x0
+; X64-NEXT:    111: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    115: 5d pop rbp
+; X64-NEXT:    116: c3 ret
+; X64-NEXT:    117: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    120: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    123: b8 01 00 00 00 mov eax, 0x1
+; X64-NEXT:    128: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    12c: 5d pop rbp
+; X64-NEXT:    12d: c3 ret
+; X64-NEXT:    12e: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    137: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    13a: b8 02 00 00 00 mov eax, 0x2
+; X64-NEXT:    13f: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    143: 5d pop rbp
+; X64-NEXT:    144: c3 ret
+; X64-NEXT:    145: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    14e: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    151: b8 04 00 00 00 mov eax, 0x4
+; X64-NEXT:    156: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    15a: 5d pop rbp
+; X64-NEXT:    15b: c3 ret
+; X64-NEXT:    15c: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    165: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    168: b8 05 00 00 00 mov eax, 0x5
+; X64-NEXT:    16d: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    171: 5d pop rbp
+; X64-NEXT:    172: c3 ret
+; X64-NEXT:    173: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    17c: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    17f: b8 06 00 00 00 mov eax, 0x6
+; X64-NEXT:    184: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    188: 5d pop rbp
+; X64-NEXT:    189: c3 ret
+; X64-NEXT:    18a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    193: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:  <L0>:
+; X64-NEXT:    196: b8 ff ff ff ff mov eax, 0xffffffff
+; X64-NEXT:    19b: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    19f: 5d pop rbp
+; X64-NEXT:    1a0: c3 ret
+; X64-NEXT:    1a1: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    1aa: 66 0f 1f 44 00 00 nop word ptr [rax + rax]
 ;
 ; ARM64-LABEL: <switch_table>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -294,27 +267,20 @@ define i32 @switch_table(i32 %0) {
 ; ARM64-NEXT:    mov x29, sp
 ; ARM64-NEXT:    nop
 ; ARM64-NEXT:    cmp w0, #0x4
-; ARM64-NEXT:    b.eq 0x1dc <switch_table+0x5c>
-; ARM64-NEXT:    b.hi 0x1b8 <switch_table+0x38>
+; ARM64-NEXT:    b.eq 0x258 <switch_table+0xe8>
+; ARM64-NEXT:    b.hi 0x1a8 <switch_table+0x38>
 ; ARM64-NEXT:    cmp w0, #0x0
-; ARM64-NEXT:    b.eq 0x1d0 <switch_table+0x50>
+; ARM64-NEXT:    b.eq 0x1bc <switch_table+0x4c>
 ; ARM64-NEXT:    cmp w0, #0x1
-; ARM64-NEXT:    b.eq 0x1d4 <switch_table+0x54>
+; ARM64-NEXT:    b.eq 0x1f0 <switch_table+0x80>
 ; ARM64-NEXT:    cmp w0, #0x2
-; ARM64-NEXT:    b.eq 0x1d8 <switch_table+0x58>
-; ARM64-NEXT:    b 0x1cc <switch_table+0x4c>
+; ARM64-NEXT:    b.eq 0x224 <switch_table+0xb4>
+; ARM64-NEXT:    b 0x2f4 <switch_table+0x184>
 ; ARM64-NEXT:    cmp w0, #0x5
-; ARM64-NEXT:    b.eq 0x1e0 <switch_table+0x60>
+; ARM64-NEXT:    b.eq 0x28c <switch_table+0x11c>
 ; ARM64-NEXT:    cmp w0, #0x6
-; ARM64-NEXT:    b.eq 0x1e4 <switch_table+0x64>
-; ARM64-NEXT:    b 0x1cc <switch_table+0x4c>
-; ARM64-NEXT:    b 0x320 <switch_table+0x1a0>
-; ARM64-NEXT:    b 0x1e8 <switch_table+0x68>
-; ARM64-NEXT:    b 0x21c <switch_table+0x9c>
-; ARM64-NEXT:    b 0x250 <switch_table+0xd0>
-; ARM64-NEXT:    b 0x284 <switch_table+0x104>
-; ARM64-NEXT:    b 0x2b8 <switch_table+0x138>
-; ARM64-NEXT:    b 0x2ec <switch_table+0x16c>
+; ARM64-NEXT:    b.eq 0x2c0 <switch_table+0x150>
+; ARM64-NEXT:    b 0x2f4 <switch_table+0x184>
 ; ARM64-NEXT:    mov w0, #0x0 // =0
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    add sp, sp, #0xa0
@@ -375,86 +341,73 @@ default:
 
 define i32 @switch_table2(i32 %0) {
 ; X64-LABEL: <switch_table2>:
-; X64:         1e0: 55 push rbp
-; X64-NEXT:    1e1: 48 89 e5 mov rbp, rsp
-; X64-NEXT:    1e4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    1ed: 48 81 ec 30 00 00 00 sub rsp, 0x30
-; X64-NEXT:    1f4: 83 ff 03 cmp edi, 0x3
-; X64-NEXT:    1f7: 0f 82 3b 00 00 00 jb <L0>
-; X64-NEXT:    1fd: 83 ff 09 cmp edi, 0x9
-; X64-NEXT:    200: 0f 87 32 00 00 00 ja <L0>
-; X64-NEXT:    206: 89 ff mov edi, edi
-; X64-NEXT:    208: 48 83 ef 03 sub rdi, 0x3
-; X64-NEXT:    20c: 48 8d 05 09 00 00 00 lea rax, <switch_table2+0x3c>
-; X64-NEXT:    213: 48 63 3c b8 movsxd rdi, dword ptr [rax + 4*rdi]
-; X64-NEXT:    217: 48 01 f8 add rax, rdi
-; X64-NEXT:    21a: ff e0 jmp rax
-; X64-NEXT:    21c: 21 00 and dword ptr [rax], eax
-; X64-NEXT:    21e: 00 00 add byte ptr [rax], al
-; X64-NEXT:    220: 26 00 00 add byte ptr es:[rax], al
-; X64-NEXT:    223: 00 2b add byte ptr [rbx], ch
-; X64-NEXT:    225: 00 00 add byte ptr [rax], al
-; X64-NEXT:    227: 00 1c 00 add byte ptr [rax + rax], bl
-; X64-NEXT:    22a: 00 00 add byte ptr [rax], al
-; X64-NEXT:    22c: 30 00 xor byte ptr [rax], al
-; X64-NEXT:    22e: 00 00 add byte ptr [rax], al
-; X64-NEXT:    230: 35 00 00 00 3a xor eax, 0x3a000000
-; X64-NEXT:    235: 00 00 add byte ptr [rax], al
-; X64-NEXT:    237: 00 e9 add cl, ch
-; X64-NEXT:    239: a8 00 test al, 0x0
-; X64-NEXT:    23b: 00 00 add byte ptr [rax], al
-; X64-NEXT:    23d: e9 19 00 00 00 jmp <L1>
-; X64-NEXT:    242: e9 2b 00 00 00 jmp <L2>
-; X64-NEXT:    247: e9 3d 00 00 00 jmp <L3>
-; X64-NEXT:    24c: e9 4f 00 00 00 jmp <L4>
-; X64-NEXT:    251: e9 61 00 00 00 jmp <L5>
-; X64-NEXT:    256: e9 73 00 00 00 jmp <L6>
-; X64-NEXT:  <L1>:
-; X64-NEXT:    25b: b8 03 00 00 00 mov eax, 0x3
-; X64-NEXT:    260: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    264: 5d pop rbp
-; X64-NEXT:    265: c3 ret
-; X64-NEXT:    266: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    26f: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L2>:
-; X64-NEXT:    272: b8 04 00 00 00 mov eax, 0x4
-; X64-NEXT:    277: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    27b: 5d pop rbp
-; X64-NEXT:    27c: c3 ret
-; X64-NEXT:    27d: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    286: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L3>:
-; X64-NEXT:    289: b8 05 00 00 00 mov eax, 0x5
-; X64-NEXT:    28e: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    292: 5d pop rbp
-; X64-NEXT:    293: c3 ret
-; X64-NEXT:    294: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64:         1b0: 55 push rbp
+; X64-NEXT:    1b1: 48 89 e5 mov rbp, rsp
+; X64-NEXT:    1b4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    1bd: 48 81 ec 30 00 00 00 sub rsp, 0x30
+; X64-NEXT:    1c4: 83 ff 03 cmp edi, 0x3
+; X64-NEXT:    1c7: 0f 82 c5 00 00 00 jb <L0>
+; X64-NEXT:    1cd: 83 ff 09 cmp edi, 0x9
+; X64-NEXT:    1d0: 0f 87 bc 00 00 00 ja <L0>
+; X64-NEXT:    1d6: 89 ff mov edi, edi
+; X64-NEXT:    1d8: 48 83 ef 03 sub rdi, 0x3
+; X64-NEXT:    1dc: 48 8d 05 09 00 00 00 lea rax, <switch_table2+0x3c>
+; X64-NEXT:    1e3: 48 63 3c b8 movsxd rdi, dword ptr [rax + 4*rdi]
+; X64-NEXT:    1e7: 48 01 f8 add rax, rdi
+; X64-NEXT:    1ea: ff e0 jmp rax
+; X64-NEXT:    1ec: 1c 00 sbb al, 0x0
+; X64-NEXT:    1ee: 00 00 add byte ptr [rax], al
+; X64-NEXT:    1f0: 33 00 xor eax, dword ptr [rax]
+; X64-NEXT:    1f2: 00 00 add byte ptr [rax], al
+; X64-NEXT:    1f4: 4a 00 00 add byte ptr [rax], al
+; X64-NEXT:    1f7: 00 a6 00 00 00 61 add byte ptr [rsi + 0x61000000], ah
+; X64-NEXT:    1fd: 00 00 add byte ptr [rax], al
+; X64-NEXT:    1ff: 00 78 00 add byte ptr [rax], bh
+; X64-NEXT:    202: 00 00 add byte ptr [rax], al
+; X64-NEXT:    204: 8f 00 pop qword ptr [rax]
+; X64-NEXT:    206: 00 00 add byte ptr [rax], al
+; X64-NEXT:    208: b8 03 00 00 00 mov eax, 0x3
+; X64-NEXT:    20d: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    211: 5d pop rbp
+; X64-NEXT:    212: c3 ret
+; X64-NEXT:    213: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    21c: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    21f: b8 04 00 00 00 mov eax, 0x4
+; X64-NEXT:    224: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    228: 5d pop rbp
+; X64-NEXT:    229: c3 ret
+; X64-NEXT:    22a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    233: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    236: b8 05 00 00 00 mov eax, 0x5
+; X64-NEXT:    23b: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    23f: 5d pop rbp
+; X64-NEXT:    240: c3 ret
+; X64-NEXT:    241: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    24a: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    24d: b8 07 00 00 00 mov eax, 0x7
+; X64-NEXT:    252: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    256: 5d pop rbp
+; X64-NEXT:    257: c3 ret
+; X64-NEXT:    258: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    261: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    264: b8 08 00 00 00 mov eax, 0x8
+; X64-NEXT:    269: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    26d: 5d pop rbp
+; X64-NEXT:    26e: c3 ret
+; X64-NEXT:    26f: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    278: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    27b: b8 09 00 00 00 mov eax, 0x9
+; X64-NEXT:    280: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    284: 5d pop rbp
+; X64-NEXT:    285: c3 ret
+; X64-NEXT:    286: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    28f: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:  <L0>:
+; X64-NEXT:    292: b8 ff ff ff ff mov eax, 0xffffffff
+; X64-NEXT:    297: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    29b: 5d pop rbp
+; X64-NEXT:    29c: c3 ret
 ; X64-NEXT:    29d: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L4>:
-; X64-NEXT:    2a0: b8 07 00 00 00 mov eax, 0x7
-; X64-NEXT:    2a5: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    2a9: 5d pop rbp
-; X64-NEXT:    2aa: c3 ret
-; X64-NEXT:    2ab: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    2b4: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L5>:
-; X64-NEXT:    2b7: b8 08 00 00 00 mov eax, 0x8
-; X64-NEXT:    2bc: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    2c0: 5d pop rbp
-; X64-NEXT:    2c1: c3 ret
-; X64-NEXT:    2c2: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    2cb: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L6>:
-; X64-NEXT:    2ce: b8 09 00 00 00 mov eax, 0x9
-; X64-NEXT:    2d3: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    2d7: 5d pop rbp
-; X64-NEXT:    2d8: c3 ret
-; X64-NEXT:    2d9: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    2e2: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:    2e5: b8 ff ff ff ff mov eax, 0xffffffff
-; X64-NEXT:    2ea: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    2ee: 5d pop rbp
-; X64-NEXT:    2ef: c3 ret
 ;
 ; ARM64-LABEL: <switch_table2>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -462,27 +415,20 @@ define i32 @switch_table2(i32 %0) {
 ; ARM64-NEXT:    mov x29, sp
 ; ARM64-NEXT:    nop
 ; ARM64-NEXT:    cmp w0, #0x7
-; ARM64-NEXT:    b.eq 0x3ac <switch_table2+0x5c>
-; ARM64-NEXT:    b.hi 0x388 <switch_table2+0x38>
+; ARM64-NEXT:    b.eq 0x418 <switch_table2+0xe8>
+; ARM64-NEXT:    b.hi 0x368 <switch_table2+0x38>
 ; ARM64-NEXT:    cmp w0, #0x3
-; ARM64-NEXT:    b.eq 0x3a0 <switch_table2+0x50>
+; ARM64-NEXT:    b.eq 0x37c <switch_table2+0x4c>
 ; ARM64-NEXT:    cmp w0, #0x4
-; ARM64-NEXT:    b.eq 0x3a4 <switch_table2+0x54>
+; ARM64-NEXT:    b.eq 0x3b0 <switch_table2+0x80>
 ; ARM64-NEXT:    cmp w0, #0x5
-; ARM64-NEXT:    b.eq 0x3a8 <switch_table2+0x58>
-; ARM64-NEXT:    b 0x39c <switch_table2+0x4c>
+; ARM64-NEXT:    b.eq 0x3e4 <switch_table2+0xb4>
+; ARM64-NEXT:    b 0x4b4 <switch_table2+0x184>
 ; ARM64-NEXT:    cmp w0, #0x8
-; ARM64-NEXT:    b.eq 0x3b0 <switch_table2+0x60>
+; ARM64-NEXT:    b.eq 0x44c <switch_table2+0x11c>
 ; ARM64-NEXT:    cmp w0, #0x9
-; ARM64-NEXT:    b.eq 0x3b4 <switch_table2+0x64>
-; ARM64-NEXT:    b 0x39c <switch_table2+0x4c>
-; ARM64-NEXT:    b 0x4f0 <switch_table2+0x1a0>
-; ARM64-NEXT:    b 0x3b8 <switch_table2+0x68>
-; ARM64-NEXT:    b 0x3ec <switch_table2+0x9c>
-; ARM64-NEXT:    b 0x420 <switch_table2+0xd0>
-; ARM64-NEXT:    b 0x454 <switch_table2+0x104>
-; ARM64-NEXT:    b 0x488 <switch_table2+0x138>
-; ARM64-NEXT:    b 0x4bc <switch_table2+0x16c>
+; ARM64-NEXT:    b.eq 0x480 <switch_table2+0x150>
+; ARM64-NEXT:    b 0x4b4 <switch_table2+0x184>
 ; ARM64-NEXT:    mov x0, #0x3 // =3
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    add sp, sp, #0xa0
@@ -544,77 +490,65 @@ default:
 
 define i32 @switch_binsearch(i32 %0) {
 ; X64-LABEL: <switch_binsearch>:
-; X64:         2f0: 55 push rbp
-; X64-NEXT:    2f1: 48 89 e5 mov rbp, rsp
-; X64-NEXT:    2f4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    2fd: 48 81 ec 30 00 00 00 sub rsp, 0x30
-; X64-NEXT:    304: 83 ff 03 cmp edi, 0x3
-; X64-NEXT:    307: 0f 84 43 00 00 00 je <L0>
-; X64-NEXT:    30d: 0f 87 17 00 00 00 ja <L1>
-; X64-NEXT:    313: 83 ff 01 cmp edi, 0x1
-; X64-NEXT:    316: 0f 84 2a 00 00 00 je <L2>
-; X64-NEXT:    31c: 83 ff 02 cmp edi, 0x2
-; X64-NEXT:    31f: 0f 84 26 00 00 00 je <L3>
-; X64-NEXT:    325: e9 17 00 00 00 jmp <L4>
+; X64:         2a0: 55 push rbp
+; X64-NEXT:    2a1: 48 89 e5 mov rbp, rsp
+; X64-NEXT:    2a4: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    2ad: 48 81 ec 30 00 00 00 sub rsp, 0x30
+; X64-NEXT:    2b4: 83 ff 03 cmp edi, 0x3
+; X64-NEXT:    2b7: 0f 84 62 00 00 00 je <L0>
+; X64-NEXT:    2bd: 0f 87 17 00 00 00 ja <L1>
+; X64-NEXT:    2c3: 83 ff 01 cmp edi, 0x1
+; X64-NEXT:    2c6: 0f 84 25 00 00 00 je <L2>
+; X64-NEXT:    2cc: 83 ff 02 cmp edi, 0x2
+; X64-NEXT:    2cf: 0f 84 33 00 00 00 je <L3>
+; X64-NEXT:    2d5: e9 8a 00 00 00 jmp <L4>
 ; X64-NEXT:  <L1>:
-; X64-NEXT:    32a: 83 ff 64 cmp edi, 0x64
-; X64-NEXT:    32d: 0f 84 22 00 00 00 je <L5>
-; X64-NEXT:    333: 83 ff 65 cmp edi, 0x65
-; X64-NEXT:    336: 0f 84 1e 00 00 00 je <L6>
-; X64-NEXT:    33c: e9 00 00 00 00 jmp <L4>
-; X64-NEXT:  <L4>:
-; X64-NEXT:    341: e9 8c 00 00 00 jmp <L7>
+; X64-NEXT:    2da: 83 ff 64 cmp edi, 0x64
+; X64-NEXT:    2dd: 0f 84 53 00 00 00 je <L5>
+; X64-NEXT:    2e3: 83 ff 65 cmp edi, 0x65
+; X64-NEXT:    2e6: 0f 84 61 00 00 00 je <L6>
+; X64-NEXT:    2ec: e9 73 00 00 00 jmp <L4>
 ; X64-NEXT:  <L2>:
-; X64-NEXT:    346: e9 14 00 00 00 jmp <L8>
+; X64-NEXT:    2f1: b8 01 00 00 00 mov eax, 0x1
+; X64-NEXT:    2f6: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    2fa: 5d pop rbp
+; X64-NEXT:    2fb: c3 ret
+; X64-NEXT:    2fc: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    305: 0f 1f 00 nop dword ptr [rax]
 ; X64-NEXT:  <L3>:
-; X64-NEXT:    34b: e9 26 00 00 00 jmp <L9>
+; X64-NEXT:    308: b8 02 00 00 00 mov eax, 0x2
+; X64-NEXT:    30d: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    311: 5d pop rbp
+; X64-NEXT:    312: c3 ret
+; X64-NEXT:    313: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    31c: 0f 1f 00 nop dword ptr [rax]
 ; X64-NEXT:  <L0>:
-; X64-NEXT:    350: e9 38 00 00 00 jmp <L10>
+; X64-NEXT:    31f: b8 03 00 00 00 mov eax, 0x3
+; X64-NEXT:    324: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    328: 5d pop rbp
+; X64-NEXT:    329: c3 ret
+; X64-NEXT:    32a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    333: 0f 1f 00 nop dword ptr [rax]
 ; X64-NEXT:  <L5>:
-; X64-NEXT:    355: e9 4a 00 00 00 jmp <L11>
+; X64-NEXT:    336: b8 64 00 00 00 mov eax, 0x64
+; X64-NEXT:    33b: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    33f: 5d pop rbp
+; X64-NEXT:    340: c3 ret
+; X64-NEXT:    341: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    34a: 0f 1f 00 nop dword ptr [rax]
 ; X64-NEXT:  <L6>:
-; X64-NEXT:    35a: e9 5c 00 00 00 jmp <L12>
-; X64-NEXT:  <L8>:
-; X64-NEXT:    35f: b8 01 00 00 00 mov eax, 0x1
-; X64-NEXT:    364: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    368: 5d pop rbp
-; X64-NEXT:    369: c3 ret
-; X64-NEXT:    36a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    373: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L9>:
-; X64-NEXT:    376: b8 02 00 00 00 mov eax, 0x2
-; X64-NEXT:    37b: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    37f: 5d pop rbp
-; X64-NEXT:    380: c3 ret
-; X64-NEXT:    381: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    38a: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L10>:
-; X64-NEXT:    38d: b8 03 00 00 00 mov eax, 0x3
-; X64-NEXT:    392: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    396: 5d pop rbp
-; X64-NEXT:    397: c3 ret
-; X64-NEXT:    398: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    3a1: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L11>:
-; X64-NEXT:    3a4: b8 64 00 00 00 mov eax, 0x64
-; X64-NEXT:    3a9: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    3ad: 5d pop rbp
-; X64-NEXT:    3ae: c3 ret
-; X64-NEXT:    3af: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    3b8: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L12>:
-; X64-NEXT:    3bb: b8 65 00 00 00 mov eax, 0x65
-; X64-NEXT:    3c0: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    3c4: 5d pop rbp
-; X64-NEXT:    3c5: c3 ret
-; X64-NEXT:    3c6: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    3cf: 0f 1f 00 nop dword ptr [rax]
-; X64-NEXT:  <L7>:
-; X64-NEXT:    3d2: b8 ff ff ff ff mov eax, 0xffffffff
-; X64-NEXT:    3d7: 48 83 c4 30 add rsp, 0x30
-; X64-NEXT:    3db: 5d pop rbp
-; X64-NEXT:    3dc: c3 ret
-; X64-NEXT:    3dd: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:    34d: b8 65 00 00 00 mov eax, 0x65
+; X64-NEXT:    352: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    356: 5d pop rbp
+; X64-NEXT:    357: c3 ret
+; X64-NEXT:    358: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    361: 0f 1f 00 nop dword ptr [rax]
+; X64-NEXT:  <L4>:
+; X64-NEXT:    364: b8 ff ff ff ff mov eax, 0xffffffff
+; X64-NEXT:    369: 48 83 c4 30 add rsp, 0x30
+; X64-NEXT:    36d: 5d pop rbp
+; X64-NEXT:    36e: c3 ret
+; X64-NEXT:    36f: 90 nop
 ;
 ; ARM64-LABEL: <switch_binsearch>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -622,24 +556,18 @@ define i32 @switch_binsearch(i32 %0) {
 ; ARM64-NEXT:    mov x29, sp
 ; ARM64-NEXT:    nop
 ; ARM64-NEXT:    cmp w0, #0x3
-; ARM64-NEXT:    b.eq 0x570 <switch_binsearch+0x50>
-; ARM64-NEXT:    b.hi 0x550 <switch_binsearch+0x30>
+; ARM64-NEXT:    b.eq 0x59c <switch_binsearch+0xac>
+; ARM64-NEXT:    b.hi 0x520 <switch_binsearch+0x30>
 ; ARM64-NEXT:    cmp w0, #0x1
-; ARM64-NEXT:    b.eq 0x568 <switch_binsearch+0x48>
+; ARM64-NEXT:    b.eq 0x534 <switch_binsearch+0x44>
 ; ARM64-NEXT:    cmp w0, #0x2
-; ARM64-NEXT:    b.eq 0x56c <switch_binsearch+0x4c>
-; ARM64-NEXT:    b 0x564 <switch_binsearch+0x44>
+; ARM64-NEXT:    b.eq 0x568 <switch_binsearch+0x78>
+; ARM64-NEXT:    b 0x638 <switch_binsearch+0x148>
 ; ARM64-NEXT:    cmp w0, #0x64
-; ARM64-NEXT:    b.eq 0x574 <switch_binsearch+0x54>
+; ARM64-NEXT:    b.eq 0x5d0 <switch_binsearch+0xe0>
 ; ARM64-NEXT:    cmp w0, #0x65
-; ARM64-NEXT:    b.eq 0x578 <switch_binsearch+0x58>
-; ARM64-NEXT:    b 0x564 <switch_binsearch+0x44>
-; ARM64-NEXT:    b 0x680 <switch_binsearch+0x160>
-; ARM64-NEXT:    b 0x57c <switch_binsearch+0x5c>
-; ARM64-NEXT:    b 0x5b0 <switch_binsearch+0x90>
-; ARM64-NEXT:    b 0x5e4 <switch_binsearch+0xc4>
-; ARM64-NEXT:    b 0x618 <switch_binsearch+0xf8>
-; ARM64-NEXT:    b 0x64c <switch_binsearch+0x12c>
+; ARM64-NEXT:    b.eq 0x604 <switch_binsearch+0x114>
+; ARM64-NEXT:    b 0x638 <switch_binsearch+0x148>
 ; ARM64-NEXT:    mov x0, #0x1 // =1
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    add sp, sp, #0xa0
@@ -693,48 +621,42 @@ default:
 
 define i32 @switch_i32_noreuse(i32 %p) {
 ; X64-LABEL: <switch_i32_noreuse>:
-; X64:         3e0: 55 push rbp
-; X64-NEXT:    3e1: 48 89 e5 mov rbp, rsp
-; X64-NEXT:    3e4: 53 push rbx
-; X64-NEXT:    3e5: 0f 1f 84 00 00 00 00 00 nop dword ptr [rax + rax]
-; X64-NEXT:    3ed: 48 81 ec 28 00 00 00 sub rsp, 0x28
-; X64-NEXT:    3f4: 89 fb mov ebx, edi
-; X64-NEXT:    3f6: 89 d8 mov eax, ebx
-; X64-NEXT:    3f8: 83 f8 01 cmp eax, 0x1
-; X64-NEXT:    3fb: 0f 84 13 00 00 00 je <L0>
-; X64-NEXT:    401: 83 f8 02 cmp eax, 0x2
-; X64-NEXT:    404: 0f 84 0f 00 00 00 je <L1>
-; X64-NEXT:    40a: e9 00 00 00 00 jmp <L2>
-; X64-NEXT:  <L2>:
-; X64-NEXT:    40f: e9 38 00 00 00 jmp <L3>
+; X64:         370: 55 push rbp
+; X64-NEXT:    371: 48 89 e5 mov rbp, rsp
+; X64-NEXT:    374: 53 push rbx
+; X64-NEXT:    375: 0f 1f 84 00 00 00 00 00 nop dword ptr [rax + rax]
+; X64-NEXT:    37d: 48 81 ec 28 00 00 00 sub rsp, 0x28
+; X64-NEXT:    384: 89 fb mov ebx, edi
+; X64-NEXT:    386: 89 d8 mov eax, ebx
+; X64-NEXT:    388: 83 f8 01 cmp eax, 0x1
+; X64-NEXT:    38b: 0f 84 0e 00 00 00 je <L0>
+; X64-NEXT:    391: 83 f8 02 cmp eax, 0x2
+; X64-NEXT:    394: 0f 84 1c 00 00 00 je <L1>
+; X64-NEXT:    39a: e9 2e 00 00 00 jmp <L2>
 ; X64-NEXT:  <L0>:
-; X64-NEXT:    414: e9 05 00 00 00 jmp <L4>
+; X64-NEXT:    39f: b8 01 00 00 00 mov eax, 0x1
+; X64-NEXT:    3a4: 48 83 c4 28 add rsp, 0x28
+; X64-NEXT:    3a8: 5b pop rbx
+; X64-NEXT:    3a9: 5d pop rbp
+; X64-NEXT:    3aa: c3 ret
+; X64-NEXT:    3ab: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    3b4: 66 90 nop
 ; X64-NEXT:  <L1>:
-; X64-NEXT:    419: e9 17 00 00 00 jmp <L5>
-; X64-NEXT:  <L4>:
-; X64-NEXT:    41e: b8 01 00 00 00 mov eax, 0x1
-; X64-NEXT:    423: 48 83 c4 28 add rsp, 0x28
-; X64-NEXT:    427: 5b pop rbx
-; X64-NEXT:    428: 5d pop rbp
-; X64-NEXT:    429: c3 ret
-; X64-NEXT:    42a: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    433: 66 90 nop
-; X64-NEXT:  <L5>:
-; X64-NEXT:    435: b8 02 00 00 00 mov eax, 0x2
-; X64-NEXT:    43a: 48 83 c4 28 add rsp, 0x28
-; X64-NEXT:    43e: 5b pop rbx
-; X64-NEXT:    43f: 5d pop rbp
-; X64-NEXT:    440: c3 ret
-; X64-NEXT:    441: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    44a: 66 90 nop
-; X64-NEXT:  <L3>:
-; X64-NEXT:    44c: 89 d8 mov eax, ebx
-; X64-NEXT:    44e: 48 83 c4 28 add rsp, 0x28
-; X64-NEXT:    452: 5b pop rbx
-; X64-NEXT:    453: 5d pop rbp
-; X64-NEXT:    454: c3 ret
-; X64-NEXT:    455: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    45e: 66 90 nop
+; X64-NEXT:    3b6: b8 02 00 00 00 mov eax, 0x2
+; X64-NEXT:    3bb: 48 83 c4 28 add rsp, 0x28
+; X64-NEXT:    3bf: 5b pop rbx
+; X64-NEXT:    3c0: 5d pop rbp
+; X64-NEXT:    3c1: c3 ret
+; X64-NEXT:    3c2: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    3cb: 66 90 nop
+; X64-NEXT:  <L2>:
+; X64-NEXT:    3cd: 89 d8 mov eax, ebx
+; X64-NEXT:    3cf: 48 83 c4 28 add rsp, 0x28
+; X64-NEXT:    3d3: 5b pop rbx
+; X64-NEXT:    3d4: 5d pop rbp
+; X64-NEXT:    3d5: c3 ret
+; X64-NEXT:    3d6: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    3df: 90 nop
 ;
 ; ARM64-LABEL: <switch_i32_noreuse>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -744,13 +666,10 @@ define i32 @switch_i32_noreuse(i32 %p) {
 ; ARM64-NEXT:    mov w19, w0
 ; ARM64-NEXT:    mov w0, w19
 ; ARM64-NEXT:    cmp w0, #0x1
-; ARM64-NEXT:    b.eq 0x6e0 <switch_i32_noreuse+0x30>
+; ARM64-NEXT:    b.eq 0x69c <switch_i32_noreuse+0x2c>
 ; ARM64-NEXT:    cmp w0, #0x2
-; ARM64-NEXT:    b.eq 0x6e4 <switch_i32_noreuse+0x34>
-; ARM64-NEXT:    b 0x6dc <switch_i32_noreuse+0x2c>
-; ARM64-NEXT:    b 0x750 <switch_i32_noreuse+0xa0>
-; ARM64-NEXT:    b 0x6e8 <switch_i32_noreuse+0x38>
-; ARM64-NEXT:    b 0x71c <switch_i32_noreuse+0x6c>
+; ARM64-NEXT:    b.eq 0x6d0 <switch_i32_noreuse+0x60>
+; ARM64-NEXT:    b 0x704 <switch_i32_noreuse+0x94>
 ; ARM64-NEXT:    mov x0, #0x1 // =1
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    ldr x19, [sp, #0x10]
@@ -782,46 +701,40 @@ default:
 
 define i64 @switch_i64_noreuse(i64 %p) {
 ; X64-LABEL: <switch_i64_noreuse>:
-; X64:         460: 55 push rbp
-; X64-NEXT:    461: 48 89 e5 mov rbp, rsp
-; X64-NEXT:    464: 53 push rbx
-; X64-NEXT:    465: 0f 1f 84 00 00 00 00 00 nop dword ptr [rax + rax]
-; X64-NEXT:    46d: 48 81 ec 28 00 00 00 sub rsp, 0x28
-; X64-NEXT:    474: 48 89 fb mov rbx, rdi
-; X64-NEXT:    477: 48 89 d8 mov rax, rbx
-; X64-NEXT:    47a: 48 83 f8 01 cmp rax, 0x1
-; X64-NEXT:    47e: 0f 84 14 00 00 00 je <L0>
-; X64-NEXT:    484: 48 83 f8 02 cmp rax, 0x2
-; X64-NEXT:    488: 0f 84 0f 00 00 00 je <L1>
-; X64-NEXT:    48e: e9 00 00 00 00 jmp <L2>
-; X64-NEXT:  <L2>:
-; X64-NEXT:    493: e9 38 00 00 00 jmp <L3>
+; X64:         3e0: 55 push rbp
+; X64-NEXT:    3e1: 48 89 e5 mov rbp, rsp
+; X64-NEXT:    3e4: 53 push rbx
+; X64-NEXT:    3e5: 0f 1f 84 00 00 00 00 00 nop dword ptr [rax + rax]
+; X64-NEXT:    3ed: 48 81 ec 28 00 00 00 sub rsp, 0x28
+; X64-NEXT:    3f4: 48 89 fb mov rbx, rdi
+; X64-NEXT:    3f7: 48 89 d8 mov rax, rbx
+; X64-NEXT:    3fa: 48 83 f8 01 cmp rax, 0x1
+; X64-NEXT:    3fe: 0f 84 0f 00 00 00 je <L0>
+; X64-NEXT:    404: 48 83 f8 02 cmp rax, 0x2
+; X64-NEXT:    408: 0f 84 1c 00 00 00 je <L1>
+; X64-NEXT:    40e: e9 2e 00 00 00 jmp <L2>
 ; X64-NEXT:  <L0>:
-; X64-NEXT:    498: e9 05 00 00 00 jmp <L4>
+; X64-NEXT:    413: b8 01 00 00 00 mov eax, 0x1
+; X64-NEXT:    418: 48 83 c4 28 add rsp, 0x28
+; X64-NEXT:    41c: 5b pop rbx
+; X64-NEXT:    41d: 5d pop rbp
+; X64-NEXT:    41e: c3 ret
+; X64-NEXT:    41f: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    428: 66 90 nop
 ; X64-NEXT:  <L1>:
-; X64-NEXT:    49d: e9 17 00 00 00 jmp <L5>
-; X64-NEXT:  <L4>:
-; X64-NEXT:    4a2: b8 01 00 00 00 mov eax, 0x1
-; X64-NEXT:    4a7: 48 83 c4 28 add rsp, 0x28
-; X64-NEXT:    4ab: 5b pop rbx
-; X64-NEXT:    4ac: 5d pop rbp
-; X64-NEXT:    4ad: c3 ret
-; X64-NEXT:    4ae: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    4b7: 66 90 nop
-; X64-NEXT:  <L5>:
-; X64-NEXT:    4b9: b8 02 00 00 00 mov eax, 0x2
-; X64-NEXT:    4be: 48 83 c4 28 add rsp, 0x28
-; X64-NEXT:    4c2: 5b pop rbx
-; X64-NEXT:    4c3: 5d pop rbp
-; X64-NEXT:    4c4: c3 ret
-; X64-NEXT:    4c5: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
-; X64-NEXT:    4ce: 66 90 nop
-; X64-NEXT:  <L3>:
-; X64-NEXT:    4d0: 48 89 d8 mov rax, rbx
-; X64-NEXT:    4d3: 48 83 c4 28 add rsp, 0x28
-; X64-NEXT:    4d7: 5b pop rbx
-; X64-NEXT:    4d8: 5d pop rbp
-; X64-NEXT:    4d9: c3 ret
+; X64-NEXT:    42a: b8 02 00 00 00 mov eax, 0x2
+; X64-NEXT:    42f: 48 83 c4 28 add rsp, 0x28
+; X64-NEXT:    433: 5b pop rbx
+; X64-NEXT:    434: 5d pop rbp
+; X64-NEXT:    435: c3 ret
+; X64-NEXT:    436: 66 0f 1f 84 00 00 00 00 00 nop word ptr [rax + rax]
+; X64-NEXT:    43f: 66 90 nop
+; X64-NEXT:  <L2>:
+; X64-NEXT:    441: 48 89 d8 mov rax, rbx
+; X64-NEXT:    444: 48 83 c4 28 add rsp, 0x28
+; X64-NEXT:    448: 5b pop rbx
+; X64-NEXT:    449: 5d pop rbp
+; X64-NEXT:    44a: c3 ret
 ;
 ; ARM64-LABEL: <switch_i64_noreuse>:
 ; ARM64:         sub sp, sp, #0xa0
@@ -831,13 +744,10 @@ define i64 @switch_i64_noreuse(i64 %p) {
 ; ARM64-NEXT:    mov x19, x0
 ; ARM64-NEXT:    mov x0, x19
 ; ARM64-NEXT:    cmp x0, #0x1
-; ARM64-NEXT:    b.eq 0x7c0 <switch_i64_noreuse+0x30>
+; ARM64-NEXT:    b.eq 0x76c <switch_i64_noreuse+0x2c>
 ; ARM64-NEXT:    cmp x0, #0x2
-; ARM64-NEXT:    b.eq 0x7c4 <switch_i64_noreuse+0x34>
-; ARM64-NEXT:    b 0x7bc <switch_i64_noreuse+0x2c>
-; ARM64-NEXT:    b 0x830 <switch_i64_noreuse+0xa0>
-; ARM64-NEXT:    b 0x7c8 <switch_i64_noreuse+0x38>
-; ARM64-NEXT:    b 0x7fc <switch_i64_noreuse+0x6c>
+; ARM64-NEXT:    b.eq 0x7a0 <switch_i64_noreuse+0x60>
+; ARM64-NEXT:    b 0x7d4 <switch_i64_noreuse+0x94>
 ; ARM64-NEXT:    mov x0, #0x1 // =1
 ; ARM64-NEXT:    ldp x29, x30, [sp]
 ; ARM64-NEXT:    ldr x19, [sp, #0x10]
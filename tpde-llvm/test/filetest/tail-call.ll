@@ -0,0 +1,105 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare void @fn_void_void()
+declare i32 @fn_i32_i32(i32)
+declare i32 @fn_i32_9xi32(i32, i32, i32, i32, i32, i32, i32, i32, i32)
+
+define void @tail_void() {
+; X64-LABEL: <tail_void>:
+; X64-NOT:     call
+; X64:         add rsp, 0x30
+; X64-NEXT:    pop rbp
+; X64-NEXT:    nop
+; X64-NEXT:    jmp
+; X64-NEXT:     R_X86_64_PLT32 fn_void_void-0x4
+; X64-NOT:     ret
+; X64-LABEL: <musttail_i32>:
+;
+; ARM64-LABEL: <tail_void>:
+; ARM64-NOT:     bl
+; ARM64:         ldp x29, x30, [sp]
+; ARM64-NEXT:    add sp, sp, #0xa0
+; ARM64-NEXT:    b
+; ARM64:          R_AARCH64_JUMP26 fn_void_void
+; ARM64-NOT:     ret
+; ARM64-LABEL: <musttail_i32>:
+  tail call void @fn_void_void()
+  ret void
+}
+
+define i32 @musttail_i32(i32 %a) {
+; X64-LABEL: <musttail_i32>:
+; X64-NOT:     call
+; X64:         pop rbp
+; X64:         jmp
+; X64-NEXT:     R_X86_64_PLT32 fn_i32_i32-0x4
+; X64-NOT:     ret
+; X64-LABEL: <tail_indirect>:
+;
+; ARM64-LABEL: <musttail_i32>:
+; ARM64-NOT:     bl
+; ARM64:         add sp, sp,
+; ARM64-NEXT:    b
+; ARM64:          R_AARCH64_JUMP26 fn_i32_i32
+; ARM64-NOT:     ret
+; ARM64-LABEL: <tail_indirect>:
+  %r = musttail call i32 @fn_i32_i32(i32 %a)
+  ret i32 %r
+}
+
+define i32 @tail_indirect(ptr %f, i32 %a) {
+; X64-LABEL: <tail_indirect>:
+; X64-NOT:     call
+; X64:         mov r11, qword ptr [rbp
+; X64:         pop rbp
+; X64:         jmp r11
+; X64-NOT:     ret
+; X64-LABEL: <tail_not_ret>:
+;
+; ARM64-LABEL: <tail_indirect>:
+; ARM64-NOT:     blr
+; ARM64:         ldr x16, [x29
+; ARM64:         add sp, sp,
+; ARM64:         br x16
+; ARM64-NOT:     ret
+; ARM64-LABEL: <tail_not_ret>:
+  %r = tail call i32 %f(i32 %a)
+  ret i32 %r
+}
+
+; The result is used, so this is a regular call.
+define i32 @tail_not_ret(i32 %a) {
+; X64-LABEL: <tail_not_ret>:
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 fn_i32_i32-0x4
+; X64:         ret
+;
+; ARM64-LABEL: <tail_not_ret>:
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 fn_i32_i32
+; ARM64:         ret
+  %r = tail call i32 @fn_i32_i32(i32 %a)
+  %s = add i32 %r, 1
+  ret i32 %s
+}
+
+; Stack arguments prevent the tail call.
+define i32 @tail_stack_args(i32 %a) {
+; X64-LABEL: <tail_stack_args>:
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 fn_i32_9xi32-0x4
+; X64:         ret
+;
+; ARM64-LABEL: <tail_stack_args>:
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 fn_i32_9xi32
+; ARM64:         ret
+  %r = tail call i32 @fn_i32_9xi32(i32 %a, i32 %a, i32 %a, i32 %a, i32 %a, i32 %a, i32 %a, i32 %a, i32 %a)
+  ret i32 %r
+}
@@ -0,0 +1,47 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: tpde-llc --target=x86_64 %s | %objdump | FileCheck %s -check-prefixes=X64
+; RUN: tpde-llc --target=aarch64 %s | %objdump | FileCheck %s -check-prefixes=ARM64
+
+declare void @f()
+
+; The freeze takes over the stack slot of its dying operand, so nothing is
+; reloaded or spilled between the calls.
+define i64 @freeze_spilled(i64 %a) {
+; X64-LABEL: <freeze_spilled>:
+; X64:         call
+; X64-NEXT:     R_X86_64_PLT32 f-0x4
+; X64-NEXT:    call
+; X64-NEXT:     R_X86_64_PLT32 f-0x4
+; X64:         ret
+;
+; ARM64-LABEL: <freeze_spilled>:
+; ARM64:         bl
+; ARM64-NEXT:     R_AARCH64_CALL26 f
+; ARM64-NEXT:    bl
+; ARM64-NEXT:     R_AARCH64_CALL26 f
+; ARM64:         ret
+  call void @f()
+  %b = freeze i64 %a
+  call void @f()
+  ret i64 %b
+}
+
+; Casts of a stack variable refer to the same stack slot.
+define i64 @ptrtoint_alloca() {
+; X64-LABEL: <ptrtoint_alloca>:
+; X64:         lea rax, [rbp
+; X64-NOT:     mov
+; X64:         ret
+;
+; ARM64-LABEL: <ptrtoint_alloca>:
+; ARM64:         add x0, x29
+; ARM64-NOT:     mov
+; ARM64:         ret
+  %a = alloca i64
+  %p = ptrtoint ptr %a to i64
+  ret i64 %p
+}
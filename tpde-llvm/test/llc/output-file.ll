@@ -0,0 +1,37 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; The object file is streamed to the output file and must be identical to the
+; one written to stdout.
+
+; RUN: rm -f %t.o
+; RUN: tpde-llc --target=x86_64 -o %t.o < %s
+; RUN: tpde-llc --target=x86_64 < %s > %t.stdout.o
+; RUN: cmp %t.o %t.stdout.o
+; RUN: llvm-readelf -Srs %t.o | FileCheck %s
+; RUN: tpde-llc --target=aarch64 -o %t.o < %s
+; RUN: tpde-llc --target=aarch64 < %s > %t.stdout.o
+; RUN: cmp %t.o %t.stdout.o
+; RUN: llvm-readelf -Srs %t.o | FileCheck %s
+
+; CHECK: Section Headers:
+; CHECK-DAG: .text PROGBITS
+; CHECK-DAG: .data PROGBITS
+; CHECK-DAG: .rela.text RELA
+; CHECK: Relocation section '.rela.text'
+; CHECK: ext_func
+; CHECK: Symbol table '.symtab'
+; CHECK-DAG: FUNC GLOBAL DEFAULT {{[0-9]+}} func
+; CHECK-DAG: OBJECT GLOBAL DEFAULT {{[0-9]+}} var
+; CHECK-DAG: NOTYPE GLOBAL DEFAULT UND ext_func
+
+@var = global i32 1, align 4
+
+declare void @ext_func()
+
+define i32 @func() {
+  call void @ext_func()
+  %v = load i32, ptr @var, align 4
+  ret i32 %v
+}
@@ -0,0 +1,109 @@
+# SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+#
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Run a command, then print the perf map and jitdump file it wrote in a form
+# suitable for FileCheck and remove them. Usage: perf-files.py <cmd> [args...]
+
+import os
+import struct
+import subprocess
+import sys
+
+JIT_CODE_LOAD = 0
+JIT_CODE_DEBUG_INFO = 2
+JIT_CODE_CLOSE = 3
+
+
+def cstr(data, off):
+    end = data.index(b"\0", off)
+    return data[off:end].decode(), end + 1
+
+
+def print_map(path):
+    with open(path) as f:
+        for line in f:
+            print("map:", line.rstrip("\n"))
+
+
+def print_dump(path, pid):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, size, mach, _, hdr_pid, _, flags = struct.unpack_from(
+        "<IIIIIIQQ", data, 0)
+    print(f"header: magic={magic:#x} version={version} size={size} "
+          f"mach={mach} pid_ok={int(hdr_pid == pid)} flags={flags}")
+
+    off = size
+    last_ts = 0
+    debug = None
+    while off < len(data):
+        rec_id, rec_size, ts = struct.unpack_from("<IIQ", data, off)
+        if rec_size < 16 or off + rec_size > len(data):
+            print(f"record: truncated id={rec_id}")
+            return
+        body = data[off + 16:off + rec_size]
+        off += rec_size
+        ts_ok = int(ts >= last_ts)
+        last_ts = ts
+
+        if rec_id == JIT_CODE_DEBUG_INFO:
+            addr, count = struct.unpack_from("<QQ", body, 0)
+            entries = []
+            pos = 16
+            for _ in range(count):
+                e_addr, line, disc = struct.unpack_from("<QII", body, pos)
+                name, pos = cstr(body, pos + 16)
+                entries.append((e_addr, line, disc, name))
+            print(f"record: JIT_CODE_DEBUG_INFO entries={count} "
+                  f"size_ok={int(pos == len(body))} ts_ok={ts_ok}")
+            debug = (addr, entries)
+        elif rec_id == JIT_CODE_LOAD:
+            r_pid, _, vma, code_addr, code_size, index = struct.unpack_from(
+                "<IIQQQQ", body, 0)
+            name, pos = cstr(body, 40)
+            print(f"record: JIT_CODE_LOAD name={name} index={index} "
+                  f"pid_ok={int(r_pid == pid)} vma_ok={int(vma == code_addr)} "
+                  f"size_ok={int(len(body) - pos == code_size)} ts_ok={ts_ok}")
+            # The debug info record for a function precedes its load record.
+            if debug:
+                if debug[0] != code_addr:
+                    print("debug: addr mismatch")
+                for e_addr, line, disc, file in debug[1]:
+                    in_code = code_addr <= e_addr <= code_addr + code_size
+                    print(f"debug: line={line} disc={disc} file={file} "
+                          f"in_code={int(in_code)}")
+            debug = None
+        elif rec_id == JIT_CODE_CLOSE:
+            print(f"record: JIT_CODE_CLOSE ts_ok={ts_ok}")
+        else:
+            print(f"record: id={rec_id}")
+
+
+def main():
+    # Without a shell in between, the pid is the one used in the file names.
+    proc = subprocess.Popen(sys.argv[1:], stdout=subprocess.PIPE, text=True)
+    out, _ = proc.communicate()
+    sys.stdout.write(out)
+
+    map_path = f"/tmp/perf-{proc.pid}.map"
+    dump_path = f"/tmp/jit-{proc.pid}.dump"
+    try:
+        if os.path.exists(map_path):
+            print_map(map_path)
+        else:
+            print("no perf map")
+        if os.path.exists(dump_path):
+            print_dump(dump_path, proc.pid)
+        else:
+            print("no jitdump")
+    finally:
+        for path in (map_path, dump_path):
+            if os.path.exists(path):
+                os.remove(path)
+    return proc.returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,76 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; main writes the object file registered for gdb through
+; __jit_debug_descriptor to stdout and the addresses of add and main to
+; stderr. The object must place the sections at the mapped addresses, so that
+; the copied symbol table yields the addresses the code runs at.
+
+; RUN: tpde-lli --gdb-jit %s > %t.o 2> %t.addr
+; RUN: llvm-readelf -h -S -s %t.o > %t.elf
+; RUN: llvm-dwarfdump --debug-aranges %t.o > %t.dwarf
+; RUN: cat %t.addr %t.elf %t.dwarf | FileCheck %s
+
+; CHECK: add=[[#%x,ADD:]] main=[[#%x,MAIN:]]
+; CHECK: Type: REL (Relocatable file)
+
+; CHECK-DAG: [{{ *}}[[TEXT_IDX:[0-9]+]]] .text NOBITS [[#%.16x,TEXT:]]
+; CHECK-DAG: ] .eh_frame PROGBITS {{0*[1-9a-f][0-9a-f]*}}
+; CHECK-DAG: ] .debug_info PROGBITS 0000000000000000
+; CHECK-DAG: ] .debug_line PROGBITS 0000000000000000
+; CHECK-DAG: ] .debug_aranges PROGBITS 0000000000000000
+; CHECK-DAG: ] .symtab SYMTAB
+; CHECK-DAG: ] .strtab STRTAB
+; CHECK-DAG: ] .shstrtab STRTAB
+
+; CHECK: Symbol table '.symtab'
+; CHECK-DAG: : [[#%.16x,ADD - TEXT]] {{ *}}[[#]] FUNC LOCAL DEFAULT [[TEXT_IDX]] add
+; CHECK-DAG: : [[#%.16x,MAIN - TEXT]] {{ *}}[[#]] FUNC GLOBAL DEFAULT [[TEXT_IDX]] main
+
+; The relocations of the debug sections are applied with mapped addresses.
+; CHECK: .debug_aranges contents:
+; CHECK: [0x{{0*[1-9a-f][0-9a-f]*}}, 0x
+
+%jit_code_entry = type { ptr, ptr, ptr, i64 }
+%jit_descriptor = type { i32, i32, ptr, ptr }
+
+@__jit_debug_descriptor = external global %jit_descriptor
+@stdout = external global ptr
+@stderr = external global ptr
+@fmt = private constant [18 x i8] c"add=%lx main=%lx\0A\00", align 1
+
+declare i64 @fwrite(ptr, i64, i64, ptr)
+declare i32 @fprintf(ptr, ptr, ...)
+
+define internal i32 @add(i32 %a, i32 %b) !dbg !5 {
+  %r = add i32 %a, %b, !dbg !8
+  ret i32 %r, !dbg !9
+}
+
+define i32 @main() {
+  %first = getelementptr %jit_descriptor, ptr @__jit_debug_descriptor, i64 0, i32 3
+  %entry = load ptr, ptr %first
+  %addr_ptr = getelementptr %jit_code_entry, ptr %entry, i64 0, i32 2
+  %addr = load ptr, ptr %addr_ptr
+  %size_ptr = getelementptr %jit_code_entry, ptr %entry, i64 0, i32 3
+  %size = load i64, ptr %size_ptr
+  %out = load ptr, ptr @stdout
+  %w = call i64 @fwrite(ptr %addr, i64 1, i64 %size, ptr %out)
+  %err = load ptr, ptr @stderr
+  %p = call i32 (ptr, ptr, ...) @fprintf(ptr %err, ptr @fmt, ptr @add, ptr @main)
+  ret i32 0
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C11, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!1 = !DIFile(filename: "gdb-jit.c", directory: "/src")
+!3 = !{i32 7, !"Dwarf Version", i32 5}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = distinct !DISubprogram(name: "add", scope: !1, file: !1, line: 1, type: !6, scopeLine: 1, spFlags: DISPFlagDefinition, unit: !0)
+!6 = !DISubroutineType(types: !7)
+!7 = !{}
+!8 = !DILocation(line: 2, column: 3, scope: !5)
+!9 = !DILocation(line: 3, column: 1, scope: !5)
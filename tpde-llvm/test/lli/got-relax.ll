@@ -0,0 +1,37 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; Accesses to globals that are not dso_local go through the GOT. The mapper
+; relaxes these for symbols in the same mapping, external symbols like
+; stdout may still need a GOT slot.
+
+; RUN: tpde-lli %s | FileCheck %s
+
+@fmt = private constant [8 x i8] c"%d %d\0A\00", align 1
+@stdout = external global ptr, align 8
+@counter = global i32 41, align 4
+@self = global ptr @self, align 8
+
+define void @inc() {
+  %v = load i32, ptr @counter, align 4
+  %n = add i32 %v, 1
+  store i32 %n, ptr @counter, align 4
+  ret void
+}
+
+define i32 @main() {
+; CHECK: 42 1
+  call void @inc()
+  %v = load i32, ptr @counter, align 4
+  %self = load ptr, ptr @self, align 8
+  %self_eq = icmp eq ptr %self, @self
+  %self_ext = zext i1 %self_eq to i32
+  %p = call i32 (ptr, ...) @printf(ptr @fmt, i32 %v, i32 %self_ext)
+  %stdout = load ptr, ptr @stdout, align 8
+  %f = call i32 @fflush(ptr %stdout)
+  ret i32 0
+}
+
+declare i32 @printf(ptr, ...)
+declare i32 @fflush(ptr)
@@ -0,0 +1,63 @@
+; NOTE: Do not autogenerate
+; SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; perf-files.py runs tpde-lli, decodes the perf map and jitdump it wrote, and
+; removes them from /tmp afterwards.
+
+; RUN: python3 %S/Inputs/perf-files.py tpde-lli --perf-map %s \
+; RUN:   | FileCheck %s -check-prefixes=CHECK,MAP,NODUMP
+; RUN: python3 %S/Inputs/perf-files.py tpde-lli --jitdump %s \
+; RUN:   | FileCheck %s -check-prefixes=CHECK,NOMAP,DUMP
+; RUN: python3 %S/Inputs/perf-files.py tpde-lli --perf-map --jitdump %s \
+; RUN:   | FileCheck %s -check-prefixes=CHECK,MAP,DUMP
+
+; CHECK: 42
+
+; Perf map lines are "<addr> <size> <name>" in hex, local symbols first.
+; MAP: map: {{[0-9a-f]+ [0-9a-f]+ add$}}
+; MAP-NEXT: map: {{[0-9a-f]+ [0-9a-f]+ main$}}
+; MAP-NOT: map:
+; NOMAP: no perf map
+
+; add has line info, so its JIT_CODE_LOAD is preceded by JIT_CODE_DEBUG_INFO
+; with entries inside its code. main has no line info.
+; DUMP: header: magic=0x4a695444 version=1 size=40 mach={{62|183}} pid_ok=1 flags=0
+; DUMP-NEXT: record: JIT_CODE_DEBUG_INFO entries={{[1-9][0-9]*}} size_ok=1 ts_ok=1
+; DUMP-NEXT: record: JIT_CODE_LOAD name=add index=0 pid_ok=1 vma_ok=1 size_ok=1 ts_ok=1
+; DUMP-NOT: {{in_code=0|mismatch}}
+; DUMP: debug: line=2 disc=0 file=/src/perf.c in_code=1
+; DUMP-NOT: {{in_code=0|mismatch}}
+; DUMP: debug: line=3 disc=0 file=/src/perf.c in_code=1
+; DUMP-NOT: {{in_code=0|mismatch}}
+; DUMP: record: JIT_CODE_LOAD name=main index=1 pid_ok=1 vma_ok=1 size_ok=1 ts_ok=1
+; DUMP-NEXT: record: JIT_CODE_CLOSE ts_ok=1
+; NODUMP: no jitdump
+
+@fmt = private constant [4 x i8] c"%d\0A\00", align 1
+
+declare i32 @printf(ptr, ...)
+
+define internal i32 @add(i32 %a, i32 %b) !dbg !5 {
+  %r = add i32 %a, %b, !dbg !8
+  ret i32 %r, !dbg !9
+}
+
+define i32 @main() {
+  %v = call i32 @add(i32 40, i32 2)
+  %p = call i32 (ptr, ...) @printf(ptr @fmt, i32 %v)
+  ret i32 0
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C11, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!1 = !DIFile(filename: "perf.c", directory: "/src")
+!3 = !{i32 7, !"Dwarf Version", i32 5}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+!5 = distinct !DISubprogram(name: "add", scope: !1, file: !1, line: 1, type: !6, scopeLine: 1, spFlags: DISPFlagDefinition, unit: !0)
+!6 = !DISubroutineType(types: !7)
+!7 = !{}
+!8 = !DILocation(line: 2, column: 3, scope: !5)
+!9 = !DILocation(line: 3, column: 1, scope: !5)
@@ -13,10 +13,14 @@
 
 #include "tpde-llvm/LLVMCompiler.hpp"
 
+#include <cerrno>
 #include <cstdlib>
-#include <fstream>
+#include <fcntl.h>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <span>
+#include <unistd.h>
 
 #ifdef TPDE_LOGGING
   #include <spdlog/spdlog.h>
@@ -40,6 +44,58 @@ int main(int argc, char *argv[]) {
   args::Flag regular_exit(
       parser, "regular_exit", "Exit regularly (no _Exit)", {"regular-exit"});
 
+  args::Flag split_cold(parser,
+                        "split_cold",
+                        "Emit cold blocks into a separate section",
+                        {"split-cold"});
+
+  args::Flag dead_code(parser,
+                       "eliminate_dead_code",
+                       "Skip side-effect-free instructions with unused results",
+                       {"eliminate-dead-code"});
+
+  args::Flag fold_constants(parser,
+                            "fold_constants",
+                            "Fold instructions with only constant operands",
+                            {"fold-constants"});
+
+  args::Flag elide_ext(parser,
+                       "elide_redundant_ext",
+                       "Omit zero-extensions of already zero-extended values",
+                       {"elide-redundant-ext"});
+
+  args::Flag line_table(parser,
+                        "line_table",
+                        "Emit a line table from the debug locations",
+                        {'g', "line-table"});
+
+  args::Flag shared(parser,
+                    "shared",
+                    "Link the module into a shared object",
+                    {"shared"});
+
+  args::Flag exe(parser,
+                 "exe",
+                 "Link the module into a position-independent executable",
+                 {"exe"});
+
+  args::ValueFlag<std::string> entry(
+      parser, "entry", "Entry symbol of the executable", {"entry"});
+
+  args::ValueFlag<std::string> interp(parser,
+                                      "dynamic_linker",
+                                      "Program interpreter of the executable",
+                                      {"dynamic-linker"});
+
+  args::ValueFlag<std::string> soname(
+      parser, "soname", "DT_SONAME of the shared object", {"soname"});
+
+  args::ValueFlagList<std::string> needed(
+      parser,
+      "needed",
+      "Library the shared object depends on, e.g. libc.so.6",
+      {"needed"});
+
   args::ValueFlag<std::string> target(
       parser, "target", "Target architecture", {"target"}, args::Options::None);
 
@@ -127,21 +183,101 @@ int main(int argc, char *argv[]) {
     std::cerr << "Unknown architecture: " << triple_str << "\n";
     return 1;
   }
+  if (split_cold) {
+    compiler->set_split_cold_code(true);
+  }
+  if (dead_code) {
+    compiler->set_eliminate_dead_code(true);
+  }
+  if (fold_constants) {
+    compiler->set_fold_constants(true);
+  }
+  if (elide_ext) {
+    compiler->set_elide_redundant_ext(true);
+  }
+  if (line_table) {
+    compiler->set_emit_line_table(true);
+  }
 
+  tpde_llvm::LinkOptions link_options;
+  if (soname) {
+    link_options.soname = soname.Get();
+  }
+  link_options.needed = needed.Get();
+  if (entry) {
+    link_options.entry = entry.Get();
+  }
+  if (interp) {
+    link_options.interp = interp.Get();
+  }
+  const auto compile = [&](std::function<bool(std::span<const uint8_t>)> out) {
+    if (exe) {
+      return compiler->compile_to_executable(
+          *mod, link_options, std::move(out));
+    }
+    if (shared) {
+      return compiler->compile_to_shared(*mod, link_options, std::move(out));
+    }
+    return compiler->compile_to_elf(*mod, std::move(out));
+  };
+
+  // The object file is written while it is emitted; the output file is only
+  // created once compilation succeeded.
+  int out_fd = -1;
+#ifndef NDEBUG
   std::vector<uint8_t> buf;
+#endif
+  const auto write_out = [&](std::span<const uint8_t> data) {
+    if (out_fd < 0) {
+      if (obj_out_path.Get() == "-") {
+        llvm::outs().flush();
+        out_fd = STDOUT_FILENO;
+      } else {
+        out_fd = ::open(obj_out_path.Get().c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                        0666);
+        if (out_fd < 0) {
+          std::cerr << "Failed to open " << obj_out_path.Get() << "\n";
+          return false;
+        }
+      }
+    }
+#ifndef NDEBUG
+    buf.insert(buf.end(), data.begin(), data.end());
+#endif
+    while (!data.empty()) {
+      ssize_t res = ::write(out_fd, data.data(), data.size());
+      if (res < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "Failed to write output\n";
+        return false;
+      }
+      data = data.subspan(res);
+    }
+    return true;
+  };
+
   {
     llvm::TimeTraceScope time_scope("Compile");
-    if (!compiler->compile_to_elf(*mod, buf)) {
+    if (!compile(write_out)) {
       std::cerr << "Failed to compile\n";
       return 1;
     }
   }
+  if (out_fd >= 0 && out_fd != STDOUT_FILENO) {
+    ::close(out_fd);
+  }
 
 #ifndef NDEBUG
   // In debug builds, assert that compiling the module a second time in the same
   // compiler instance yields the same result.
   std::vector<uint8_t> buf2;
-  if (!compiler->compile_to_elf(*mod, buf2)) {
+  if (!compile([&buf2](std::span<const uint8_t> data) {
+        buf2.insert(buf2.end(), data.begin(), data.end());
+        return true;
+      })) {
     assert(false && "second compilation failed");
   }
   if (buf.size() != buf2.size() ||
@@ -152,14 +288,6 @@ int main(int argc, char *argv[]) {
   }
 #endif
 
-  if (obj_out_path.Get() == "-") {
-    std::cout.write(reinterpret_cast<const char *>(buf.data()), buf.size());
-    std::cout << std::flush;
-  } else {
-    std::ofstream out{obj_out_path.Get().c_str(), std::ios::binary};
-    out.write(reinterpret_cast<const char *>(buf.data()), buf.size());
-  }
-
   if (time_trace) {
     if (auto err = llvm::timeTraceProfilerWrite(time_trace.Get(),
                                                 obj_out_path.Get())) {
@@ -52,6 +52,19 @@ int main(int argc, char *argv[]) {
       2);
 
   args::Flag orc(parser, "orc", "Use LLVM ORC", {"orc"});
+  args::Flag perf_map(parser,
+                      "perf_map",
+                      "Record JIT-compiled functions in /tmp/perf-<pid>.map",
+                      {"perf-map"});
+  args::Flag jitdump(parser,
+                     "jitdump",
+                     "Record JIT-compiled functions with line numbers in "
+                     "/tmp/jit-<pid>.dump",
+                     {"jitdump"});
+  args::Flag gdb_jit(parser,
+                     "gdb_jit",
+                     "Register JIT-compiled code with the GDB JIT interface",
+                     {"gdb-jit"});
 
   args::Positional<std::string> ir_path(
       parser, "ir_path", "Path to the input IR file", "-");
@@ -110,6 +123,12 @@ int main(int argc, char *argv[]) {
   }
 
   if (!orc) {
+    compiler->set_perf_map(perf_map);
+    compiler->set_jitdump(jitdump);
+    compiler->set_gdb_jit(gdb_jit);
+    if (jitdump || gdb_jit) {
+      compiler->set_emit_line_table(true);
+    }
     auto mapper = compiler->compile_and_map(*mod, [](std::string_view name) {
       return ::dlsym(RTLD_DEFAULT, std::string(name).c_str());
     });
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <format>
 #include <ostream>
 
@@ -28,6 +29,9 @@ struct Analyzer {
 
   static constexpr size_t SMALL_BLOCK_NUM = 64;
   static constexpr size_t SMALL_VALUE_NUM = 128;
+  /// Minimum loop nesting depth for which the liveness analysis uses
+  /// constant-time LCA queries on the loop tree. Shallower trees are walked.
+  static constexpr u32 LOOP_LCA_MIN_LEVEL = 16;
 
   /// Reference to the adaptor
   Adaptor *adaptor;
@@ -40,6 +44,10 @@ struct Analyzer {
   /// The block layout, a BlockIndex is an index into this array
   util::SmallVector<IRBlockRef, SMALL_BLOCK_NUM> block_layout = {};
 
+  /// Index of the first cold block, all following blocks in the layout are
+  /// also cold. Equal to the number of blocks if there are no cold blocks.
+  BlockIndex cold_block_begin = INVALID_BLOCK_IDX;
+
   /// For each BlockIndex, the corresponding loop
   // TODO(ts): add the delayed free list in here to save on allocations?
   util::SmallVector<u32, SMALL_BLOCK_NUM> block_loop_map = {};
@@ -59,6 +67,16 @@ struct Analyzer {
 
   util::SmallVector<Loop, 16> loops = {};
 
+  /// Euler tour of the loop tree, only built if the loop tree is deeper than
+  /// LOOP_LCA_MIN_LEVEL.
+  util::SmallVector<u32, 16> loop_euler = {};
+  /// For each loop, the index of its first occurrence in loop_euler.
+  util::SmallVector<u32, 16> loop_euler_first = {};
+  /// Sparse tables for range-minimum queries of the loop level over
+  /// loop_euler. Entry k * loop_euler.size() + i holds the position of the
+  /// leftmost/rightmost minimum in [i, i + 2^k[.
+  util::SmallVector<u32, 16> loop_rmq_first = {}, loop_rmq_last = {};
+
   // TODO(ts): move all struct definitions to the top?
   struct LivenessInfo {
     // [first, last]
@@ -86,6 +104,15 @@ struct Analyzer {
 
   u32 num_insts;
 
+  /// Whether pure instructions with unused results are skipped. Only has an
+  /// effect if the adaptor provides TPDE_PROVIDES_PURE_INSTS.
+  bool eliminate_dead_insts = false;
+  /// Local indices of the results of dead instructions, only valid if
+  /// has_dead_insts is set.
+  util::SmallBitSet<256> dead_values = {};
+  /// Whether the current function has pure instructions with unused results.
+  bool has_dead_insts = false;
+
   explicit Analyzer(Adaptor *adaptor) : adaptor(adaptor) {}
 
   /// Start the compilation of a new function and build the loop tree and
@@ -93,10 +120,11 @@ struct Analyzer {
   void switch_func(IRFuncRef func);
 
   IRBlockRef block_ref(const BlockIndex idx) const noexcept {
-    assert(static_cast<u32>(idx) <= block_layout.size());
-    if (static_cast<u32>(idx) == block_layout.size()) {
+    assert(static_cast<u32>(idx) <= block_layout.size() ||
+           idx == INVALID_BLOCK_IDX);
+    if (static_cast<u32>(idx) >= block_layout.size()) {
       // this might be called with next_block() which is invalid for the
-      // last block
+      // last block or before the cold part of a function
       return INVALID_BLOCK_REF;
     }
     return block_layout[static_cast<u32>(idx)];
@@ -113,6 +141,22 @@ struct Analyzer {
     return liveness[static_cast<u32>(val_idx)];
   }
 
+  /// Whether the instruction is free of side effects and none of its results
+  /// are used, so that it does not need to be compiled. Operands of dead
+  /// instructions are not counted as references.
+  bool inst_dead(const IRInstRef inst) const noexcept {
+    if constexpr (ProvidesPureInsts<Adaptor>) {
+      if (has_dead_insts) {
+        auto &&results = adaptor->inst_results(inst);
+        if (auto it = results.begin(); it != results.end()) {
+          const auto idx = static_cast<u32>(adaptor->val_local_idx(*it));
+          return idx < dead_values.bit_size && dead_values.is_set(idx);
+        }
+      }
+    }
+    return false;
+  }
+
   u32 block_loop_idx(const BlockIndex idx) const noexcept {
     return block_loop_map[static_cast<u32>(idx)];
   }
@@ -151,6 +195,10 @@ protected:
       const util::SmallVector<u32, SMALL_BLOCK_NUM> &loop_parent,
       const util::SmallBitSet<256> &loop_heads);
 
+  /// Move cold blocks, which never branch back to hot blocks, to the end of
+  /// the block layout.
+  void sink_cold_blocks() noexcept;
+
   /// Builds a vector of block references in reverse post-order.
   void build_rpo_block_order(
       util::SmallVector<IRBlockRef, SMALL_BLOCK_NUM> &out) const noexcept;
@@ -162,7 +210,29 @@ protected:
       util::SmallVector<u32, SMALL_BLOCK_NUM> &loop_parent,
       util::SmallBitSet<256> &loop_heads) const noexcept;
 
+  /// Prepare constant-time LCA queries on the loop tree if the tree is deep
+  /// enough for this to pay off.
+  void build_loop_lca() noexcept;
+
+  struct LoopLCA {
+    u32 lca;
+    /// Child of lca containing lhs/rhs, or lhs/rhs if it is the lca.
+    u32 lhs_child, rhs_child;
+  };
+
+  /// Find the lowest common ancestor of two loops in the loop tree.
+  LoopLCA loop_lca(u32 lhs, u32 rhs) const noexcept;
+
   void compute_liveness() noexcept;
+
+  /// Visit all values of the function to compute liveness intervals and
+  /// reference counts, skipping dead instructions.
+  void visit_liveness() noexcept;
+
+  /// Mark pure instructions without uses as dead and remove their operands'
+  /// references, so that chains of dead instructions are removed entirely.
+  /// Returns whether any instruction was found to be dead.
+  bool find_dead_insts() noexcept;
 };
 
 template <IRAdaptor Adaptor>
@@ -265,6 +335,11 @@ void Analyzer<Adaptor>::build_block_layout() {
   loop_heads.mark_set(0);
 
   build_loop_tree_and_block_layout(block_rpo, loop_parent, loop_heads);
+  cold_block_begin = static_cast<BlockIndex>(block_layout.size());
+  if constexpr (ProvidesBlockHints<Adaptor>) {
+    sink_cold_blocks();
+  }
+  build_loop_lca();
 }
 
 template <IRAdaptor Adaptor>
@@ -399,6 +474,118 @@ void Analyzer<Adaptor>::build_loop_tree_and_block_layout(
   assert(static_cast<u32>(loops[0].end) == block_rpo.size());
 }
 
+template <IRAdaptor Adaptor>
+void Analyzer<Adaptor>::sink_cold_blocks() noexcept {
+  const u32 num_blocks = block_layout.size();
+
+  // Predecessors of each block, indexed by the position in the layout.
+  util::SmallVector<u32, SMALL_BLOCK_NUM> pred_start{};
+  util::SmallVector<u32, SMALL_BLOCK_NUM> preds{};
+  pred_start.resize(num_blocks + 1, 0);
+  for (u32 i = 0; i < num_blocks; ++i) {
+    for (const IRBlockRef succ : adaptor->block_succs(block_layout[i])) {
+      ++pred_start[adaptor->block_info(succ) + 1];
+    }
+  }
+  for (u32 i = 1; i <= num_blocks; ++i) {
+    pred_start[i] += pred_start[i - 1];
+  }
+  preds.resize_uninitialized(pred_start[num_blocks]);
+  for (u32 i = 0; i < num_blocks; ++i) {
+    for (const IRBlockRef succ : adaptor->block_succs(block_layout[i])) {
+      preds[pred_start[adaptor->block_info(succ)]++] = i;
+    }
+  }
+  for (u32 i = num_blocks; i > 0; --i) {
+    pred_start[i] = pred_start[i - 1];
+  }
+  pred_start[0] = 0;
+
+  // Blocks which are only reachable from cold blocks are cold as well. Blocks
+  // reachable through a back edge are conservatively treated as hot.
+  util::SmallVector<u8, SMALL_BLOCK_NUM> cold{};
+  cold.resize(num_blocks, 0);
+  util::SmallVector<u32, SMALL_BLOCK_NUM> worklist{};
+  for (u32 i = 1; i < num_blocks; ++i) {
+    bool is_cold = adaptor->block_is_cold(block_layout[i]);
+    if (!is_cold && pred_start[i] != pred_start[i + 1]) {
+      is_cold = std::all_of(preds.begin() + pred_start[i],
+                            preds.begin() + pred_start[i + 1],
+                            [&](u32 pred) { return pred < i && cold[pred]; });
+    }
+    cold[i] = is_cold;
+  }
+
+  // Only move cold blocks which never branch to hot blocks. Such blocks can't
+  // dominate hot blocks, and every loop is either entirely hot or entirely
+  // cold, so uses stay behind definitions and loops stay contiguous.
+  u32 num_cold = 0;
+  for (u32 i = 1; i < num_blocks; ++i) {
+    if (!cold[i]) {
+      continue;
+    }
+    ++num_cold;
+    for (const IRBlockRef succ : adaptor->block_succs(block_layout[i])) {
+      if (!cold[adaptor->block_info(succ)]) {
+        worklist.push_back(i);
+        break;
+      }
+    }
+  }
+  while (!worklist.empty()) {
+    const u32 idx = worklist.back();
+    worklist.pop_back();
+    if (!cold[idx]) {
+      continue;
+    }
+    cold[idx] = false;
+    --num_cold;
+    for (u32 j = pred_start[idx]; j < pred_start[idx + 1]; ++j) {
+      if (cold[preds[j]]) {
+        worklist.push_back(preds[j]);
+      }
+    }
+  }
+
+  if (num_cold == 0) {
+    return;
+  }
+
+  // Stable partition of the layout into hot and cold blocks. Reuse preds for
+  // the new position of each block.
+  preds.resize_uninitialized(num_blocks);
+  u32 hot_idx = 0, cold_idx = num_blocks - num_cold;
+  for (u32 i = 0; i < num_blocks; ++i) {
+    preds[i] = cold[i] ? cold_idx++ : hot_idx++;
+  }
+
+  util::SmallVector<IRBlockRef, SMALL_BLOCK_NUM> old_layout{};
+  util::SmallVector<u32, SMALL_BLOCK_NUM> old_loop_map{};
+  old_layout.resize_uninitialized(num_blocks);
+  old_loop_map.resize_uninitialized(num_blocks);
+  std::copy(block_layout.begin(), block_layout.end(), old_layout.begin());
+  std::copy(block_loop_map.begin(), block_loop_map.end(), old_loop_map.begin());
+  for (u32 i = 0; i < num_blocks; ++i) {
+    block_layout[preds[i]] = old_layout[i];
+    block_loop_map[preds[i]] = old_loop_map[i];
+    adaptor->block_set_info(old_layout[i], preds[i]);
+  }
+
+  for (u32 i = 1; i < loops.size(); ++i) {
+    Loop &loop = loops[i];
+    const u32 begin = static_cast<u32>(loop.begin);
+    const u32 end = static_cast<u32>(loop.end);
+    assert(std::all_of(cold.begin() + begin,
+                       cold.begin() + end,
+                       [&](u8 c) { return c == cold[begin]; }));
+    loop.begin = static_cast<BlockIndex>(preds[begin]);
+    loop.end = static_cast<BlockIndex>(preds[end - 1] + 1);
+  }
+
+  cold_block_begin = static_cast<BlockIndex>(num_blocks - num_cold);
+  TPDE_LOG_TRACE("Moved {} cold blocks to the end", num_cold);
+}
+
 template <IRAdaptor Adaptor>
 void Analyzer<Adaptor>::build_rpo_block_order(
     util::SmallVector<IRBlockRef, SMALL_BLOCK_NUM> &out) const noexcept {
@@ -507,17 +694,26 @@ void Analyzer<Adaptor>::build_rpo_block_order(
           adaptor->block_info(stack[start_idx + 1])) {
         std::swap(stack[start_idx], stack[start_idx + 1]);
       }
-      continue;
+    } else {
+      std::sort(stack.begin() + start_idx,
+                stack.end(),
+                [this](const IRBlockRef lhs, const IRBlockRef rhs) {
+                  // note(ts): this may have not so nice performance
+                  // characteristics if the block lookup is a hashmap so
+                  // maybe cache this for larger lists?
+                  return adaptor->block_info(lhs) < adaptor->block_info(rhs);
+                });
     }
 
-    std::sort(stack.begin() + start_idx,
-              stack.end(),
-              [this](const IRBlockRef lhs, const IRBlockRef rhs) {
-                // note(ts): this may have not so nice performance
-                // characteristics if the block lookup is a hashmap so
-                // maybe cache this for larger lists?
-                return adaptor->block_info(lhs) < adaptor->block_info(rhs);
-              });
+    if constexpr (ProvidesBlockHints<Adaptor>) {
+      // The child that is visited last is placed immediately after the block
+      // in the RPO, so move the likely successor to the bottom.
+      const IRBlockRef likely = adaptor->block_likely_succ(cur_node);
+      if (likely != INVALID_BLOCK_REF) {
+        auto it = std::find(stack.begin() + start_idx, stack.end(), likely);
+        std::rotate(stack.begin() + start_idx, it, it + (it != stack.end()));
+      }
+    }
   }
 
   if (rpo_idx != 0xFFFF'FFFF) {
@@ -717,6 +913,132 @@ void Analyzer<Adaptor>::identify_loops(
   }
 }
 
+template <IRAdaptor Adaptor>
+void Analyzer<Adaptor>::build_loop_lca() noexcept {
+  loop_euler.clear();
+
+  u32 max_level = 0;
+  for (const Loop &loop : loops) {
+    max_level = std::max(max_level, loop.level);
+  }
+  if (max_level < LOOP_LCA_MIN_LEVEL) {
+    return;
+  }
+
+  // Children of each loop, parents always have a lower index than children.
+  const u32 num_loops = loops.size();
+  util::SmallVector<u32, 16> child_start{};
+  util::SmallVector<u32, 16> children{};
+  child_start.resize(num_loops + 1, 0);
+  children.resize_uninitialized(num_loops);
+  for (u32 i = 1; i < num_loops; ++i) {
+    ++child_start[loops[i].parent + 1];
+  }
+  for (u32 i = 1; i <= num_loops; ++i) {
+    child_start[i] += child_start[i - 1];
+  }
+  for (u32 i = 1; i < num_loops; ++i) {
+    children[child_start[loops[i].parent]++] = i;
+  }
+  for (u32 i = num_loops; i > 0; --i) {
+    child_start[i] = child_start[i - 1];
+  }
+  child_start[0] = 0;
+
+  // Euler tour: every loop is visited on entry and after each child.
+  loop_euler_first.resize_uninitialized(num_loops);
+  util::SmallVector<std::pair<u32, u32>, 16> stack{};
+  loop_euler_first[0] = 0;
+  loop_euler.push_back(0);
+  stack.emplace_back(0, child_start[0]);
+  while (!stack.empty()) {
+    auto &[loop_idx, next] = stack.back();
+    if (next == child_start[loop_idx + 1]) {
+      stack.pop_back();
+      if (!stack.empty()) {
+        loop_euler.push_back(stack.back().first);
+      }
+      continue;
+    }
+    const u32 child = children[next++];
+    loop_euler_first[child] = loop_euler.size();
+    loop_euler.push_back(child);
+    stack.emplace_back(child, child_start[child]);
+  }
+
+  const u32 n = loop_euler.size();
+  const u32 num_levels = std::bit_width(n);
+  loop_rmq_first.resize_uninitialized(num_levels * n);
+  loop_rmq_last.resize_uninitialized(num_levels * n);
+  for (u32 i = 0; i < n; ++i) {
+    loop_rmq_first[i] = loop_rmq_last[i] = i;
+  }
+  const auto level = [this](u32 pos) { return loops[loop_euler[pos]].level; };
+  for (u32 k = 1; k < num_levels; ++k) {
+    const u32 half = 1u << (k - 1);
+    for (u32 i = 0; i + (1u << k) <= n; ++i) {
+      u32 a = loop_rmq_first[(k - 1) * n + i];
+      u32 b = loop_rmq_first[(k - 1) * n + i + half];
+      loop_rmq_first[k * n + i] = level(b) < level(a) ? b : a;
+      a = loop_rmq_last[(k - 1) * n + i];
+      b = loop_rmq_last[(k - 1) * n + i + half];
+      loop_rmq_last[k * n + i] = level(a) < level(b) ? a : b;
+    }
+  }
+}
+
+template <IRAdaptor Adaptor>
+typename Analyzer<Adaptor>::LoopLCA
+    Analyzer<Adaptor>::loop_lca(u32 lhs, u32 rhs) const noexcept {
+  if (loop_euler.empty()) {
+    // Shallow loop tree, walk up to the common loop.
+    u32 prev_lhs = lhs, prev_rhs = rhs;
+    while (lhs != rhs) {
+      const auto lhs_level = loops[lhs].level;
+      const auto rhs_level = loops[rhs].level;
+      if (lhs_level > rhs_level) {
+        prev_lhs = lhs;
+        lhs = loops[lhs].parent;
+      } else if (lhs_level < rhs_level) {
+        prev_rhs = rhs;
+        rhs = loops[rhs].parent;
+      } else {
+        prev_lhs = lhs;
+        prev_rhs = rhs;
+        lhs = loops[lhs].parent;
+        rhs = loops[rhs].parent;
+      }
+    }
+    return LoopLCA{lhs, prev_lhs, prev_rhs};
+  }
+
+  // The LCA is the loop with the lowest level in the Euler tour between the
+  // first occurrences of both loops. Before its first occurrence in that
+  // range, the tour returns from the child containing the left loop; after its
+  // last occurrence, the tour enters the child containing the right loop.
+  u32 l = loop_euler_first[lhs], r = loop_euler_first[rhs];
+  const bool swapped = l > r;
+  if (swapped) {
+    std::swap(l, r);
+  }
+  const u32 n = loop_euler.size();
+  const u32 k = std::bit_width(r - l + 1) - 1;
+  const u32 r_start = r + 1 - (1u << k);
+  const auto level = [this](u32 pos) { return loops[loop_euler[pos]].level; };
+  u32 a = loop_rmq_first[k * n + l], b = loop_rmq_first[k * n + r_start];
+  const u32 first = level(b) < level(a) ? b : a;
+  a = loop_rmq_last[k * n + l], b = loop_rmq_last[k * n + r_start];
+  const u32 last = level(a) < level(b) ? a : b;
+
+  const u32 lca = loop_euler[first];
+  const u32 left = first == l ? lca : loop_euler[first - 1];
+  const u32 right = last == r ? lca : loop_euler[last + 1];
+  if (swapped) {
+    return LoopLCA{lca, right, left};
+  }
+  return LoopLCA{lca, left, right};
+}
+
 template <IRAdaptor Adaptor>
 void Analyzer<Adaptor>::compute_liveness() noexcept {
   // implement the liveness algorithm described in
@@ -726,6 +1048,42 @@ void Analyzer<Adaptor>::compute_liveness() noexcept {
 
   TPDE_LOG_TRACE("Starting Liveness Analysis");
 
+  has_dead_insts = false;
+  visit_liveness();
+  if constexpr (ProvidesPureInsts<Adaptor>) {
+    if (eliminate_dead_insts && find_dead_insts()) {
+      // Start over without the dead instructions, so that the live intervals
+      // of their operands end at the last remaining use.
+      TPDE_LOG_TRACE("Recomputing liveness without dead instructions");
+      for (auto &loop : loops) {
+        loop.definitions = 0;
+      }
+      visit_liveness();
+    }
+  }
+
+  // fill out the definitions_in_childs counters
+  // (skip 0 since it has itself as a parent)
+  for (u32 idx = loops.size() - 1; idx != 0; --idx) {
+    auto &loop = loops[idx];
+    loops[loop.parent].definitions_in_childs +=
+        loop.definitions_in_childs + loop.definitions;
+  }
+
+#ifdef TPDE_ASSERTS
+  // reset the incorrect ref_counts in the liveness infos
+  for (auto &entry : liveness) {
+    if (entry.ref_count == ~0u) {
+      entry.ref_count = 0;
+    }
+  }
+#endif
+
+  TPDE_LOG_TRACE("Finished Liveness Analysis");
+}
+
+template <IRAdaptor Adaptor>
+void Analyzer<Adaptor>::visit_liveness() noexcept {
   // Bump epoch. On overflow, we must clear all liveness info entries.
   if (++liveness_epoch == 0) {
     liveness.clear();
@@ -829,18 +1187,8 @@ void Analyzer<Adaptor>::compute_liveness() noexcept {
       // (liveness_loop.level + 1) that contains block_loop and extend the
       // liveness interval
       const auto target_level = liveness_loop.level + 1;
-      auto cur_loop_idx = block_loop_idx;
-      auto cur_level = block_loop.level;
-      // TODO(ts): we could also skip some loops here since we know that
-      // there have to be at least n=(cur_level-target_level) loops
-      // between cur_loop and target_loop
-      // so we could choose cur_loop_idx = min(cur_parent, cur_idx-n)?
-      // however this might jump into more nested loops
-      // so maybe check (cur_idx-n).level first?
-      while (cur_level != target_level) {
-        cur_loop_idx = loops[cur_loop_idx].parent;
-        --cur_level;
-      }
+      const auto cur_loop_idx =
+          loop_lca(liveness.lowest_common_loop, block_loop_idx).rhs_child;
       assert(loops[cur_loop_idx].level == target_level);
       TPDE_LOG_TRACE("    target_loop is {}", cur_loop_idx);
       update_for_loop(loops[cur_loop_idx]);
@@ -857,36 +1205,8 @@ void Analyzer<Adaptor>::compute_liveness() noexcept {
     // need to update the lowest common loop to contain both liveness_loop
     // and block_loop and then extend the interval accordingly
 
-    // TODO(ts): this algorithm is currently worst-case O(n) which makes the
-    // whole liveness analysis worst-case O(n^2) which is not good. However,
-    // we expect the number of loops to be much smaller than the number of
-    // values so it should be fine for most programs. To be safe, we should
-    // implement the algorithm from "Gusfield: Constant-Time Lowest Common
-    // Ancestor Retrieval" which seems to be the one with the most
-    // reasonable overhead. It is however not zero and the queries are also
-    // not exactly free so we should definitely benchmark both version first
-    // with both small and large programs
-
-    auto lhs_idx = liveness.lowest_common_loop;
-    auto rhs_idx = block_loop_idx;
-    auto prev_rhs = rhs_idx;
-    auto prev_lhs = lhs_idx;
-    while (lhs_idx != rhs_idx) {
-      const auto lhs_level = loops[lhs_idx].level;
-      const auto rhs_level = loops[rhs_idx].level;
-      if (lhs_level > rhs_level) {
-        prev_lhs = lhs_idx;
-        lhs_idx = loops[lhs_idx].parent;
-      } else if (lhs_level < rhs_level) {
-        prev_rhs = rhs_idx;
-        rhs_idx = loops[rhs_idx].parent;
-      } else {
-        prev_lhs = lhs_idx;
-        prev_rhs = rhs_idx;
-        lhs_idx = loops[lhs_idx].parent;
-        rhs_idx = loops[rhs_idx].parent;
-      }
-    }
+    const auto [lhs_idx, prev_lhs, prev_rhs] =
+        loop_lca(liveness.lowest_common_loop, block_loop_idx);
 
     assert(static_cast<u32>(loops[lhs_idx].begin) <=
            static_cast<u32>(liveness_loop.begin));
@@ -964,6 +1284,9 @@ void Analyzer<Adaptor>::compute_liveness() noexcept {
     }
 
     for (const IRInstRef inst : adaptor->block_insts(block)) {
+      if (inst_dead(inst)) {
+        continue;
+      }
       TPDE_LOG_TRACE("Analyzing instruction {}", adaptor->inst_fmt_ref(inst));
       for (const IRValueRef res : adaptor->inst_results(inst)) {
         // mark the value as used in the current block
@@ -978,25 +1301,60 @@ void Analyzer<Adaptor>::compute_liveness() noexcept {
       num_insts += 1;
     }
   }
+}
 
-  // fill out the definitions_in_childs counters
-  // (skip 0 since it has itself as a parent)
-  for (u32 idx = loops.size() - 1; idx != 0; --idx) {
-    auto &loop = loops[idx];
-    loops[loop.parent].definitions_in_childs +=
-        loop.definitions_in_childs + loop.definitions;
-  }
+template <IRAdaptor Adaptor>
+bool Analyzer<Adaptor>::find_dead_insts() noexcept {
+  // Uses follow their definitions in the block layout, so walking the
+  // instructions backwards sees all users of a value before its definition.
+  util::SmallVector<IRInstRef, 64> insts;
+  bool found = false;
+  for (u32 block_idx = block_layout.size(); block_idx-- > 0;) {
+    insts.clear();
+    for (const IRInstRef inst : adaptor->block_insts(block_layout[block_idx])) {
+      insts.push_back(inst);
+    }
 
-#ifdef TPDE_ASSERTS
-  // reset the incorrect ref_counts in the liveness infos
-  for (auto &entry : liveness) {
-    if (entry.ref_count == ~0u) {
-      entry.ref_count = 0;
+    for (u32 i = insts.size(); i-- > 0;) {
+      const IRInstRef inst = insts[i];
+      if (adaptor->inst_fused(inst) || !adaptor->inst_is_pure(inst)) {
+        continue;
+      }
+
+      // Only the definition itself references an unused result.
+      bool dead = false;
+      for (const IRValueRef res : adaptor->inst_results(inst)) {
+        if (adaptor->val_ignore_in_liveness_analysis(res) ||
+            liveness_maybe(res).ref_count != 1) {
+          dead = false;
+          break;
+        }
+        dead = true;
+      }
+      if (!dead) {
+        continue;
+      }
+
+      TPDE_LOG_TRACE("Instruction {} is dead", adaptor->inst_fmt_ref(inst));
+      if (!found) {
+        found = true;
+        dead_values.clear();
+        dead_values.resize(liveness_max_value + 1);
+        dead_values.zero();
+      }
+      for (const IRValueRef res : adaptor->inst_results(inst)) {
+        dead_values.mark_set(static_cast<u32>(adaptor->val_local_idx(res)));
+      }
+      for (const IRValueRef operand : adaptor->inst_operands(inst)) {
+        if (!adaptor->val_ignore_in_liveness_analysis(operand)) {
+          --liveness_maybe(operand).ref_count;
+        }
+      }
     }
   }
-#endif
 
-  TPDE_LOG_TRACE("Finished Liveness Analysis");
+  has_dead_insts = found;
+  return found;
 }
 
 } // namespace tpde
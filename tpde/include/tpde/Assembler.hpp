@@ -6,7 +6,12 @@
 #include "tpde/base.hpp"
 #include "tpde/util/BumpAllocator.hpp"
 #include "tpde/util/SmallVector.hpp"
+#include "tpde/util/function_ref.hpp"
+#include <algorithm>
+#include <cassert>
 #include <cstring>
+#include <span>
+#include <vector>
 
 namespace tpde {
 
@@ -49,6 +54,15 @@ struct Relocation {
   i32 addend;    ///< Addend.
 };
 
+/// Row of a line table: code starting at section offset off belongs to the
+/// source location (file, line, column).
+struct LineRow {
+  u32 off;
+  u32 file;
+  u32 line;
+  u32 column;
+};
+
 struct DataSection {
   friend class Assembler;
   friend class AssemblerElf;
@@ -58,15 +72,22 @@ struct DataSection {
   /// section per function).
   using StorageTy = util::SmallVector<u8, 256>;
 
-  /// Section data.
+  /// Section data, starting at section offset data_off. Only the last chunk
+  /// of the section if it was grown by a FunctionWriter.
   StorageTy data;
 
-  u64 addr = 0;  ///< Address (file-format-specific).
-  u64 vsize = 0; ///< Size of virtual section, otherwise data.size() is valid.
-  u32 type = 0;  ///< Type (file-format-specific).
-  u32 flags = 0; ///< Flags (file-format-specific).
-  u32 name = 0;  ///< Name (file-format-specific, can also be index, etc.).
-  u32 align = 1; ///< Alignment (bytes).
+  /// Preceding data chunks, which are filled and never modified again. This
+  /// avoids copying already written code when growing large text sections.
+  util::SmallVector<StorageTy, 0> chunks;
+
+  u64 data_off = 0; ///< Section offset of data.
+  u64 addr = 0;     ///< Address (file-format-specific).
+  u64 vsize = 0;    ///< Size of virtual section, otherwise size() is valid.
+  u32 type = 0;     ///< Type (file-format-specific).
+  u32 flags = 0;    ///< Flags (file-format-specific).
+  u32 name = 0;     ///< Name (file-format-specific, can also be index, etc.).
+  u32 align = 1;    ///< Alignment (bytes).
+  u32 entsize = 0;  ///< Entry size of mergeable sections (bytes).
 
   /// Section symbol, or signature symbol for SHT_GROUP sections.
   SymRef sym;
@@ -99,7 +120,33 @@ public:
 
   SecRef get_ref() const noexcept { return sec_ref; }
 
-  size_t size() const { return is_virtual ? vsize : data.size(); }
+  size_t size() const { return is_virtual ? vsize : data_off + data.size(); }
+
+  /// Call fn for every contiguous part of the section data in order. Stops and
+  /// returns false when fn returns false.
+  template <typename Fn>
+  bool for_each_chunk(Fn &&fn) const noexcept {
+    for (const StorageTy &chunk : chunks) {
+      if (!fn(std::span<const u8>(chunk.data(), chunk.size()))) {
+        return false;
+      }
+    }
+    return fn(std::span<const u8>(data.data(), data.size()));
+  }
+
+  /// Get a pointer to the data at the given section offset.
+  u8 *data_ptr(size_t off) noexcept {
+    if (off >= data_off) {
+      return data.data() + (off - data_off);
+    }
+    for (StorageTy &chunk : chunks) {
+      if (off < chunk.size()) {
+        return chunk.data() + off;
+      }
+      off -= chunk.size();
+    }
+    TPDE_UNREACHABLE("section offset out of range");
+  }
 
   template <typename T>
   void write(const T &t) noexcept {
@@ -128,6 +175,8 @@ public:
     u32 reloc_pc32;
     /// The relocation type for 64-bit absolute addresses.
     u32 reloc_abs64;
+    /// The relocation type for 32-bit absolute addresses.
+    u32 reloc_abs32;
   };
 
 protected:
@@ -176,11 +225,42 @@ public:
     reloc_sec(sec, sym, target_info.reloc_abs64, offset, addend);
   }
 
+  /// Move relocations of sec at or after offset off to dst, where off
+  /// corresponds to dst_off. These must be the last relocations of sec, i.e.
+  /// relocations must be added in order of their offset.
+  void reloc_move_tail(SecRef sec, u32 off, SecRef dst, u32 dst_off) noexcept {
+    auto &relocs = get_section(sec).relocs;
+    auto &dst_relocs = get_section(dst).relocs;
+    size_t first = relocs.size();
+    while (first > 0 && relocs[first - 1].offset >= off) {
+      --first;
+    }
+    assert(std::all_of(relocs.begin(),
+                       relocs.begin() + first,
+                       [off](const Relocation &r) { return r.offset < off; }) &&
+           "reloc_move_tail requires relocations sorted by offset");
+    for (size_t i = first; i < relocs.size(); ++i) {
+      Relocation reloc = relocs[i];
+      reloc.offset = reloc.offset - off + dst_off;
+      dst_relocs.push_back(reloc);
+    }
+    relocs.resize(first);
+  }
+
   /// @}
 
   virtual void finalize() noexcept {}
 
-  virtual std::vector<u8> build_object_file() noexcept = 0;
+  /// Receives consecutive parts of the object file; returns false on failure,
+  /// which aborts the output.
+  using ObjectSink = util::function_ref<bool(std::span<const u8>)>;
+
+  /// Write the object file in order into sink without building the entire file
+  /// in memory. Returns false if the sink failed.
+  virtual bool write_object_file(ObjectSink sink) noexcept = 0;
+
+  /// Build the object file in memory.
+  std::vector<u8> build_object_file() noexcept;
 };
 
 } // namespace tpde
@@ -3,11 +3,14 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <elf.h>
 #include <span>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "base.hpp"
@@ -23,7 +26,9 @@ namespace dwarf {
 // DWARF constants
 constexpr u8 DW_CFA_nop = 0;
 constexpr u8 DW_EH_PE_uleb128 = 0x01;
+constexpr u8 DW_EH_PE_udata4 = 0x03;
 constexpr u8 DW_EH_PE_pcrel = 0x10;
+constexpr u8 DW_EH_PE_datarel = 0x30;
 constexpr u8 DW_EH_PE_indirect = 0x80;
 constexpr u8 DW_EH_PE_sdata4 = 0x0b;
 constexpr u8 DW_EH_PE_omit = 0xff;
@@ -34,6 +39,8 @@ constexpr u8 DW_CFA_def_cfa_register = 0x0d;
 constexpr u8 DW_CFA_def_cfa_offset = 0x0e;
 constexpr u8 DW_CFA_offset = 0x80;
 constexpr u8 DW_CFA_advance_loc = 0x40;
+constexpr u8 DW_CFA_advance_loc1 = 0x02;
+constexpr u8 DW_CFA_advance_loc2 = 0x03;
 constexpr u8 DW_CFA_advance_loc4 = 0x04;
 
 constexpr u8 DWARF_CFI_PRIMARY_OPCODE_MASK = 0xc0;
@@ -135,6 +142,7 @@ constexpr u8 DW_reg_pc = 32;
 } // namespace dwarf
 
 class AssemblerElf : public Assembler {
+  friend class ElfLinker;
   friend class ElfMapper;
 
 protected:
@@ -172,6 +180,7 @@ private:
   StringTable shstrtab_extra;
 
   SecRef secref_text = SecRef();
+  SecRef secref_text_cold = SecRef();
   SecRef secref_rodata = SecRef();
   SecRef secref_relro = SecRef();
   SecRef secref_data = SecRef();
@@ -179,6 +188,22 @@ private:
   SecRef secref_tdata = SecRef();
   SecRef secref_tbss = SecRef();
 
+  struct MergeEntry {
+    u32 off;
+    u32 size;
+    /// Shared local symbol for constants, created on first use.
+    SymRef sym = SymRef();
+  };
+
+  /// Mergeable section with its contents, indexed by the hash of the data.
+  struct MergeSection {
+    SecRef sec = SecRef();
+    std::unordered_multimap<size_t, MergeEntry> entries;
+  };
+
+  /// Sections .rodata.cst4, .rodata.cst8, .rodata.cst16, and .rodata.str1.1.
+  std::array<MergeSection, 4> merge_sections;
+
   /// Unwind Info
   SecRef secref_eh_frame = SecRef();
   SecRef secref_except_table = SecRef();
@@ -212,10 +237,35 @@ private:
   SymRef cur_personality_func_addr;
   u32 eh_cur_cie_off = 0u;
   u32 eh_first_fde_off = 0;
+  /// CFI instructions of the current or most recently completed FDE without
+  /// location advances, i.e. the CFI state after the prologue.
+  util::SmallVector<u8, 32> eh_fde_state;
 
   /// The current function
   SymRef cur_func;
 
+  /// Line table sequence, one per function.
+  struct LineSeq {
+    SecRef sec;
+    u32 begin;
+    u32 end;
+    /// Offset of the DW_LNE_set_address operand in line_program.
+    u32 addr_off;
+    /// Rows of the sequence in line_rows.
+    u32 rows_begin;
+    u32 rows_end;
+  };
+
+  /// Line table directories and files (with directory index), emitted
+  /// together with the line program into .debug_line in finalize.
+  std::vector<std::string> line_dirs;
+  std::vector<std::pair<u32, std::string>> line_files;
+  util::SmallVector<u8, 0> line_program;
+  std::vector<LineSeq> line_seqs;
+  /// Rows of all sequences, for consumers other than .debug_line (e.g.,
+  /// jitdump for mapped code).
+  std::vector<LineRow> line_rows;
+
 public:
   explicit AssemblerElf(const TargetInfoElf &target_info)
       : Assembler(target_info) {
@@ -233,6 +283,10 @@ private:
     return get_section(ref).relocs;
   }
 
+  std::span<const Relocation> get_relocs(SecRef ref) const {
+    return get_section(ref).relocs;
+  }
+
   /// Allocate a new section.
   [[nodiscard]] SecRef
       create_section(unsigned type, unsigned flags, unsigned name) noexcept;
@@ -254,6 +308,8 @@ private:
 
 public:
   SecRef get_text_section() noexcept { return secref_text; }
+  /// Get the section for cold code (.text.unlikely).
+  SecRef get_text_cold_section() noexcept;
   SecRef get_data_section(bool rodata, bool relro = false) noexcept;
   SecRef get_bss_section() noexcept;
   SecRef get_tdata_section() noexcept;
@@ -333,6 +389,23 @@ public:
                            u32 align,
                            u32 *off = nullptr) noexcept;
 
+private:
+  /// Find or append data in the mergeable section for its size or for strings.
+  MergeEntry &get_merge_entry(std::span<const u8> data,
+                              bool strings,
+                              SecRef &sec_ref) noexcept;
+
+public:
+  /// Get a local symbol for a constant of 4, 8, or 16 bytes in a mergeable
+  /// section. Identical constants share the same symbol.
+  [[nodiscard]] SymRef sym_def_const(std::span<const u8> data) noexcept;
+
+  /// Define sym in a mergeable section, either for constants of 4, 8, or 16
+  /// bytes or for NUL-terminated strings. Identical data is stored once.
+  void sym_def_predef_merge(SymRef sym,
+                            std::span<const u8> data,
+                            bool strings) noexcept;
+
 private:
   /// Set symbol sections for SHN_XINDEX.
   void sym_def_xindex(SymRef sym_ref, SecRef sec_ref) noexcept;
@@ -426,6 +499,10 @@ private:
 public:
   u32 eh_begin_fde(SymRef personality_func_addr = SymRef()) noexcept;
   void eh_end_fde(u32 fde_start, SymRef func) noexcept;
+  /// Write an FDE for the cold part of the function whose FDE was completed
+  /// last. The cold part is only entered after the prologue, so its FDE
+  /// starts with the CFI state at the end of that prologue.
+  void eh_write_cold_fde(SymRef cold_sym) noexcept;
 
   void except_begin_func() noexcept;
 
@@ -450,11 +527,36 @@ public:
 
   u32 except_type_idx_for_sym(SymRef sym) noexcept;
 
+  // Line tables
+
+  /// Add a file to the line table, returns its index for LineRow::file.
+  u32 line_add_file(std::string_view dir, std::string_view name) noexcept;
+
+  /// Add a line table sequence for the code of a function in section sec,
+  /// which ends at offset end. Rows must be sorted by offset, rows at or
+  /// after end are ignored.
+  void line_add_sequence(SecRef sec,
+                         std::span<const LineRow> rows,
+                         u32 end) noexcept;
+
+private:
+  /// Emit .debug_line with a minimal .debug_info compile unit and
+  /// .debug_aranges, so that tools find the line table for an address.
+  void line_emit() noexcept;
+
+public:
   void finalize() noexcept override;
 
+private:
+  /// Try to apply a relocation to a local symbol in the same section, which
+  /// needs no relocation in the output. Returns false if the relocation must
+  /// be kept.
+  bool resolve_local_reloc(DataSection &sec, const Relocation &reloc) noexcept;
+
+public:
   // Output file generation
 
-  std::vector<u8> build_object_file() noexcept override;
+  bool write_object_file(ObjectSink sink) noexcept override;
 };
 
 // TODO: Remove these types, instead find a good way to specify architecture as
@@ -16,7 +16,7 @@ class AssignmentPartRef {
 
   // note for how parts are structured:
   // |15|14|13|12|11|10|09|08|07|06|05|04|03|02|01|00|
-  // |  |   PS   |RV|  |IM|FA|  bank  |    reg_id    |
+  // |  |   PS   |RV|UZ|IM|FA|  bank  |    reg_id    |
   //                         |      full_reg_id      |
   //
   // PS: 1 << PS = part size (TODO(ts): maybe swap with NP so that it can be
@@ -24,6 +24,8 @@ class AssignmentPartRef {
   // RV: Register Valid
   // IM: Is the current register value not on the stack?
   // FA: Is the assignment a fixed assignment?
+  // UZ: Are the register bits above the part size known to be zero? Only
+  //     meaningful if RV is set; cleared whenever RV is set.
   //
   // RV + IM form a unit describing the following states:
   //  - !RV +  IM: value uninitialized (default state)
@@ -98,12 +100,24 @@ public:
 
   void set_register_valid(const bool val) noexcept {
     if (val) {
-      va->parts[part] |= (1u << 11);
+      va->parts[part] = (va->parts[part] | (1u << 11)) & ~(1u << 10);
     } else {
       va->parts[part] &= ~(1u << 11);
     }
   }
 
+  [[nodiscard]] bool upper_bits_zero() const noexcept {
+    return (va->parts[part] & (1u << 10)) != 0;
+  }
+
+  void set_upper_bits_zero(const bool val) noexcept {
+    if (val) {
+      va->parts[part] |= (1u << 10);
+    } else {
+      va->parts[part] &= ~(1u << 10);
+    }
+  }
+
   [[nodiscard]] bool stack_valid() const noexcept {
     return (va->parts[part] & (1u << 9)) == 0;
   }
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 #include <variant>
 
@@ -179,6 +180,20 @@ public:
 
   util::SmallVector<std::pair<SymRef, SymRef>, 4> personality_syms = {};
 
+  /// Whether cold blocks, which the analyzer places at the end of the layout,
+  /// are emitted into a separate section (.text.unlikely). Only functions in
+  /// the default text section without personality function are split.
+  bool split_cold_code = false;
+
+  /// Whether zero-extensions of values whose upper register bits are known to
+  /// be zero (e.g., after a zero-extending load or a reload from the stack)
+  /// are omitted.
+  bool elide_redundant_ext = false;
+
+  /// First block of the cold part of the current function, or
+  /// INVALID_BLOCK_IDX if the function is not split.
+  BlockIndex func_cold_block = Analyzer<Adaptor>::INVALID_BLOCK_IDX;
+
   struct ScratchReg;
   class ValuePart;
   struct ValuePartRef;
@@ -228,6 +243,11 @@ public:
 
     RegisterFile::RegBitSet arg_regs{};
 
+    /// Return registers assigned by the callee's convention in can_tail_call,
+    /// used by add_ret instead of assigning them again.
+    util::SmallVector<Reg, 4> tail_ret_regs;
+    u32 tail_ret_idx = 0;
+
   public:
     CallBuilderBase(Derived &compiler, CCAssigner &assigner) noexcept
         : compiler(compiler), assigner(assigner) {}
@@ -236,6 +256,7 @@ public:
     // void add_arg_byval(ValuePart &vp, CCAssignment &cca) noexcept;
     // void add_arg_stack(ValuePart &vp, CCAssignment &cca) noexcept;
     // void call_impl(std::variant<SymRef, ValuePart> &&) noexcept;
+    // void tail_call_impl(std::variant<SymRef, ValuePart> &&) noexcept;
     CBDerived *derived() noexcept { return static_cast<CBDerived *>(this); }
 
     void add_arg(ValuePart &&vp, CCAssignment cca) noexcept;
@@ -247,6 +268,17 @@ public:
     // evict registers, do call, reset stack frame
     void call(std::variant<SymRef, ValuePart>) noexcept;
 
+    /// Whether the call can be emitted as tail call after all arguments were
+    /// added: no arguments are passed on the stack, the callee preserves all
+    /// registers that the current function must preserve, and, if ret_val is
+    /// given, the callee returns it in the registers where the current
+    /// function returns it.
+    bool can_tail_call(std::optional<IRValueRef> ret_val) noexcept;
+    /// Tear down the stack frame and jump to the target. Must only be called
+    /// if can_tail_call returned true; afterwards, the current block is
+    /// finished like after a return.
+    void tail_call(std::variant<SymRef, ValuePart>) noexcept;
+
     void add_ret(ValuePart &vp, CCAssignment cca) noexcept;
     void add_ret(ValuePart &&vp, CCAssignment cca) noexcept {
       add_ret(vp, cca);
@@ -343,6 +375,14 @@ public:
   std::pair<ValueRef, ValuePartRef>
       result_ref_single(IRValueRef value) noexcept;
 
+  /// Let the result value take over the assignment of the operand instead of
+  /// copying it, for instructions that do not change the value representation
+  /// (e.g., no-op casts). This requires that the instruction is the last use
+  /// of the operand or that the operand is a variable reference, and that the
+  /// part layout of both values is identical. On success, src is consumed and
+  /// the result is fully defined.
+  bool try_alias_value(ValueRef &src, IRValueRef dst) noexcept;
+
   [[deprecated("Use ValuePartRef::set_value")]]
   void set_value(ValuePartRef &val_ref, ScratchReg &scratch) noexcept;
   [[deprecated("Use ValuePartRef::set_value")]]
@@ -458,6 +498,9 @@ protected:
   bool compile_func(IRFuncRef func, u32 func_idx) noexcept;
 
   bool compile_block(IRBlockRef block, u32 block_idx) noexcept;
+
+  /// Move the cold part of the current function into the cold section.
+  void move_cold_code(IRFuncRef func) noexcept;
 };
 } // namespace tpde
 
@@ -496,6 +539,9 @@ void CompilerBase<Adaptor, Derived, Config>::CallBuilderBase<
     vp.reset(&compiler);
   } else {
     u32 size = vp.part_size();
+    if (!ext_sign && ext_bits == size * 8 && vp.upper_bits_zero(&compiler)) {
+      needs_ext = false;
+    }
     if (vp.is_in_reg(cca.reg)) {
       if (!vp.can_salvage()) {
         compiler.evict_reg(cca.reg);
@@ -608,13 +654,68 @@ void CompilerBase<Adaptor, Derived, Config>::CallBuilderBase<CBDerived>::call(
   compiler.register_file.allocatable |= arg_regs;
 }
 
+template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
+template <typename CBDerived>
+bool CompilerBase<Adaptor, Derived, Config>::CallBuilderBase<
+    CBDerived>::can_tail_call(std::optional<IRValueRef> ret_val) noexcept {
+  // Stack arguments would have to be written to the incoming argument area of
+  // the current function, which might still be read by other arguments.
+  if (assigner.get_stack_size() != 0) {
+    return false;
+  }
+  CCAssigner *caller_assigner = compiler.cur_cc_assigner();
+  auto caller_csr = caller_assigner->get_ccinfo().callee_saved_regs;
+  auto callee_csr = assigner.get_ccinfo().callee_saved_regs;
+  if ((caller_csr & ~callee_csr) != 0) {
+    return false;
+  }
+  if (!ret_val) {
+    return true;
+  }
+
+  // Compare the return value assignments of both conventions. The caller's
+  // assigner is reset for every return anyway; the callee's assignments are
+  // kept for add_ret if the call is not emitted as tail call.
+  assert(tail_ret_regs.empty());
+  caller_assigner->reset();
+  const auto parts = compiler.val_parts(*ret_val);
+  bool same_regs = true;
+  for (u32 part_idx = 0; part_idx < parts.count(); ++part_idx) {
+    CCAssignment caller_cca, callee_cca;
+    caller_cca.bank = callee_cca.bank = parts.reg_bank(part_idx);
+    caller_cca.size = callee_cca.size = parts.size_bytes(part_idx);
+    caller_assigner->assign_ret(caller_cca);
+    assigner.assign_ret(callee_cca);
+    tail_ret_regs.push_back(callee_cca.reg);
+    same_regs &= caller_cca.reg == callee_cca.reg;
+  }
+  return same_regs;
+}
+
+template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
+template <typename CBDerived>
+void CompilerBase<Adaptor, Derived, Config>::CallBuilderBase<
+    CBDerived>::tail_call(std::variant<SymRef, ValuePart> target) noexcept {
+  assert(assigner.get_stack_size() == 0);
+  // No need to evict any registers: no value is used after the call.
+  derived()->tail_call_impl(std::move(target));
+
+  assert((compiler.register_file.allocatable & arg_regs) == 0);
+  compiler.register_file.allocatable |= arg_regs;
+  compiler.release_regs_after_return();
+}
+
 template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
 template <typename CBDerived>
 void CompilerBase<Adaptor, Derived, Config>::CallBuilderBase<
     CBDerived>::add_ret(ValuePart &vp, CCAssignment cca) noexcept {
   cca.bank = vp.bank();
   cca.size = vp.part_size();
-  assigner.assign_ret(cca);
+  if (tail_ret_idx < tail_ret_regs.size()) {
+    cca.reg = tail_ret_regs[tail_ret_idx++];
+  } else {
+    assigner.assign_ret(cca);
+  }
   assert(cca.reg.valid() && "return value must be in register");
   vp.set_value_reg(&compiler, cca.reg);
 }
@@ -642,6 +743,9 @@ void CompilerBase<Adaptor, Derived, Config>::RetBuilder::add(
   bool needs_ext = cca.int_ext != 0;
   bool ext_sign = cca.int_ext >> 7;
   unsigned ext_bits = cca.int_ext & 0x3f;
+  if (!ext_sign && ext_bits == size * 8 && vp.upper_bits_zero(&compiler)) {
+    needs_ext = false;
+  }
 
   if (vp.is_in_reg(cca.reg)) {
     if (!vp.can_salvage()) {
@@ -1120,6 +1224,66 @@ std::pair<typename CompilerBase<Adaptor, Derived, Config>::ValueRef,
   return res;
 }
 
+template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
+bool CompilerBase<Adaptor, Derived, Config>::try_alias_value(
+    ValueRef &src, IRValueRef dst) noexcept {
+  if (!src.has_assignment()) {
+    return false;
+  }
+
+  const ValLocalIdx local_idx = adaptor->val_local_idx(dst);
+  assert(val_assignment(local_idx) == nullptr && "result already defined");
+  ValueAssignment *assignment = src.assignment();
+  const auto parts = derived()->val_parts(dst);
+  if (parts.count() != assignment->part_count) {
+    return false;
+  }
+  for (u32 part_idx = 0; part_idx < assignment->part_count; ++part_idx) {
+    AssignmentPartRef ap{assignment, part_idx};
+    if (ap.bank() != parts.reg_bank(part_idx) ||
+        ap.part_size() != parts.size_bytes(part_idx)) {
+      return false;
+    }
+  }
+
+  if (assignment->variable_ref) {
+    // Variable references are not ref-counted and never modified, so the
+    // result can simply refer to the same variable.
+    init_variable_ref(local_idx, assignment->var_ref_custom_idx);
+    ValueAssignment *res_assignment = val_assignment(local_idx);
+    res_assignment->stack_variable = assignment->stack_variable;
+    res_assignment->frame_off = assignment->frame_off;
+    src.reset();
+    return true;
+  }
+
+  if (!src.is_owned()) {
+    return false;
+  }
+
+  TPDE_LOG_TRACE("Aliasing value {} to value {}",
+                 static_cast<u32>(local_idx),
+                 static_cast<u32>(src.local_idx()));
+
+  // Move the assignment, including registers and stack slot, to the result.
+  for (u32 part_idx = 0; part_idx < assignment->part_count; ++part_idx) {
+    AssignmentPartRef ap{assignment, part_idx};
+    if (ap.register_valid()) {
+      register_file.update_reg_assignment(ap.get_reg(), local_idx, part_idx);
+    }
+  }
+  assignments.value_ptrs[static_cast<u32>(src.local_idx())] = nullptr;
+  assignments.value_ptrs[static_cast<u32>(local_idx)] = assignment;
+  src.disown();
+
+  const auto &liveness = analyzer.liveness_info(local_idx);
+  assignment->delay_free = liveness.last_full;
+  assignment->references_left = liveness.ref_count;
+  // Consume the reference of the definition, like result_ref would.
+  ValueRef{this, local_idx}.reset();
+  return true;
+}
+
 template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
 void CompilerBase<Adaptor, Derived, Config>::set_value(
     ValuePartRef &val_ref, ScratchReg &scratch) noexcept {
@@ -1831,7 +1995,12 @@ void CompilerBase<Adaptor, Derived, Config>::move_to_phi_nodes_impl(
 template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
 typename CompilerBase<Adaptor, Derived, Config>::BlockIndex
     CompilerBase<Adaptor, Derived, Config>::next_block() const noexcept {
-  return static_cast<BlockIndex>(static_cast<u32>(cur_block_idx) + 1);
+  const auto next = static_cast<BlockIndex>(u32(cur_block_idx) + 1);
+  // The cold part is moved to a different section, so never fall through.
+  if (next == func_cold_block) {
+    return Analyzer<Adaptor>::INVALID_BLOCK_IDX;
+  }
+  return next;
 }
 
 template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
@@ -1907,6 +2076,15 @@ bool CompilerBase<Adaptor, Derived, Config>::compile_func(
   u32 expected_code_size = 0x8 * analyzer.num_insts + 0x40;
   this->text_writer.begin_func(expected_code_size);
 
+  func_cold_block = Analyzer<Adaptor>::INVALID_BLOCK_IDX;
+  if (split_cold_code &&
+      static_cast<u32>(analyzer.cold_block_begin) <
+          analyzer.block_layout.size() &&
+      text_writer.get_sec_ref() == assembler.get_text_section() &&
+      !derived()->cur_personality_func().valid()) {
+    func_cold_block = analyzer.cold_block_begin;
+  }
+
   derived()->start_func(func_idx);
 
   block_labels.clear();
@@ -1945,6 +2123,9 @@ bool CompilerBase<Adaptor, Derived, Config>::compile_func(
 
   for (u32 i = 0; i < analyzer.block_layout.size(); ++i) {
     const auto block_ref = analyzer.block_layout[i];
+    if (static_cast<BlockIndex>(i) == func_cold_block) {
+      text_writer.begin_cold();
+    }
     TPDE_LOG_TRACE(
         "Compiling block {} ({})", i, adaptor->block_fmt_ref(block_ref));
     if (!derived()->compile_block(block_ref, i)) [[unlikely]] {
@@ -1971,10 +2152,65 @@ bool CompilerBase<Adaptor, Derived, Config>::compile_func(
 
   derived()->finish_func(func_idx);
   this->text_writer.finish_func();
+  if (func_cold_block != Analyzer<Adaptor>::INVALID_BLOCK_IDX) {
+    move_cold_code(func);
+  }
+  if (!text_writer.line_rows.empty()) [[unlikely]] {
+    assembler.line_add_sequence(
+        text_writer.get_sec_ref(), text_writer.line_rows, text_writer.offset());
+  }
 
   return true;
 }
 
+template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
+void CompilerBase<Adaptor, Derived, Config>::move_cold_code(
+    const IRFuncRef func) noexcept {
+  const SecRef text_sec = text_writer.get_sec_ref();
+  const SecRef cold_sec = assembler.get_text_cold_section();
+  const u32 cold_off = text_writer.hot_end_offset();
+  const u32 cold_size = text_writer.offset() - cold_off;
+
+  std::string name{adaptor->func_link_name(func)};
+  name += ".cold";
+  SymRef cold_sym =
+      assembler.sym_predef_func(name, Assembler::SymBinding::LOCAL);
+  u32 cold_sec_off;
+  assembler.sym_def_predef_data(
+      cold_sec,
+      cold_sym,
+      {text_writer.data_ptr(cold_off), cold_size},
+      16,
+      &cold_sec_off);
+  assembler.reloc_move_tail(text_sec, cold_off, cold_sec, cold_sec_off);
+
+  // Line table rows of the cold part describe the cold section. Code at the
+  // beginning of the cold part belongs to the last row before it.
+  auto &line_rows = text_writer.line_rows;
+  if (!line_rows.empty()) [[unlikely]] {
+    auto cold_it = std::partition_point(
+        line_rows.begin(), line_rows.end(), [cold_off](const LineRow &row) {
+          return row.off < cold_off;
+        });
+    util::SmallVector<LineRow> cold_rows;
+    if (cold_it != line_rows.begin() &&
+        (cold_it == line_rows.end() || cold_it->off != cold_off)) {
+      cold_rows.push_back(cold_it[-1]);
+      cold_rows.back().off = cold_off;
+    }
+    cold_rows.append(cold_it, line_rows.end());
+    for (LineRow &row : cold_rows) {
+      row.off += cold_sec_off - cold_off;
+    }
+    assembler.line_add_sequence(cold_sec, cold_rows, cold_sec_off + cold_size);
+    line_rows.resize(cold_it - line_rows.begin());
+  }
+  text_writer.finish_cold(assembler, cold_sym);
+  assembler.eh_write_cold_fde(cold_sym);
+
+  TPDE_LOG_TRACE("Moved {} bytes of cold code to {}", cold_size, name);
+}
+
 template <IRAdaptor Adaptor, typename Derived, CompilerConfig Config>
 bool CompilerBase<Adaptor, Derived, Config>::compile_block(
     const IRBlockRef block, const u32 block_idx) noexcept {
@@ -1986,7 +2222,7 @@ bool CompilerBase<Adaptor, Derived, Config>::compile_block(
   auto end = val_range.end();
   for (auto it = val_range.begin(); it != end; ++it) {
     const IRInstRef inst = *it;
-    if (this->adaptor->inst_fused(inst)) {
+    if (this->adaptor->inst_fused(inst) || analyzer.inst_dead(inst)) {
       continue;
     }
 
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "base.hpp"
+#include "tpde/Assembler.hpp"
+#include "tpde/AssemblerElf.hpp"
+
+namespace tpde {
+
+/// Minimal linker that turns a single finalized module into a loadable shared
+/// object or position-independent executable, so that no system linker is
+/// needed.
+///
+/// Defined symbols are bound locally (like -Bsymbolic) and default-visibility
+/// global symbols of shared objects are exported. References to undefined
+/// symbols go through a GOT that is fully relocated at load time, calls use
+/// PLT stubs that jump through the GOT. Thread-local storage is not supported.
+/// DWARF sections (.debug_*) are kept as non-allocated sections with their
+/// relocations resolved to the linked addresses.
+class ElfLinker {
+public:
+  struct Options {
+    /// DT_SONAME of the output, omitted if empty.
+    std::string_view soname;
+    /// Shared libraries recorded as DT_NEEDED, in order.
+    std::span<const std::string> needed;
+    /// Entry symbol of executables. If the module does not define it but
+    /// defines main, a start stub that calls __libc_start_main is used.
+    std::string_view entry = "_start";
+    /// Program interpreter of executables, the default one of the target if
+    /// empty.
+    std::string_view interp;
+  };
+
+  /// Link the module into a shared object and write it in order into sink.
+  /// Returns false on failure, e.g., for unsupported relocations.
+  static bool link_shared(AssemblerElf &assembler,
+                          const Options &options,
+                          Assembler::ObjectSink sink) noexcept {
+    return link(assembler, options, sink, false);
+  }
+
+  /// Link the module into a position-independent executable and write it in
+  /// order into sink. Might add an undefined symbol for __libc_start_main to
+  /// the assembler. Returns false on failure.
+  static bool link_executable(AssemblerElf &assembler,
+                              const Options &options,
+                              Assembler::ObjectSink sink) noexcept {
+    return link(assembler, options, sink, true);
+  }
+
+private:
+  /// State of a single link, defined in ElfLinker.cpp.
+  class Linker;
+
+  static bool link(AssemblerElf &assembler,
+                   const Options &options,
+                   Assembler::ObjectSink sink,
+                   bool exe) noexcept;
+};
+
+} // namespace tpde
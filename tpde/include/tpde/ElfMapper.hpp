@@ -24,6 +24,17 @@ private:
   u32 local_sym_count = 0;
   util::SmallVector<void *, 64> sym_addrs;
 
+  /// Whether mapped functions are appended to /tmp/perf-<pid>.map.
+  bool perf_map = false;
+  /// Whether mapped functions are written to /tmp/jit-<pid>.dump.
+  bool jitdump = false;
+  /// Whether mapped modules are registered with the GDB JIT interface.
+  bool gdb_jit = false;
+
+  /// Object file and entry registered with the GDB JIT interface, if any.
+  struct GdbJitEntry;
+  GdbJitEntry *gdb_jit_entry = nullptr;
+
 public:
   ElfMapper() noexcept = default;
   ~ElfMapper() { reset(); }
@@ -38,7 +49,38 @@ public:
 
   bool map(AssemblerElf &assembler, SymbolResolver resolver) noexcept;
 
+  /// Record functions mapped from now on in the perf map /tmp/perf-<pid>.map,
+  /// so that perf report can symbolize samples in them. Entries are never
+  /// removed: after reset, code mapped later at the same address keeps the
+  /// stale entries and samples there may be attributed to the old function.
+  void set_perf_map(bool enable) noexcept { perf_map = enable; }
+
+  /// Record functions mapped from now on with their code and line table in
+  /// the jitdump file /tmp/jit-<pid>.dump, for use with perf record -k 1 and
+  /// perf inject --jit. jitdump has no unload records, so reset writes
+  /// nothing; as records are timestamped, perf attributes samples at reused
+  /// addresses to the code loaded last. JIT_CODE_CLOSE is only written at
+  /// process exit.
+  void set_jitdump(bool enable) noexcept { jitdump = enable; }
+
+  /// Register modules mapped from now on with the GDB JIT interface
+  /// (__jit_debug_register_code), so that gdb has symbols, unwind information
+  /// and, if emitted, line tables for the mapped code. The registered object
+  /// file only contains metadata, the code is read from memory by gdb.
+  /// Registration is not synchronized with other JIT compilers using the same
+  /// interface in the process, these must not register code concurrently.
+  void set_gdb_jit(bool enable) noexcept { gdb_jit = enable; }
+
   void *get_sym_addr(SymRef sym) noexcept;
+
+private:
+  /// Write the mapped functions to the perf map and/or jitdump file.
+  void perf_record(const AssemblerElf &assembler) noexcept;
+
+  /// Build an object file describing the mapping and register it with gdb.
+  void gdb_register(const AssemblerElf &assembler) noexcept;
+  /// Unregister the object file of the mapping from gdb.
+  void gdb_unregister() noexcept;
 };
 
 } // namespace tpde
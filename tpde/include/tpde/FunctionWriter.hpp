@@ -29,7 +29,9 @@ template <typename Derived>
 class FunctionWriter {
 protected:
   DataSection *section = nullptr;
+  /// Start of the current chunk of the section, at section offset data_off.
   u8 *data_begin = nullptr;
+  size_t data_off = 0;
   u8 *data_cur = nullptr;
   u8 *data_reserve_end = nullptr;
 
@@ -37,6 +39,9 @@ public:
   /// Label offsets into section, ~0u indicates unplaced label.
   util::SmallVector<u32> label_offsets;
 
+  /// Line table rows of the current function, only recorded by set_line.
+  util::SmallVector<LineRow> line_rows;
+
 protected:
   struct LabelFixup {
     Label label;
@@ -50,6 +55,16 @@ protected:
   /// Growth size for more_space; adjusted exponentially after every grow.
   u32 growth_size = 0x10000;
 
+  /// Offset of the cold part of the function, ~0u if there is none.
+  u32 cold_off = ~0u;
+
+  /// Offset of the current function, which must stay contiguous in memory.
+  u32 func_begin_off = 0;
+
+  /// Minimum size of a section data chunk. Sections grow in place up to this
+  /// size; beyond, the current function is moved to a new chunk instead.
+  static constexpr size_t ChunkSize = 0x100000;
+
 public:
   FunctionWriter() noexcept = default;
 
@@ -77,32 +92,67 @@ public:
            "must flush section writer before switching sections");
     section = &new_section;
     data_begin = section->data.data();
+    data_off = section->data_off;
     data_cur = data_begin + section->data.size();
     data_reserve_end = data_cur;
+    func_begin_off = offset();
   }
 
   void begin_func(u32 expected_size) noexcept {
     label_offsets.clear();
     label_fixups.clear();
+    line_rows.clear();
     growth_size = expected_size;
+    cold_off = ~0u;
+    func_begin_off = offset();
     ensure_space(expected_size);
   }
 
   void finish_func() noexcept { derived()->handle_fixups(); }
 
+  /// Start the cold part of the function at the current offset. Code in the
+  /// cold part must not reference labels placed before.
+  void begin_cold() noexcept { cold_off = offset(); }
+
+  /// Get the end offset of the hot part of the function, which is the current
+  /// offset if there is no cold part.
+  size_t hot_end_offset() const noexcept {
+    return cold_off != ~0u ? cold_off : offset();
+  }
+
+  /// Remove the cold part from the section after the fixups are handled. The
+  /// caller must have copied it to cold_sym; references from the hot part are
+  /// replaced with relocations.
+  void finish_cold(Assembler &assembler, SymRef cold_sym) noexcept {
+    assert(cold_off != ~0u);
+    for (const LabelFixup &fixup : label_fixups) {
+      const bool label_cold = label_offset(fixup.label) >= cold_off;
+      assert((label_cold || fixup.off < cold_off) &&
+             "cold part must not reference the hot part");
+      if (label_cold && fixup.off < cold_off) {
+        derived()->handle_cold_fixup(assembler, fixup, cold_sym);
+      }
+    }
+    data_cur = data_ptr(cold_off);
+  }
+
   /// \name Text Writing
   /// @{
 
   /// Get the current offset into the section.
-  size_t offset() const noexcept { return data_cur - data_begin; }
+  size_t offset() const noexcept { return data_off + (data_cur - data_begin); }
 
   /// Get the current allocated size of the section.
   size_t allocated_size() const noexcept {
-    return data_reserve_end - data_begin;
+    return data_off + (data_reserve_end - data_begin);
   }
 
-  /// Pointer to beginning of section data.
-  u8 *begin_ptr() noexcept { return data_begin; }
+  /// Pointer to the section data at offset off. Only the current chunk, which
+  /// always contains the current function, is contiguous in memory.
+  u8 *data_ptr(size_t off) noexcept {
+    assert(off >= data_off && off <= allocated_size());
+    return data_begin + (off - data_off);
+  }
 
   /// Modifiable pointer to current writing position of the section. Must not
   /// be moved beyond the allocated region.
@@ -132,7 +182,7 @@ public:
 
   void flush() noexcept {
     if (data_cur != data_reserve_end) {
-      section->data.resize(offset());
+      section->data.resize(data_cur - data_begin);
       data_reserve_end = data_cur;
 #ifndef NDEBUG
       section->locked = false;
@@ -145,10 +195,29 @@ public:
     ensure_space(align);
     // permit optimization when align is a constant.
     std::memset(cur_ptr(), 0, align);
-    data_cur = data_begin + util::align_up(offset(), align);
+    data_cur = data_ptr(util::align_up(offset(), align));
     section->align = std::max(section->align, u32(align));
   }
 
+  /// Attribute code written from the current offset on to a source location.
+  /// Called for every instruction if line tables are enabled, so only records
+  /// changes.
+  void set_line(u32 file, u32 line, u32 column) noexcept {
+    const u32 off = offset();
+    if (!line_rows.empty()) {
+      LineRow &last = line_rows.back();
+      if (last.file == file && last.line == line && last.column == column) {
+        return;
+      }
+      if (last.off == off) {
+        // No code for the previous location.
+        last = LineRow{off, file, line, column};
+        return;
+      }
+    }
+    line_rows.push_back(LineRow{off, file, line, column});
+  }
+
   /// @}
 
   /// \name Labels
@@ -187,7 +256,8 @@ public:
 
 template <typename Derived>
 void FunctionWriter<Derived>::more_space(size_t size) noexcept {
-  size_t cur_size = section->data.size();
+  const size_t off = offset();
+  size_t cur_size = off - section->data_off;
   size_t new_size;
   if (cur_size + size <= section->data.capacity()) {
     new_size = section->data.capacity();
@@ -198,19 +268,37 @@ void FunctionWriter<Derived>::more_space(size_t size) noexcept {
     growth_size = growth_size + (growth_size >> 1);
     // Max 16 MiB per grow.
     growth_size = growth_size < 0x1000000 ? growth_size : 0x1000000;
+
+    // Large chunk with previous functions: instead of reallocating (and
+    // copying) the entire chunk, move only the current function to a new one.
+    if (section->data.capacity() >= ChunkSize &&
+        func_begin_off > section->data_off) {
+      const size_t keep = func_begin_off - section->data_off;
+      const size_t func_size = off - func_begin_off;
+      new_size = std::max(new_size - keep, ChunkSize);
+
+      DataSection::StorageTy chunk;
+      chunk.resize_uninitialized(new_size);
+      std::memcpy(chunk.data(), section->data.data() + keep, func_size);
+      section->data.resize(keep);
+      section->chunks.push_back(std::move(section->data));
+      section->data = std::move(chunk);
+      section->data_off = func_begin_off;
+      cur_size = func_size;
+    }
   }
 
-  const size_t off = offset();
   section->data.resize_uninitialized(new_size);
 #ifndef NDEBUG
   thread_local uint8_t rand = 1;
-  std::memset(section->data.data() + off, rand += 2, new_size - off);
+  std::memset(section->data.data() + cur_size, rand += 2, new_size - cur_size);
   section->locked = true;
 #endif
 
   data_begin = section->data.data();
-  data_cur = data_begin + off;
+  data_off = section->data_off;
   data_reserve_end = data_begin + section->data.size();
+  data_cur = data_ptr(off);
 }
 
 } // namespace tpde
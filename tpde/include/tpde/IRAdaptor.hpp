@@ -26,6 +26,20 @@ concept CanBeFormatted = requires(T a) {
 template <bool B>
 concept IsFalse = (B == false);
 
+/// Whether the adaptor provides block frequency hints. Optional, adaptors
+/// that don't define TPDE_PROVIDES_BLOCK_HINTS don't provide them.
+template <typename T>
+concept ProvidesBlockHints = requires {
+  requires T::TPDE_PROVIDES_BLOCK_HINTS == true;
+};
+
+/// Whether the adaptor can tell which instructions are pure. Optional,
+/// adaptors that don't define TPDE_PROVIDES_PURE_INSTS can't.
+template <typename T>
+concept ProvidesPureInsts = requires {
+  requires T::TPDE_PROVIDES_PURE_INSTS == true;
+};
+
 /// Concept describing an iterator over some range
 ///
 /// It is purposefully kept simple (and probably wrong)
@@ -136,6 +150,19 @@ concept IRAdaptor = requires(T a) {
   /// Note: One of these has to be true
   { T::TPDE_LIVENESS_VISIT_ARGS } -> SameBaseAs<bool>;
 
+  /// Can the adaptor provide hints about the execution frequency of blocks to
+  /// improve the block layout? Optional, defaults to false.
+  requires !requires { T::TPDE_PROVIDES_BLOCK_HINTS; } || requires {
+    { T::TPDE_PROVIDES_BLOCK_HINTS } -> SameBaseAs<bool>;
+  };
+
+  /// Can the adaptor tell which instructions are free of side effects, so
+  /// that they can be skipped if their results are unused? Optional, defaults
+  /// to false.
+  requires !requires { T::TPDE_PROVIDES_PURE_INSTS; } || requires {
+    { T::TPDE_PROVIDES_PURE_INSTS } -> SameBaseAs<bool>;
+  };
+
   // Can the adaptor store two 32 bit values for efficient access through the
   // block reference?
   // { T::TPDE_CAN_STORE_BLOCK_AUX } -> std::same_as<bool>;
@@ -232,6 +259,26 @@ concept IRAdaptor = requires(T a) {
     a.block_succs(ARG(typename T::IRBlockRef))
   } -> IRRange<typename T::IRBlockRef>;
 
+  /// Is the block unlikely to be executed (e.g., error paths)? Cold blocks
+  /// which can't branch back to other blocks are placed at the end of the
+  /// function.
+  /// Only needs to be implemented if TPDE_PROVIDES_BLOCK_HINTS is true
+  requires !ProvidesBlockHints<T> || requires {
+    {
+      a.block_is_cold(ARG(typename T::IRBlockRef))
+    } -> std::convertible_to<bool>;
+  };
+
+  /// Provides the successor that is most likely executed after a block, which
+  /// is then preferably placed immediately after the block, or
+  /// INVALID_BLOCK_REF if there is no such successor.
+  /// Only needs to be implemented if TPDE_PROVIDES_BLOCK_HINTS is true
+  requires !ProvidesBlockHints<T> || requires {
+    {
+      a.block_likely_succ(ARG(typename T::IRBlockRef))
+    } -> std::convertible_to<typename T::IRBlockRef>;
+  };
+
   /// Provides an iterator over the (non-PHI) instructions in a block
   {
     a.block_insts(ARG(typename T::IRBlockRef))
@@ -324,6 +371,15 @@ concept IRAdaptor = requires(T a) {
   /// Whether to skip the instruction during compilation.
   { a.inst_fused(ARG(typename T::IRInstRef)) } -> std::convertible_to<bool>;
 
+  /// Is the instruction free of side effects, i.e., can it be removed if none
+  /// of its results are used?
+  /// Only needs to be implemented if TPDE_PROVIDES_PURE_INSTS is true
+  requires !ProvidesPureInsts<T> || requires {
+    {
+      a.inst_is_pure(ARG(typename T::IRInstRef))
+    } -> std::convertible_to<bool>;
+  };
+
   /// If logging is enabled, we want to be able to print values and want to
   /// give the adaptor the opportunity to dictate how that is done
   { a.inst_fmt_ref(ARG(typename T::IRInstRef)) } -> CanBeFormatted;
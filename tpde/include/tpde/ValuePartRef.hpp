@@ -165,6 +165,35 @@ public:
 
   bool has_reg() const noexcept { return state.v.reg.valid(); }
 
+  /// Whether the register bits above the part size are known to be zero, i.e.
+  /// whether a zero-extension from the part size is a no-op. Values that are
+  /// not in a register are zero-extended when reloaded from the stack. Always
+  /// false unless CompilerBase::elide_redundant_ext is set.
+  bool upper_bits_zero(const CompilerBase *compiler) const noexcept {
+    if (!compiler->elide_redundant_ext || !has_assignment() ||
+        bank() != Config::GP_BANK || part_size() >= 8) {
+      return false;
+    }
+    auto ap = assignment();
+    if (ap.variable_ref()) {
+      return false;
+    }
+    return !ap.register_valid() || ap.upper_bits_zero();
+  }
+
+  /// Record that the register bits above the part size are zero, e.g. after
+  /// the producing instruction zero-extended the result. The value part must
+  /// have a valid register. Ignored for fixed assignments, whose register is
+  /// also written by PHI moves.
+  void set_upper_bits_zero() noexcept {
+    assert(has_assignment());
+    auto ap = assignment();
+    assert(ap.register_valid());
+    if (!ap.fixed_assignment()) {
+      ap.set_upper_bits_zero(true);
+    }
+  }
+
 private:
   AsmReg alloc_reg_impl(CompilerBase *compiler,
                         u64 exclusion_mask,
@@ -292,7 +321,9 @@ public:
   }
 
   /// Extend integer value, reuse existing register if possible. Constants are
-  /// extended without allocating a register.
+  /// extended without allocating a register. If the extension is a no-op, the
+  /// result can refer to the unmodified value; use into_temporary() to modify
+  /// the register.
   ValuePart into_extended(CompilerBase *compiler,
                           bool sign,
                           u32 from,
@@ -303,16 +334,24 @@ public:
       u64 extended = sign ? util::sext(val, from) : util::zext(val, from);
       return ValuePart{extended, (to + 7) / 8, state.c.bank};
     }
+    // Zero-extending a value whose upper bits are already known to be zero is
+    // a no-op, so keep the register (and the assignment if it is still live).
+    bool is_extended =
+        !sign && from == part_size() * 8 && upper_bits_zero(compiler);
     ValuePart res{bank()};
     Reg src_reg = has_reg() ? cur_reg() : load_to_reg(compiler);
     if (can_salvage()) {
       res.set_value(compiler, std::move(*this));
       assert(src_reg == res.cur_reg());
+    } else if (is_extended) {
+      return std::move(*this);
     } else {
       res.alloc_reg(compiler);
     }
-    compiler->derived()->generate_raw_intext(
-        res.cur_reg(), src_reg, sign, from, to);
+    if (!is_extended) {
+      compiler->derived()->generate_raw_intext(
+          res.cur_reg(), src_reg, sign, from, to);
+    }
     return res;
   }
 
@@ -432,6 +471,8 @@ typename CompilerBase<Adaptor, Derived, Config>::AsmReg
 
     if (reload) {
       compiler->derived()->reload_to_reg(reg, ap);
+      // Reloads from the stack zero-extend to the full register.
+      ap.set_upper_bits_zero(!ap.variable_ref());
     } else {
       assert(!ap.stack_valid() && "alloc_reg called on initialized value");
     }
@@ -479,8 +520,10 @@ typename CompilerBase<Adaptor, Derived, Config>::AsmReg
     reg_file.mark_used(reg, state.v.local_idx, state.v.part);
     auto ap = assignment();
     auto old_reg = AsmReg::make_invalid();
+    bool upper_zero = false;
     if (ap.register_valid()) {
       old_reg = ap.get_reg();
+      upper_zero = ap.upper_bits_zero();
     }
 
     ap.set_reg(reg);
@@ -494,8 +537,10 @@ typename CompilerBase<Adaptor, Derived, Config>::AsmReg
       if (old_reg.valid()) {
         compiler->derived()->mov(reg, old_reg, ap.part_size());
         reg_file.unmark_used(old_reg);
+        ap.set_upper_bits_zero(upper_zero);
       } else {
         compiler->derived()->reload_to_reg(reg, ap);
+        ap.set_upper_bits_zero(!ap.variable_ref());
       }
     } else {
       assert(!ap.stack_valid() && "alloc_reg with valid stack slot");
@@ -888,6 +933,10 @@ struct CompilerBase<Adaptor, Derived, Config>::ValuePartRef : ValuePart {
                             .into_extended(compiler, sign, from, to)};
   }
 
+  bool upper_bits_zero() const noexcept {
+    return ValuePart::upper_bits_zero(compiler);
+  }
+
   void lock() noexcept { ValuePart::lock(compiler); }
   void unlock() noexcept { ValuePart::unlock(compiler); }
 
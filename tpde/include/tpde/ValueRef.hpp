@@ -101,6 +101,12 @@ public:
     return state.a.assignment;
   }
 
+  /// Whether this is the last use of the value, i.e., the assignment is
+  /// released when the reference is reset.
+  bool is_owned() const noexcept {
+    return has_assignment() && state.a.mode == 2;
+  }
+
   /// Convert into an unowned reference; must be called before first part is
   /// accessed.
   void disown() noexcept {
@@ -162,6 +162,7 @@ constexpr static u64 create_bitmask(const std::array<AsmReg, N> regs) {
 }
 
 class CCAssignerAAPCS : public CCAssigner {
+public:
   static constexpr CCInfo Info{
       // we reserve SP,FP,R16 and R17 for our special use cases
       .allocatable_regs =
@@ -209,12 +210,16 @@ class CCAssignerAAPCS : public CCAssigner {
       }),
   };
 
+private:
   // NGRN = Next General-purpose Register Number
   // NSRN = Next SIMD/FP Register Number
   // NSAA = Next Stack Argument Address
   u32 ngrn = 0, nsrn = 0, nsaa = 0;
   u32 ret_ngrn = 0, ret_nsrn = 0;
 
+protected:
+  CCAssignerAAPCS(const CCInfo &info) noexcept : CCAssigner(info) {}
+
 public:
   CCAssignerAAPCS() noexcept : CCAssigner(Info) {}
 
@@ -287,6 +292,114 @@ public:
   }
 };
 
+/// preserve_mostcc: argument passing like AAPCS, but the callee additionally
+/// preserves x9-x15. Vector registers are handled like AAPCS.
+class CCAssignerPreserveMost : public CCAssignerAAPCS {
+public:
+  static constexpr CCInfo Info{
+      .allocatable_regs = CCAssignerAAPCS::Info.allocatable_regs,
+      .callee_saved_regs = CCAssignerAAPCS::Info.callee_saved_regs |
+                           create_bitmask({
+                               AsmReg::R9,
+                               AsmReg::R10,
+                               AsmReg::R11,
+                               AsmReg::R12,
+                               AsmReg::R13,
+                               AsmReg::R14,
+                               AsmReg::R15,
+                           }),
+      .arg_regs = CCAssignerAAPCS::Info.arg_regs,
+  };
+
+  CCAssignerPreserveMost() noexcept : CCAssignerAAPCS(Info) {}
+};
+
+/// preserve_allcc: like preserve_mostcc, but the callee additionally preserves
+/// the lower 128 bits of v8-v31.
+class CCAssignerPreserveAll : public CCAssignerAAPCS {
+public:
+  static constexpr CCInfo Info{
+      .allocatable_regs = CCAssignerAAPCS::Info.allocatable_regs,
+      .callee_saved_regs = CCAssignerPreserveMost::Info.callee_saved_regs |
+                           (u64{0xFFFF'FF00} << AsmReg::V0),
+      .arg_regs = CCAssignerAAPCS::Info.arg_regs,
+  };
+
+  CCAssignerPreserveAll() noexcept : CCAssignerAAPCS(Info) {}
+};
+
+/// Private calling convention for functions where all callers are known, i.e.
+/// caller and callee are both compiled by us. Arguments and return values use
+/// x0-x15, v0-v7 and v16-v31 and multi-part values can be split between
+/// registers and stack. Stack slots of general-purpose parts are not padded to
+/// the alignment of the value, vector parts are aligned to their size like for
+/// AAPCS. sret pointers are passed like other arguments. Callee-saved
+/// registers are the same as for AAPCS and registers are assigned in the same
+/// order, so unwinding and tail calls work unchanged.
+class CCAssignerPrivate : public CCAssigner {
+public:
+  static constexpr CCInfo Info{
+      .allocatable_regs = CCAssignerAAPCS::Info.allocatable_regs,
+      .callee_saved_regs = CCAssignerAAPCS::Info.callee_saved_regs,
+      .arg_regs = 0xFFFF | (u64{0xFFFF'00FF} << AsmReg::V0),
+  };
+
+private:
+  static constexpr u32 NumGP = 16, NumV = 24;
+
+  u32 ngrn = 0, nsrn = 0, nsaa = 0;
+  u32 ret_ngrn = 0, ret_nsrn = 0;
+
+  static Reg vec_reg(u32 idx) noexcept {
+    // Skip v8-v15, which are callee-saved.
+    return Reg{idx < 8 ? AsmReg::V0 + idx : AsmReg::V16 + (idx - 8)};
+  }
+
+public:
+  CCAssignerPrivate() noexcept : CCAssigner(Info) {}
+
+  void reset() noexcept override {
+    ngrn = nsrn = nsaa = ret_ngrn = ret_nsrn = 0;
+  }
+
+  void assign_arg(CCAssignment &arg) noexcept override {
+    if (arg.byval) [[unlikely]] {
+      nsaa = util::align_up(nsaa, arg.align < 8 ? 8 : arg.align);
+      arg.stack_off = nsaa;
+      nsaa += arg.size;
+      return;
+    }
+
+    if (arg.bank == RegBank{0}) {
+      if (ngrn < NumGP) {
+        arg.reg = Reg{AsmReg::R0 + ngrn++};
+        return;
+      }
+    } else if (nsrn < NumV) {
+      arg.reg = vec_reg(nsrn++);
+      return;
+    }
+
+    u32 size = util::align_up(arg.size, 8);
+    nsaa = util::align_up(nsaa, size);
+    arg.stack_off = nsaa;
+    nsaa += size;
+  }
+
+  u32 get_stack_size() noexcept override { return nsaa; }
+
+  void assign_ret(CCAssignment &arg) noexcept override {
+    assert(!arg.byval && !arg.sret);
+    if (arg.bank == RegBank{0}) {
+      assert(ret_ngrn < NumGP);
+      arg.reg = Reg{AsmReg::R0 + ret_ngrn++};
+    } else {
+      assert(ret_nsrn < NumV);
+      arg.reg = vec_reg(ret_nsrn++);
+    }
+  }
+};
+
 struct PlatformConfig : CompilerConfigDefault {
   using Assembler = AssemblerElfA64;
   using AsmReg = tpde::a64::AsmReg;
@@ -369,6 +482,8 @@ struct CompilerA64 : BaseTy<Adaptor, Derived, Config> {
   u32 scalar_arg_count = 0xFFFF'FFFF, vec_arg_count = 0xFFFF'FFFF;
   u32 reg_save_frame_off = 0;
   util::SmallVector<u32, 8> func_ret_offs = {};
+  /// Offsets of epilogues without ret preceding a tail call.
+  util::SmallVector<u32, 4> func_tail_call_offs = {};
 
   class CallBuilder : public Base::template CallBuilderBase<CallBuilder> {
     u32 stack_adjust_off = 0;
@@ -384,6 +499,7 @@ struct CompilerA64 : BaseTy<Adaptor, Derived, Config> {
     void add_arg_byval(ValuePart &vp, CCAssignment &cca) noexcept;
     void add_arg_stack(ValuePart &vp, CCAssignment &cca) noexcept;
     void call_impl(std::variant<SymRef, ValuePart> &&) noexcept;
+    void tail_call_impl(std::variant<SymRef, ValuePart> &&) noexcept;
     void reset_stack() noexcept;
   };
 
@@ -406,7 +522,9 @@ struct CompilerA64 : BaseTy<Adaptor, Derived, Config> {
 
   // helpers
 
-  void gen_func_epilog() noexcept;
+  /// Reserve space for the epilogue, which is written in finish_func. For tail
+  /// calls, the final ret is omitted and the caller emits the branch.
+  void gen_func_epilog(bool tail_call = false) noexcept;
 
   void
       spill_reg(const AsmReg reg, const u32 frame_off, const u32 size) noexcept;
@@ -641,8 +759,8 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::CallBuilder::call_impl(
     std::variant<SymRef, ValuePart> &&target) noexcept {
   u32 sub = 0;
   if (stack_adjust_off != 0) {
-    auto *text_data = this->compiler.text_writer.begin_ptr();
-    u32 *write_ptr = reinterpret_cast<u32 *>(text_data + stack_adjust_off);
+    u32 *write_ptr = reinterpret_cast<u32 *>(
+        this->compiler.text_writer.data_ptr(stack_adjust_off));
     u32 stack_size = this->assigner.get_stack_size();
     sub = util::align_up(stack_size, stack_size < 0x1000 ? 0x10 : 0x1000);
     *write_ptr = de64_SUBxi(DA_SP, DA_SP, sub);
@@ -651,7 +769,8 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::CallBuilder::call_impl(
   }
 
   // For vector registers, only the lowest half is callee-saved. Evict all
-  // value parts larger than 8 bytes.
+  // value parts larger than 8 bytes. (preserve_all preserves the lowest 128
+  // bits, but this is rare enough to not warrant special handling.)
   auto fp_regs = RegisterFile::bank_regs(Config::FP_BANK);
   auto fp_csrs = fp_regs & this->assigner.get_ccinfo().callee_saved_regs;
   auto used_fp_csrs = fp_csrs & this->compiler.register_file.used;
@@ -686,6 +805,32 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::CallBuilder::call_impl(
   }
 }
 
+template <IRAdaptor Adaptor,
+          typename Derived,
+          template <typename, typename, typename> class BaseTy,
+          typename Config>
+void CompilerA64<Adaptor, Derived, BaseTy, Config>::CallBuilder::
+    tail_call_impl(std::variant<SymRef, ValuePart> &&target) noexcept {
+  assert(stack_adjust_off == 0 && "tail call with stack arguments");
+
+  if (auto *sym = std::get_if<SymRef>(&target)) {
+    this->compiler.gen_func_epilog(/*tail_call=*/true);
+    ASMC(&this->compiler, B, 0);
+    this->compiler.reloc_text(
+        *sym, R_AARCH64_JUMP26, this->compiler.text_writer.offset() - 4);
+    return;
+  }
+
+  // The epilogue restores callee-saved registers, so move the target into the
+  // permanent scratch register, which is never allocated.
+  ValuePart &tvp = std::get<ValuePart>(target);
+  AsmReg reg = this->compiler.permanent_scratch_reg;
+  tvp.reload_into_specific_fixed(&this->compiler, reg);
+  tvp.reset(&this->compiler);
+  this->compiler.gen_func_epilog(/*tail_call=*/true);
+  ASMC(&this->compiler, BR, reg);
+}
+
 template <IRAdaptor Adaptor,
           typename Derived,
           template <typename, typename, typename> class BaseTy,
@@ -719,6 +864,7 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::gen_func_prolog_and_args(
   // as otherwise stack accesses need to skip the reg-save area
 
   func_ret_offs.clear();
+  func_tail_call_offs.clear();
   func_start_off = this->text_writer.offset();
 
   const CCInfo &cc_info = cc_assigner->get_ccinfo();
@@ -979,15 +1125,15 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::finish_func(
 
     // Shrink function at the beginning
     u32 skip = util::align_down(func_prologue_alloc - prologue.size() * 4, 16);
-    std::memset(this->text_writer.begin_ptr() + func_start_off, 0, skip);
+    std::memset(this->text_writer.data_ptr(func_start_off), 0, skip);
     func_start_off += skip;
-    std::memcpy(this->text_writer.begin_ptr() + func_start_off,
+    std::memcpy(this->text_writer.data_ptr(func_start_off),
                 prologue.data(),
                 prologue.size() * sizeof(u32));
   }
 
   if (func_arg_stack_add_off != ~0u) {
-    auto *inst_ptr = this->text_writer.begin_ptr() + func_arg_stack_add_off;
+    auto *inst_ptr = this->text_writer.data_ptr(func_arg_stack_add_off);
     *reinterpret_cast<u32 *>(inst_ptr) =
         de64_ADDxi(func_arg_stack_add_reg, DA_SP, final_frame_size);
   }
@@ -996,8 +1142,8 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::finish_func(
   auto func_sym = this->func_syms[func_idx];
   auto func_sec = this->text_writer.get_sec_ref();
 
-  if (func_ret_offs.empty()) {
-    auto func_size = this->text_writer.offset() - func_start_off;
+  if (func_ret_offs.empty() && func_tail_call_offs.empty()) {
+    auto func_size = this->text_writer.hot_end_offset() - func_start_off;
     this->assembler.sym_def(func_sym, func_sec, func_start_off, func_size);
     this->assembler.eh_end_fde(fde_off, func_sym);
     this->assembler.except_encode_func(func_sym,
@@ -1005,16 +1151,16 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::finish_func(
     return;
   }
 
-  auto *text_data = this->text_writer.begin_ptr();
-  u32 first_ret_off = func_ret_offs[0];
+  // Generate the epilogue once and copy it to all return sites. Tail calls use
+  // the same sequence without the final ret.
+  util::SmallVector<u32, 16> epilogue;
+  u32 restore_size = 0;
   u32 ret_size = 0;
   {
-    u32 *write_ptr = reinterpret_cast<u32 *>(text_data + first_ret_off);
-    const auto ret_start = write_ptr;
     if (dyn_alloca) {
-      *write_ptr++ = de64_MOV_SPx(DA_SP, DA_GP(29));
+      epilogue.push_back(de64_MOV_SPx(DA_SP, DA_GP(29)));
     } else {
-      *write_ptr++ = de64_LDPx(DA_GP(29), DA_GP(30), DA_SP, 0);
+      epilogue.push_back(de64_LDPx(DA_GP(29), DA_GP(30), DA_SP, 0));
     }
 
     AsmReg last_reg = AsmReg::make_invalid();
@@ -1025,17 +1171,17 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::finish_func(
         const auto last_bank = this->register_file.reg_bank(last_reg);
         if (reg_bank == last_bank) {
           if (reg_bank == Config::GP_BANK) {
-            *write_ptr++ =
-                de64_LDPx(last_reg, AsmReg{reg}, stack_reg, frame_off);
+            epilogue.push_back(
+                de64_LDPx(last_reg, AsmReg{reg}, stack_reg, frame_off));
           } else {
-            *write_ptr++ =
-                de64_LDPd(last_reg, AsmReg{reg}, stack_reg, frame_off);
+            epilogue.push_back(
+                de64_LDPd(last_reg, AsmReg{reg}, stack_reg, frame_off));
           }
           frame_off += 16;
           last_reg = AsmReg::make_invalid();
         } else {
           assert(last_bank == Config::GP_BANK && reg_bank == Config::FP_BANK);
-          *write_ptr++ = de64_LDRxu(last_reg, stack_reg, frame_off);
+          epilogue.push_back(de64_LDRxu(last_reg, stack_reg, frame_off));
           frame_off += 8;
           last_reg = AsmReg{reg};
         }
@@ -1047,36 +1193,51 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::finish_func(
 
     if (last_reg.valid()) {
       if (this->register_file.reg_bank(last_reg) == Config::GP_BANK) {
-        *write_ptr++ = de64_LDRxu(last_reg, stack_reg, frame_off);
+        epilogue.push_back(de64_LDRxu(last_reg, stack_reg, frame_off));
       } else {
-        *write_ptr++ = de64_LDRdu(last_reg, stack_reg, frame_off);
+        epilogue.push_back(de64_LDRdu(last_reg, stack_reg, frame_off));
       }
     }
 
     if (dyn_alloca) {
-      *write_ptr++ = de64_LDPx(DA_GP(29), DA_GP(30), DA_SP, 0);
+      epilogue.push_back(de64_LDPx(DA_GP(29), DA_GP(30), DA_SP, 0));
     }
 
-    *write_ptr++ = de64_ADDxi(DA_SP, DA_SP, final_frame_size);
-    *write_ptr++ = de64_RET(DA_GP(30));
+    epilogue.push_back(de64_ADDxi(DA_SP, DA_SP, final_frame_size));
+    restore_size = epilogue.size() * 4;
+    epilogue.push_back(de64_RET(DA_GP(30)));
 
-    ret_size = (write_ptr - ret_start) * 4;
+    ret_size = epilogue.size() * 4;
     assert(ret_size <= func_epilogue_alloc);
-    std::memset(write_ptr, 0, func_epilogue_alloc - ret_size);
   }
 
-  for (u32 i = 1; i < func_ret_offs.size(); ++i) {
-    std::memcpy(text_data + func_ret_offs[i],
-                text_data + first_ret_off,
-                func_epilogue_alloc);
+  for (u32 ret_off : func_ret_offs) {
+    u8 *ret_ptr = this->text_writer.data_ptr(ret_off);
+    std::memcpy(ret_ptr, epilogue.data(), ret_size);
+    std::memset(ret_ptr + ret_size, 0, func_epilogue_alloc - ret_size);
+  }
+
+  // The branch follows the reserved space, skip over the padding.
+  for (u32 tail_off : func_tail_call_offs) {
+    u32 *write_ptr =
+        reinterpret_cast<u32 *>(this->text_writer.data_ptr(tail_off));
+    std::memcpy(write_ptr, epilogue.data(), restore_size);
+    u32 pad_count = (func_epilogue_alloc - 4 - restore_size) / 4;
+    u32 *pad_ptr = write_ptr + restore_size / 4;
+    for (u32 i = 0; i < pad_count; ++i) {
+      pad_ptr[i] = de64_NOP();
+    }
+    if (pad_count > 1) {
+      pad_ptr[0] = de64_B(pad_count);
+    }
   }
 
   u32 func_end_ret_off = this->text_writer.offset() - func_epilogue_alloc;
-  if (func_ret_offs.back() == func_end_ret_off) {
+  if (!func_ret_offs.empty() && func_ret_offs.back() == func_end_ret_off) {
     this->text_writer.cur_ptr() -= func_epilogue_alloc - ret_size;
   }
 
-  auto func_size = this->text_writer.offset() - func_start_off;
+  auto func_size = this->text_writer.hot_end_offset() - func_start_off;
   this->assembler.sym_def(func_sym, func_sec, func_start_off, func_size);
   this->assembler.eh_end_fde(fde_off, func_sym);
   this->assembler.except_encode_func(func_sym,
@@ -1089,6 +1250,7 @@ template <IRAdaptor Adaptor,
           typename Config>
 void CompilerA64<Adaptor, Derived, BaseTy, Config>::reset() noexcept {
   func_ret_offs.clear();
+  func_tail_call_offs.clear();
   Base::reset();
 }
 
@@ -1096,7 +1258,8 @@ template <IRAdaptor Adaptor,
           typename Derived,
           template <typename, typename, typename> typename BaseTy,
           typename Config>
-void CompilerA64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog() noexcept {
+void CompilerA64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog(
+    bool tail_call) noexcept {
   // epilogue:
   // if !func_has_dynamic_alloca:
   //   ldp x29, x30, [sp]
@@ -1110,11 +1273,18 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog() noexcept {
   // if func_has_dynamic_alloca:
   //   ldp x29, x30, [sp]
   // add sp, sp, #<frame_size>
-  // ret
+  // ret (omitted for tail calls)
   //
   // however, since we will later patch this, we only
   // reserve the space for now
 
+  if (tail_call) {
+    func_tail_call_offs.push_back(this->text_writer.offset());
+    this->text_writer.ensure_space(func_epilogue_alloc);
+    this->text_writer.cur_ptr() += func_epilogue_alloc - 4;
+    return;
+  }
+
   func_ret_offs.push_back(this->text_writer.offset());
   this->text_writer.ensure_space(func_epilogue_alloc);
   this->text_writer.cur_ptr() += func_epilogue_alloc;
@@ -1480,10 +1650,10 @@ void CompilerA64<Adaptor, Derived, BaseTy, Config>::materialize_constant(
       return;
     }
 
-    auto rodata = this->assembler.get_data_section(true, false);
-    std::span<const u8> raw_data{reinterpret_cast<const u8 *>(data), size};
-    auto sym = this->assembler.sym_def_data(
-        rodata, "", raw_data, 16, Assembler::SymBinding::LOCAL);
+    // Constants are deduplicated in the mergeable constant section.
+    u8 raw_data[16] = {};
+    std::memcpy(raw_data, data, size);
+    auto sym = this->assembler.sym_def_const(raw_data);
     this->text_writer.ensure_space(8); // ensure contiguous instructions
     this->reloc_text(
         sym, R_AARCH64_ADR_PREL_PG_HI21, this->text_writer.offset(), 0);
@@ -4,6 +4,7 @@
 
 #include "tpde/FunctionWriter.hpp"
 #include <disarm64.h>
+#include <elf.h>
 
 namespace tpde::a64 {
 
@@ -24,6 +25,8 @@ public:
 
   void more_space(u32 size) noexcept;
 
+  void begin_cold() noexcept;
+
   bool try_write_inst(u32 inst) noexcept {
     if (inst == 0) {
       return false;
@@ -53,6 +56,10 @@ public:
 
 private:
   void handle_fixups() noexcept;
+
+  void handle_cold_fixup(Assembler &assembler,
+                         const LabelFixup &fixup,
+                         SymRef cold_sym) noexcept;
 };
 
 inline void FunctionWriterA64::more_space(u32 size) noexcept {
@@ -90,10 +97,31 @@ inline void FunctionWriterA64::more_space(u32 size) noexcept {
   cur_ptr() += veneer_size + 4;
 }
 
+inline void FunctionWriterA64::begin_cold() noexcept {
+  // Conditional branches can't reach another section, so redirect pending
+  // conditional branches into the cold part to a branch placed here.
+  for (u32 i = 0, n = label_fixups.size(); i < n; ++i) {
+    const LabelFixup fixup = label_fixups[i];
+    if (!label_is_pending(fixup.label) ||
+        (fixup.kind != LabelFixupKind::AARCH64_COND_BR &&
+         fixup.kind != LabelFixupKind::AARCH64_TEST_BR)) {
+      continue;
+    }
+    ensure_space(4);
+    Label stub = label_create();
+    label_place(stub, offset());
+    write_inst_unchecked(de64_B(0));
+    FunctionWriter::label_ref(
+        fixup.label, offset() - 4, LabelFixupKind::AARCH64_BR);
+    label_fixups[i].label = stub;
+  }
+  FunctionWriter::begin_cold();
+}
+
 inline void FunctionWriterA64::handle_fixups() noexcept {
   for (const LabelFixup &fixup : label_fixups) {
     u32 label_off = label_offset(fixup.label);
-    u32 *dst_ptr = reinterpret_cast<u32 *>(begin_ptr() + fixup.off);
+    u32 *dst_ptr = reinterpret_cast<u32 *>(data_ptr(fixup.off));
 
     auto fix_condbr = [&](unsigned nbits) {
       i64 diff = i64(label_off) - i64(fixup.off);
@@ -105,7 +133,7 @@ inline void FunctionWriterA64::handle_fixups() noexcept {
         assert(veneer != veneers.end());
 
         // Create intermediate branch at v.begin
-        auto *br = reinterpret_cast<u32 *>(begin_ptr() + *veneer);
+        auto *br = reinterpret_cast<u32 *>(data_ptr(*veneer));
         assert(*br == 0 && "overwriting instructions with veneer branch");
         *br = de64_B((label_off - *veneer) / 4);
         diff = *veneer - fixup.off;
@@ -147,4 +175,29 @@ inline void FunctionWriterA64::handle_fixups() noexcept {
   }
 }
 
+inline void FunctionWriterA64::handle_cold_fixup(Assembler &assembler,
+                                                 const LabelFixup &fixup,
+                                                 SymRef cold_sym) noexcept {
+  u32 label_off = label_offset(fixup.label);
+  u32 *dst_ptr = reinterpret_cast<u32 *>(data_ptr(fixup.off));
+  i64 addend = i64(label_off) - i64(cold_off);
+  switch (fixup.kind) {
+  case LabelFixupKind::AARCH64_BR:
+    *dst_ptr = de64_B(0);
+    assembler.reloc_sec(
+        get_sec_ref(), cold_sym, R_AARCH64_JUMP26, fixup.off, addend);
+    break;
+  case LabelFixupKind::AARCH64_JUMP_TABLE: {
+    // The entry is relative to the table, not to the entry itself.
+    i32 diff = *dst_ptr;
+    addend += fixup.off - (label_off - diff);
+    *dst_ptr = 0;
+    assembler.reloc_pc32(get_sec_ref(), cold_sym, fixup.off, addend);
+    break;
+  }
+  // begin_cold redirected all conditional branches.
+  default: TPDE_UNREACHABLE("unexpected label fixup kind");
+  }
+}
+
 } // namespace tpde::a64
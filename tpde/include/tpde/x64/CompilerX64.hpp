@@ -159,6 +159,10 @@ private:
   bool vararg;
   u32 ret_gp_cnt = 0, ret_xmm_cnt = 0;
 
+protected:
+  CCAssignerSysV(const CCInfo &info, bool vararg) noexcept
+      : CCAssigner(info), vararg(vararg) {}
+
 public:
   CCAssignerSysV(bool vararg = false) noexcept
       : CCAssigner(Info), vararg(vararg) {}
@@ -242,6 +246,132 @@ public:
   }
 };
 
+/// preserve_mostcc: argument passing like SysV, but the callee preserves all
+/// general-purpose registers except r11 and the return registers. Vector
+/// registers are clobbered.
+class CCAssignerPreserveMost : public CCAssignerSysV {
+public:
+  static constexpr CCInfo Info{
+      .allocatable_regs = CCAssignerSysV::Info.allocatable_regs,
+      .callee_saved_regs =
+          0xFFFF & ~create_bitmask({AsmReg::AX,
+                                    AsmReg::DX,
+                                    AsmReg::SP,
+                                    AsmReg::BP,
+                                    AsmReg::R11}),
+      .arg_regs = CCAssignerSysV::Info.arg_regs,
+  };
+
+  CCAssignerPreserveMost(bool vararg = false) noexcept
+      : CCAssignerSysV(Info, vararg) {}
+};
+
+/// preserve_allcc: like preserve_mostcc, but the callee additionally preserves
+/// all vector registers except the return registers.
+class CCAssignerPreserveAll : public CCAssignerSysV {
+public:
+  static constexpr CCInfo Info{
+      .allocatable_regs = CCAssignerSysV::Info.allocatable_regs,
+      .callee_saved_regs =
+          (CCAssignerPreserveMost::Info.callee_saved_regs | 0xFFFF'0000'0000) &
+          ~create_bitmask({AsmReg::XMM0, AsmReg::XMM1}),
+      .arg_regs = CCAssignerSysV::Info.arg_regs,
+  };
+
+  CCAssignerPreserveAll(bool vararg = false) noexcept
+      : CCAssignerSysV(Info, vararg) {}
+};
+
+/// Private calling convention for functions where all callers are known, i.e.
+/// caller and callee are both compiled by us. Arguments and return values use
+/// all caller-saved registers and multi-part values can be split between
+/// registers and stack. Stack slots of general-purpose parts are not padded to
+/// the alignment of the value, vector parts are aligned to their size like for
+/// SysV. Functions whose return value needs more than the nine GP or 16 vector
+/// return registers must use SysV instead. Callee-saved registers and the
+/// first two return registers of each bank are the same as for SysV, so
+/// unwinding and tail calls work unchanged.
+class CCAssignerPrivate : public CCAssigner {
+  static constexpr std::array<AsmReg, 9> gp_regs{
+      AsmReg::DI,
+      AsmReg::SI,
+      AsmReg::DX,
+      AsmReg::CX,
+      AsmReg::R8,
+      AsmReg::R9,
+      AsmReg::AX,
+      AsmReg::R10,
+      AsmReg::R11,
+  };
+  static constexpr std::array<AsmReg, 9> gp_ret_regs{
+      AsmReg::AX,
+      AsmReg::DX,
+      AsmReg::CX,
+      AsmReg::SI,
+      AsmReg::DI,
+      AsmReg::R8,
+      AsmReg::R9,
+      AsmReg::R10,
+      AsmReg::R11,
+  };
+
+public:
+  static constexpr CCInfo Info{
+      .allocatable_regs = CCAssignerSysV::Info.allocatable_regs,
+      .callee_saved_regs = CCAssignerSysV::Info.callee_saved_regs,
+      .arg_regs = create_bitmask(gp_regs) | 0xFFFF'0000'0000,
+  };
+
+private:
+  u32 gp_cnt = 0, xmm_cnt = 0, stack = 0;
+  u32 ret_gp_cnt = 0, ret_xmm_cnt = 0;
+
+public:
+  CCAssignerPrivate() noexcept : CCAssigner(Info) {}
+
+  void reset() noexcept override {
+    gp_cnt = xmm_cnt = stack = 0;
+    ret_gp_cnt = ret_xmm_cnt = 0;
+  }
+
+  void assign_arg(CCAssignment &arg) noexcept override {
+    if (arg.byval) {
+      stack = util::align_up(stack, arg.align < 8 ? 8 : arg.align);
+      arg.stack_off = stack;
+      stack += arg.size;
+      return;
+    }
+
+    if (arg.bank == RegBank{0}) {
+      if (gp_cnt < gp_regs.size()) {
+        arg.reg = gp_regs[gp_cnt++];
+        return;
+      }
+    } else if (xmm_cnt < 16) {
+      arg.reg = Reg{AsmReg::XMM0 + xmm_cnt++};
+      return;
+    }
+
+    u32 size = util::align_up(arg.size, 8);
+    stack = util::align_up(stack, size);
+    arg.stack_off = stack;
+    stack += size;
+  }
+
+  u32 get_stack_size() noexcept override { return stack; }
+
+  void assign_ret(CCAssignment &arg) noexcept override {
+    assert(!arg.byval && !arg.sret);
+    if (arg.bank == RegBank{0}) {
+      assert(ret_gp_cnt < gp_ret_regs.size());
+      arg.reg = gp_ret_regs[ret_gp_cnt++];
+    } else {
+      assert(ret_xmm_cnt < 16);
+      arg.reg = Reg{AsmReg::XMM0 + ret_xmm_cnt++};
+    }
+  }
+};
+
 struct PlatformConfig : CompilerConfigDefault {
   using Assembler = AssemblerElfX64;
   using AsmReg = tpde::x64::AsmReg;
@@ -349,6 +479,8 @@ struct CompilerX64 : BaseTy<Adaptor, Derived, Config> {
   u32 reg_save_frame_off = 0;
   u32 var_arg_stack_off = 0;
   util::SmallVector<u32, 8> func_ret_offs = {};
+  /// Offsets of epilogues without ret preceding a tail call.
+  util::SmallVector<u32, 4> func_tail_call_offs = {};
 
   /// Symbol for __tls_get_addr.
   SymRef sym_tls_get_addr;
@@ -357,6 +489,8 @@ struct CompilerX64 : BaseTy<Adaptor, Derived, Config> {
     u32 stack_adjust_off = 0;
 
     void set_stack_used() noexcept;
+    /// For vararg calls, set al to the upper bound of used vector registers.
+    void set_vararg_vec_count() noexcept;
 
   public:
     CallBuilder(Derived &compiler, CCAssigner &assigner) noexcept
@@ -365,6 +499,7 @@ struct CompilerX64 : BaseTy<Adaptor, Derived, Config> {
     void add_arg_byval(ValuePart &vp, CCAssignment &cca) noexcept;
     void add_arg_stack(ValuePart &vp, CCAssignment &cca) noexcept;
     void call_impl(std::variant<SymRef, ValuePart> &&target) noexcept;
+    void tail_call_impl(std::variant<SymRef, ValuePart> &&target) noexcept;
     void reset_stack() noexcept;
   };
 
@@ -403,7 +538,9 @@ struct CompilerX64 : BaseTy<Adaptor, Derived, Config> {
 
   // helpers
 
-  void gen_func_epilog() noexcept;
+  /// Reserve space for the epilogue, which is written in finish_func. For tail
+  /// calls, the final ret is omitted and the caller emits the jump.
+  void gen_func_epilog(bool tail_call = false) noexcept;
 
   void
       spill_reg(const AsmReg reg, const i32 frame_off, const u32 size) noexcept;
@@ -424,6 +561,11 @@ struct CompilerX64 : BaseTy<Adaptor, Derived, Config> {
 
   AsmReg gval_expr_as_reg(GenericValuePart &gv) noexcept;
 
+  /// Get a memory operand for the address in gv. The address is only
+  /// materialized into a register if it can't be encoded directly; the
+  /// registers stay valid as long as gv is alive.
+  FeMem gval_as_mem(GenericValuePart &gv) noexcept;
+
   /// Dynamic alloca of a fixed-size region.
   void alloca_fixed(u64 size, u32 align, ValuePart &res) noexcept;
 
@@ -541,6 +683,7 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::gen_func_prolog_and_args(
   // calls into account
 
   func_ret_offs.clear();
+  func_tail_call_offs.clear();
   func_start_off = this->text_writer.offset();
   scalar_arg_count = vec_arg_count = 0xFFFF'FFFF;
 
@@ -697,7 +840,7 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
   auto fde_prologue_adv_off = this->assembler.eh_writer.size();
   this->assembler.eh_write_inst(dwarf::DW_CFA_advance_loc, 0);
 
-  auto *write_ptr = this->text_writer.begin_ptr() + func_reg_save_off;
+  auto *write_ptr = this->text_writer.data_ptr(func_reg_save_off);
   auto csr = derived()->cur_cc_assigner()->get_ccinfo().callee_saved_regs;
   u64 saved_regs = this->register_file.clobbered & csr;
   u32 num_saved_regs = 0u;
@@ -733,8 +876,7 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
     this->assembler.eh_write_inst(dwarf::DW_CFA_offset, dwarf_reg, cfa_off);
   }
 
-  u32 prologue_size =
-      write_ptr - (this->text_writer.begin_ptr() + func_start_off);
+  u32 prologue_size = write_ptr - this->text_writer.data_ptr(func_start_off);
   assert(prologue_size < 0x44);
   this->assembler.eh_writer.data()[fde_prologue_adv_off] =
       dwarf::DW_CFA_advance_loc | (prologue_size - 4);
@@ -743,11 +885,12 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
   // the stack space we used for the saved registers
   const auto final_frame_size =
       util::align_up(this->stack.frame_size, 16) - num_saved_regs * 8;
-  *reinterpret_cast<u32 *>(this->text_writer.begin_ptr() +
-                           frame_size_setup_offset + 3) = final_frame_size;
+  *reinterpret_cast<u32 *>(
+      this->text_writer.data_ptr(frame_size_setup_offset) + 3) =
+      final_frame_size;
 #ifdef TPDE_ASSERTS
   FdInstr instr = {};
-  assert(fd_decode(this->text_writer.begin_ptr() + frame_size_setup_offset,
+  assert(fd_decode(this->text_writer.data_ptr(frame_size_setup_offset),
                    7,
                    64,
                    0,
@@ -762,7 +905,7 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
 
   // nop out the rest
   const auto reg_save_end =
-      this->text_writer.begin_ptr() + func_reg_save_off + func_reg_save_alloc;
+      this->text_writer.data_ptr(func_reg_save_off) + func_reg_save_alloc;
   assert(reg_save_end >= write_ptr);
   const u32 nop_len = reg_save_end - write_ptr;
   if (nop_len) {
@@ -771,9 +914,9 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
 
   auto func_sym = this->func_syms[func_idx];
   auto func_sec = this->text_writer.get_sec_ref();
-  if (func_ret_offs.empty()) {
+  if (func_ret_offs.empty() && func_tail_call_offs.empty()) {
     // TODO(ts): honor cur_needs_unwind_info
-    auto func_size = this->text_writer.offset() - func_start_off;
+    auto func_size = this->text_writer.hot_end_offset() - func_start_off;
     this->assembler.sym_def(func_sym, func_sec, func_start_off, func_size);
     this->assembler.eh_end_fde(fde_off, func_sym);
     this->assembler.except_encode_func(func_sym,
@@ -781,14 +924,15 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
     return;
   }
 
-  auto *text_data = this->text_writer.begin_ptr();
-  u32 first_ret_off = func_ret_offs[0];
+  // Generate the epilogue once and copy it to all return sites. Tail calls use
+  // the same sequence without the final ret.
+  u8 epilogue[64];
+  u32 restore_size = 0;
   u32 ret_size = 0;
   u32 epilogue_size = 7 + 1 + 1 + func_reg_restore_alloc; // add + pop + ret
-  u32 func_end_ret_off = this->text_writer.offset() - epilogue_size;
+  assert(epilogue_size <= sizeof(epilogue));
   {
-    write_ptr = text_data + first_ret_off;
-    const auto ret_start = write_ptr;
+    write_ptr = epilogue;
     if (this->adaptor->cur_has_dynamic_alloca()) {
       if (num_saved_regs == 0) {
         write_ptr += fe64_MOV64rr(write_ptr, 0, FE_SP, FE_BP);
@@ -808,31 +952,37 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::finish_func(
           fe64_POPr(write_ptr, 0, AsmReg{static_cast<AsmReg::REG>(reg)});
     }
     write_ptr += fe64_POPr(write_ptr, 0, FE_BP);
+    restore_size = write_ptr - epilogue;
     write_ptr += fe64_RET(write_ptr, 0);
-    ret_size = write_ptr - ret_start;
+    ret_size = write_ptr - epilogue;
     assert(ret_size <= epilogue_size && "function epilogue too long");
+  }
 
-    // write NOP for better disassembly
-    if (epilogue_size > ret_size) {
-      fe64_NOP(write_ptr, epilogue_size - ret_size);
-      if (first_ret_off == func_end_ret_off) {
-        this->text_writer.cur_ptr() -= epilogue_size - ret_size;
-      }
+  u32 func_end_ret_off = this->text_writer.offset() - epilogue_size;
+  for (u32 ret_off : func_ret_offs) {
+    u8 *ret_ptr = this->text_writer.data_ptr(ret_off);
+    std::memcpy(ret_ptr, epilogue, ret_size);
+    if (ret_off == func_end_ret_off) {
+      this->text_writer.cur_ptr() -= epilogue_size - ret_size;
+    } else if (epilogue_size > ret_size) {
+      // write NOP for better disassembly
+      fe64_NOP(ret_ptr + ret_size, epilogue_size - ret_size);
     }
   }
 
-  for (u32 i = 1; i < func_ret_offs.size(); ++i) {
-    std::memcpy(
-        text_data + func_ret_offs[i], text_data + first_ret_off, epilogue_size);
-    if (func_ret_offs[i] == func_end_ret_off) {
-      this->text_writer.cur_ptr() -= epilogue_size - ret_size;
+  // The jump follows the reserved space, so pad with NOPs.
+  for (u32 tail_off : func_tail_call_offs) {
+    u8 *tail_ptr = this->text_writer.data_ptr(tail_off);
+    std::memcpy(tail_ptr, epilogue, restore_size);
+    if (epilogue_size - 1 > restore_size) {
+      fe64_NOP(tail_ptr + restore_size, epilogue_size - 1 - restore_size);
     }
   }
 
   // Do sym_def at the very end; we shorten the function here again, so only at
   // this point we know the actual size of the function.
   // TODO(ts): honor cur_needs_unwind_info
-  auto func_size = this->text_writer.offset() - func_start_off;
+  auto func_size = this->text_writer.hot_end_offset() - func_start_off;
   this->assembler.sym_def(func_sym, func_sec, func_start_off, func_size);
   this->assembler.eh_end_fde(fde_off, func_sym);
   this->assembler.except_encode_func(func_sym,
@@ -845,6 +995,7 @@ template <IRAdaptor Adaptor,
           typename Config>
 void CompilerX64<Adaptor, Derived, BaseTy, Config>::reset() noexcept {
   func_ret_offs.clear();
+  func_tail_call_offs.clear();
   sym_tls_get_addr = {};
   Base::reset();
 }
@@ -853,7 +1004,8 @@ template <IRAdaptor Adaptor,
           typename Derived,
           template <typename, typename, typename> typename BaseTy,
           typename Config>
-void CompilerX64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog() noexcept {
+void CompilerX64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog(
+    bool tail_call) noexcept {
   // epilogue:
   // if !func_has_dynamic_alloca:
   //   add rsp, #<frame_size>+<largest_call_frame_usage>
@@ -862,13 +1014,11 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog() noexcept {
   // for each saved reg:
   //   pop <reg>
   // pop rbp
-  // ret
+  // ret (omitted for tail calls)
   //
   // however, since we will later patch this, we only
   // reserve the space for now
 
-  func_ret_offs.push_back(this->text_writer.offset());
-
   // add reg, imm32
   // and
   // lea rsp, [rbp - imm32]
@@ -877,6 +1027,13 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::gen_func_epilog() noexcept {
       7 + 1 + 1 +
       func_reg_restore_alloc; // add/lea + pop + ret + size of reg restore
 
+  if (tail_call) {
+    func_tail_call_offs.push_back(this->text_writer.offset());
+    epilogue_size -= 1;
+  } else {
+    func_ret_offs.push_back(this->text_writer.offset());
+  }
+
   this->text_writer.ensure_space(epilogue_size);
   this->text_writer.cur_ptr() += epilogue_size;
 }
@@ -1132,6 +1289,28 @@ AsmReg CompilerX64<Adaptor, Derived, BaseTy, Config>::gval_expr_as_reg(
   return dst;
 }
 
+template <IRAdaptor Adaptor,
+          typename Derived,
+          template <typename, typename, typename> typename BaseTy,
+          typename Config>
+FeMem CompilerX64<Adaptor, Derived, BaseTy, Config>::gval_as_mem(
+    GenericValuePart &gv) noexcept {
+  if (auto *expr = std::get_if<typename GenericValuePart::Expr>(&gv.state)) {
+    bool disp32 = i32(expr->disp) == expr->disp;
+    if (disp32 && expr->has_base()) {
+      AsmReg base = expr->base_reg();
+      if (!expr->has_index()) {
+        return FE_MEM(base, 0, FE_NOREG, i32(expr->disp));
+      }
+      if ((expr->scale & (expr->scale - 1)) == 0 && expr->scale <= 8) {
+        u8 sc = expr->scale;
+        return FE_MEM(base, sc, expr->index_reg(), i32(expr->disp));
+      }
+    }
+  }
+  return FE_MEM(this->gval_as_reg(gv), 0, FE_NOREG, 0);
+}
+
 template <IRAdaptor Adaptor,
           typename Derived,
           template <typename, typename, typename> typename BaseTy,
@@ -1271,14 +1450,17 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::materialize_constant(
     }
   }
 
-  // TODO: round to next power of two but at least 4 byte
-  // We store constants in 8-byte units.
-  auto alloc_size = util::align_up(size, 8);
-  std::span<const u8> raw_data{reinterpret_cast<const u8 *>(data), alloc_size};
-  // TODO: deduplicate/pool constants?
-  auto rodata = this->assembler.get_data_section(true, false);
-  auto sym = this->assembler.sym_def_data(
-      rodata, "", raw_data, alloc_size, Assembler::SymBinding::LOCAL);
+  if (size > 16) {
+    // TODO: implement for AVX/AVX-512.
+    TPDE_FATAL("unable to materialize constant");
+  }
+
+  // Constants are padded to 4, 8, or 16 bytes and deduplicated in the
+  // mergeable constant sections of the module.
+  u32 const_size = size <= 4 ? 4 : size <= 8 ? 8 : 16;
+  u8 raw_data[16] = {};
+  std::memcpy(raw_data, data, size);
+  auto sym = this->assembler.sym_def_const({raw_data, const_size});
   if (size <= 4) {
     if (has_cpu_feats(CPU_AVX)) {
       ASM(VMOVSSrm, dst, FE_MEM(FE_IP, 0, FE_NOREG, -1));
@@ -1291,15 +1473,12 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::materialize_constant(
     } else {
       ASM(SSE_MOVSDrm, dst, FE_MEM(FE_IP, 0, FE_NOREG, -1));
     }
-  } else if (size <= 16) {
+  } else {
     if (has_cpu_feats(CPU_AVX)) {
       ASM(VMOVAPS128rm, dst, FE_MEM(FE_IP, 0, FE_NOREG, -1));
     } else {
       ASM(SSE_MOVAPSrm, dst, FE_MEM(FE_IP, 0, FE_NOREG, -1));
     }
-  } else {
-    // TODO: implement for AVX/AVX-512.
-    TPDE_FATAL("unable to materialize constant");
   }
 
   this->reloc_text(sym, R_X86_64_PC32, this->text_writer.offset() - 4, -4);
@@ -1491,8 +1670,8 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::generate_raw_jump(
   bool pending = this->text_writer.label_is_pending(target_label);
   void *target = this->text_writer.cur_ptr();
   if (!pending) {
-    target = this->text_writer.begin_ptr() +
-             this->text_writer.label_offset(target_label);
+    u32 target_off = this->text_writer.label_offset(target_label);
+    target = this->text_writer.data_ptr(target_off);
   }
 
   if (jmp == Jump::jmp) {
@@ -1723,6 +1902,24 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::CallBuilder::add_arg_stack(
   }
 }
 
+template <IRAdaptor Adaptor,
+          typename Derived,
+          template <typename, typename, typename> class BaseTy,
+          typename Config>
+void CompilerX64<Adaptor, Derived, BaseTy, Config>::CallBuilder::
+    set_vararg_vec_count() noexcept {
+  if (this->compiler.register_file.is_used(Reg{AsmReg::AX})) {
+    this->compiler.evict_reg(Reg{AsmReg::AX});
+  }
+  Reg next_xmm = this->compiler.register_file.find_first_free_excluding(
+      Config::FP_BANK, 0);
+  unsigned xmm_cnt = 8;
+  if (next_xmm.valid() && next_xmm.id() - AsmReg::XMM0 < 8) {
+    xmm_cnt = next_xmm.id() - AsmReg::XMM0;
+  }
+  ASMC(&this->compiler, MOV32ri, FE_AX, xmm_cnt);
+}
+
 template <IRAdaptor Adaptor,
           typename Derived,
           template <typename, typename, typename> class BaseTy,
@@ -1730,21 +1927,12 @@ template <IRAdaptor Adaptor,
 void CompilerX64<Adaptor, Derived, BaseTy, Config>::CallBuilder::call_impl(
     std::variant<SymRef, ValuePart> &&target) noexcept {
   if (this->assigner.is_vararg()) {
-    if (this->compiler.register_file.is_used(Reg{AsmReg::AX})) {
-      this->compiler.evict_reg(Reg{AsmReg::AX});
-    }
-    Reg next_xmm = this->compiler.register_file.find_first_free_excluding(
-        Config::FP_BANK, 0);
-    unsigned xmm_cnt = 8;
-    if (next_xmm.valid() && next_xmm.id() - AsmReg::XMM0 < 8) {
-      xmm_cnt = next_xmm.id() - AsmReg::XMM0;
-    }
-    ASMC(&this->compiler, MOV32ri, FE_AX, xmm_cnt);
+    set_vararg_vec_count();
   }
 
   u32 sub = 0;
   if (stack_adjust_off != 0) {
-    auto *inst_ptr = this->compiler.text_writer.begin_ptr() + stack_adjust_off;
+    auto *inst_ptr = this->compiler.text_writer.data_ptr(stack_adjust_off);
     sub = util::align_up(this->assigner.get_stack_size(), 0x10);
     memcpy(inst_ptr + 3, &sub, sizeof(u32));
   } else {
@@ -1765,8 +1953,10 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::CallBuilder::call_impl(
     } else if (tvp.can_salvage()) {
       ASMC(&this->compiler, CALLr, tvp.salvage(&this->compiler));
     } else {
-      assert(!this->compiler.register_file.is_used(Reg{AsmReg::R10}));
-      AsmReg reg = tvp.reload_into_specific_fixed(&this->compiler, AsmReg::R10);
+      // r11 is clobbered by all supported calling conventions and therefore
+      // already evicted.
+      assert(!this->compiler.register_file.is_used(Reg{AsmReg::R11}));
+      AsmReg reg = tvp.reload_into_specific_fixed(&this->compiler, AsmReg::R11);
       ASMC(&this->compiler, CALLr, reg);
     }
     tvp.reset(&this->compiler);
@@ -1777,6 +1967,46 @@ void CompilerX64<Adaptor, Derived, BaseTy, Config>::CallBuilder::call_impl(
   }
 }
 
+template <IRAdaptor Adaptor,
+          typename Derived,
+          template <typename, typename, typename> class BaseTy,
+          typename Config>
+void CompilerX64<Adaptor, Derived, BaseTy, Config>::CallBuilder::
+    tail_call_impl(std::variant<SymRef, ValuePart> &&target) noexcept {
+  assert(stack_adjust_off == 0 && "tail call with stack arguments");
+  if (this->assigner.is_vararg()) {
+    set_vararg_vec_count();
+  }
+
+  if (auto *sym = std::get_if<SymRef>(&target)) {
+    this->compiler.gen_func_epilog(/*tail_call=*/true);
+    this->compiler.text_writer.ensure_space(16);
+    // Force the rel32 form, the target is only known after relocation.
+    ASM_FULL(&this->compiler,
+             0,
+             JMP,
+             FE_JMPL,
+             this->compiler.text_writer.cur_ptr());
+    this->compiler.reloc_text(
+        *sym, R_X86_64_PLT32, this->compiler.text_writer.offset() - 4, -4);
+    return;
+  }
+
+  // The epilogue restores callee-saved registers and rbp, so move the target
+  // into r11, which is neither callee-saved nor used for arguments.
+  ValuePart &tvp = std::get<ValuePart>(target);
+  AsmReg reg = AsmReg::R11;
+  if (!tvp.is_in_reg(reg)) {
+    if (this->compiler.register_file.is_used(reg)) {
+      this->compiler.evict_reg(reg);
+    }
+    tvp.reload_into_specific_fixed(&this->compiler, reg);
+  }
+  tvp.reset(&this->compiler);
+  this->compiler.gen_func_epilog(/*tail_call=*/true);
+  ASMC(&this->compiler, JMPr, reg);
+}
+
 template <IRAdaptor Adaptor,
           typename Derived,
           template <typename, typename, typename> typename BaseTy,
@@ -24,12 +24,16 @@ public:
 
 private:
   void handle_fixups() noexcept;
+
+  void handle_cold_fixup(Assembler &assembler,
+                         const LabelFixup &fixup,
+                         SymRef cold_sym) noexcept;
 };
 
 inline void FunctionWriterX64::handle_fixups() noexcept {
   for (const LabelFixup &fixup : label_fixups) {
     u32 label_off = label_offset(fixup.label);
-    u8 *dst_ptr = begin_ptr() + fixup.off;
+    u8 *dst_ptr = data_ptr(fixup.off);
     switch (fixup.kind) {
     case LabelFixupKind::X64_JMP_OR_MEM_DISP: {
       // fix the jump immediate
@@ -48,4 +52,25 @@ inline void FunctionWriterX64::handle_fixups() noexcept {
   }
 }
 
+inline void FunctionWriterX64::handle_cold_fixup(Assembler &assembler,
+                                                 const LabelFixup &fixup,
+                                                 SymRef cold_sym) noexcept {
+  u32 label_off = label_offset(fixup.label);
+  u8 *dst_ptr = data_ptr(fixup.off);
+  i64 addend = i64(label_off) - i64(cold_off);
+  switch (fixup.kind) {
+  case LabelFixupKind::X64_JMP_OR_MEM_DISP: addend -= 4; break;
+  case LabelFixupKind::X64_JUMP_TABLE: {
+    // The entry is relative to the table, not to the entry itself.
+    i32 diff;
+    std::memcpy(&diff, dst_ptr, sizeof(i32));
+    addend += fixup.off - (label_off - diff);
+    break;
+  }
+  default: TPDE_UNREACHABLE("unexpected label fixup kind");
+  }
+  std::memset(dst_ptr, 0, sizeof(u32));
+  assembler.reloc_pc32(get_sec_ref(), cold_sym, fixup.off, addend);
+}
+
 } // namespace tpde::x64
@@ -12,4 +12,13 @@ void Assembler::reset() noexcept {
   section_allocator.reset();
 }
 
+std::vector<u8> Assembler::build_object_file() noexcept {
+  std::vector<u8> out;
+  write_object_file([&out](std::span<const u8> data) {
+    out.insert(out.end(), data.begin(), data.end());
+    return true;
+  });
+  return out;
+}
+
 } // namespace tpde
@@ -7,6 +7,8 @@
 #include "tpde/util/misc.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <elf.h>
 
 namespace tpde {
@@ -33,7 +35,12 @@ constexpr static std::span<const char> SHSTRTAB = {
     ".bss\0"
     ".tbss\0"
     ".rela.rodata\0"
+    ".rodata.cst4\0"
+    ".rodata.cst8\0"
+    ".rodata.cst16\0"
+    ".rodata.str1.1\0"
     ".rela.text\0"
+    ".rela.text.unlikely\0"
     ".rela.data.rel.ro\0"
     ".rela.data\0"
     ".rela.tdata\0"
@@ -41,7 +48,11 @@ constexpr static std::span<const char> SHSTRTAB = {
     ".rela.init_array\0"
     ".rela.fini_array\0"
     ".group\0"
-    ".symtab_shndx\0"};
+    ".symtab_shndx\0"
+    ".debug_abbrev\0"
+    ".rela.debug_info\0"
+    ".rela.debug_aranges\0"
+    ".rela.debug_line\0"};
 
 static void fail_constexpr_compile(const char *) {
   assert(0);
@@ -108,15 +119,22 @@ void AssemblerElf::reset() noexcept {
   strtab = StringTable();
   shstrtab_extra = StringTable();
   secref_text = SecRef();
+  secref_text_cold = SecRef();
   secref_rodata = SecRef();
   secref_relro = SecRef();
   secref_data = SecRef();
   secref_bss = SecRef();
   secref_tdata = SecRef();
   secref_tbss = SecRef();
+  merge_sections = {};
   secref_eh_frame = SecRef();
   secref_except_table = SecRef();
   cur_personality_func_addr = SymRef();
+  line_dirs.clear();
+  line_files.clear();
+  line_program.clear();
+  line_seqs.clear();
+  line_rows.clear();
 
   init_sections();
   eh_init_cie();
@@ -183,8 +201,17 @@ DataSection &AssemblerElf::get_or_create_section(SecRef &ref,
 
 const char *AssemblerElf::sec_name(SecRef ref) const noexcept {
   const DataSection &sec = get_section(ref);
-  assert(sec.name < elf::SHSTRTAB.size());
-  return elf::SHSTRTAB.data() + sec.name;
+  if (sec.name < elf::SHSTRTAB.size()) {
+    return elf::SHSTRTAB.data() + sec.name;
+  }
+  return shstrtab_extra.data() + (sec.name - elf::SHSTRTAB.size());
+}
+
+SecRef AssemblerElf::get_text_cold_section() noexcept {
+  unsigned off_r = elf::sec_off(".rela.text.unlikely");
+  unsigned flags = SHF_ALLOC | SHF_EXECINSTR;
+  (void)get_or_create_section(secref_text_cold, off_r, SHT_PROGBITS, flags, 16);
+  return secref_text_cold;
 }
 
 SecRef AssemblerElf::get_data_section(bool rodata, bool relro) noexcept {
@@ -197,6 +224,69 @@ SecRef AssemblerElf::get_data_section(bool rodata, bool relro) noexcept {
   return secref;
 }
 
+AssemblerElf::MergeEntry &AssemblerElf::get_merge_entry(
+    std::span<const u8> data, bool strings, SecRef &sec_ref) noexcept {
+  unsigned idx, name;
+  if (strings) {
+    idx = 3;
+    name = elf::sec_off(".rodata.str1.1");
+  } else if (data.size() == 4) {
+    idx = 0;
+    name = elf::sec_off(".rodata.cst4");
+  } else if (data.size() == 8) {
+    idx = 1;
+    name = elf::sec_off(".rodata.cst8");
+  } else {
+    assert(data.size() == 16 && "invalid mergeable constant size");
+    idx = 2;
+    name = elf::sec_off(".rodata.cst16");
+  }
+
+  MergeSection &merge = merge_sections[idx];
+  u32 entsize = strings ? 1 : data.size();
+  unsigned flags = SHF_ALLOC | SHF_MERGE | (strings ? SHF_STRINGS : 0);
+  DataSection &sec = get_or_create_section(
+      merge.sec, name, SHT_PROGBITS, flags, entsize, false);
+  sec.entsize = entsize;
+  sec_ref = merge.sec;
+
+  std::string_view key{reinterpret_cast<const char *>(data.data()),
+                       data.size()};
+  size_t hash = std::hash<std::string_view>{}(key);
+  auto [it, end] = merge.entries.equal_range(hash);
+  for (; it != end; ++it) {
+    MergeEntry &entry = it->second;
+    if (entry.size == data.size() &&
+        std::memcmp(sec.data.data() + entry.off, data.data(), data.size()) ==
+            0) {
+      return entry;
+    }
+  }
+
+  u32 off = sec.size();
+  sec.data.append(data.begin(), data.end());
+  return merge.entries.emplace(hash, MergeEntry{off, u32(data.size())})
+      ->second;
+}
+
+SymRef AssemblerElf::sym_def_const(std::span<const u8> data) noexcept {
+  SecRef sec_ref;
+  MergeEntry &entry = get_merge_entry(data, false, sec_ref);
+  if (!entry.sym.valid()) {
+    entry.sym = sym_predef_data("", SymBinding::LOCAL);
+    sym_def(entry.sym, sec_ref, entry.off, entry.size);
+  }
+  return entry.sym;
+}
+
+void AssemblerElf::sym_def_predef_merge(SymRef sym,
+                                        std::span<const u8> data,
+                                        bool strings) noexcept {
+  SecRef sec_ref;
+  MergeEntry &entry = get_merge_entry(data, strings, sec_ref);
+  sym_def(sym, sec_ref, entry.off, entry.size);
+}
+
 SecRef AssemblerElf::get_bss_section() noexcept {
   unsigned off = elf::sec_off(".bss");
   unsigned flags = SHF_ALLOC | SHF_WRITE;
@@ -348,7 +438,7 @@ void AssemblerElf::sym_def_predef_data(SecRef sec_ref,
   size_t pos = util::align_up(sec.size(), align);
   sym_def(sym_ref, sec_ref, pos, data.size());
   assert(!sec.is_virtual && "cannot add data to virtual section");
-  sec.data.resize(pos);
+  sec.data.resize(pos - sec.data_off);
   sec.data.append(data.begin(), data.end());
 
   if (off) {
@@ -365,7 +455,7 @@ void AssemblerElf::sym_def_predef_zero(
   if (sec.is_virtual) {
     sec.vsize = pos + size;
   } else {
-    sec.data.resize(pos + size);
+    sec.data.resize(pos + size - sec.data_off);
   }
 
   if (off) {
@@ -394,7 +484,19 @@ void AssemblerElf::eh_align_frame() noexcept {
   }
 }
 
+/// Whether the CFI instruction only advances the location, all other
+/// instructions change the CFI state.
+static bool eh_is_advance(const u8 opcode) noexcept {
+  using namespace dwarf;
+  if ((opcode & DWARF_CFI_PRIMARY_OPCODE_MASK) == DW_CFA_advance_loc) {
+    return true;
+  }
+  return opcode == DW_CFA_advance_loc1 || opcode == DW_CFA_advance_loc2 ||
+         opcode == DW_CFA_advance_loc4;
+}
+
 void AssemblerElf::eh_write_inst(const u8 opcode, const u64 arg) noexcept {
+  const size_t start = eh_writer.size();
   if ((opcode & dwarf::DWARF_CFI_PRIMARY_OPCODE_MASK) != 0) {
     assert((arg & dwarf::DWARF_CFI_PRIMARY_OPCODE_MASK) == 0);
     eh_writer.write<u8>(opcode | arg);
@@ -403,13 +505,22 @@ void AssemblerElf::eh_write_inst(const u8 opcode, const u64 arg) noexcept {
     eh_writer.write_unchecked<u8>(opcode);
     eh_writer.write_uleb_unchecked(arg);
   }
+  if (!eh_is_advance(opcode)) {
+    eh_fde_state.append(eh_writer.data() + start,
+                        eh_writer.data() + eh_writer.size());
+  }
 }
 
 void AssemblerElf::eh_write_inst(const u8 opcode,
                                  const u64 first_arg,
                                  const u64 second_arg) noexcept {
   eh_write_inst(opcode, first_arg);
+  const size_t start = eh_writer.size();
   eh_writer.write_uleb(second_arg);
+  if (!eh_is_advance(opcode)) {
+    eh_fde_state.append(eh_writer.data() + start,
+                        eh_writer.data() + eh_writer.size());
+  }
 }
 
 void AssemblerElf::eh_init_cie(SymRef personality_func_addr) noexcept {
@@ -531,6 +642,7 @@ u32 AssemblerElf::eh_begin_fde(SymRef personality_func_addr) noexcept {
   // Total Size: 17 bytes or 21 bytes
 
   eh_writer.zero(!cur_personality_func_addr.valid() ? 17 : 21);
+  eh_fde_state.clear();
   u8 *data = eh_writer.data() + fde_off;
 
   // we encode length later
@@ -585,6 +697,19 @@ void AssemblerElf::eh_end_fde(u32 fde_start, SymRef func) noexcept {
   }
 }
 
+void AssemblerElf::eh_write_cold_fde(SymRef cold_sym) noexcept {
+  assert(!cur_personality_func_addr.valid() &&
+         "cold code of functions with LSDA is unsupported");
+
+  // eh_begin_fde resets the state of the previous FDE.
+  util::SmallVector<u8, 32> insts;
+  insts.append(eh_fde_state.begin(), eh_fde_state.end());
+
+  const u32 fde_off = eh_begin_fde();
+  eh_writer.write(std::span<const u8>(insts.data(), insts.size()));
+  eh_end_fde(fde_off, cold_sym);
+}
+
 void AssemblerElf::except_begin_func() noexcept {
   except_call_site_table.clear();
   except_action_table.clear();
@@ -761,15 +886,314 @@ u32 AssemblerElf::except_type_idx_for_sym(const SymRef sym) noexcept {
   return idx;
 }
 
-void AssemblerElf::finalize() noexcept { eh_writer.flush(); }
+bool AssemblerElf::resolve_local_reloc(DataSection &sec,
+                                       const Relocation &reloc) noexcept {
+  if (!sym_is_local(reloc.symbol)) {
+    return false;
+  }
+  const Elf64_Sym *sym = sym_ptr(reloc.symbol);
+  if (sym->st_shndx == SHN_UNDEF ||
+      sym_section(reloc.symbol) != sec.get_ref()) {
+    return false;
+  }
+
+  const i64 pcrel = i64(sym->st_value) + reloc.addend - i64(reloc.offset);
+  u8 *dst = sec.data_ptr(reloc.offset);
+  const auto &target_info =
+      static_cast<const TargetInfoElf &>(this->target_info);
+  switch (target_info.elf_machine) {
+  case EM_X86_64:
+    if (reloc.type != R_X86_64_PC32 && reloc.type != R_X86_64_PLT32) {
+      return false;
+    }
+    if (i32(pcrel) != pcrel) {
+      return false;
+    }
+    std::memcpy(dst, &pcrel, sizeof(i32));
+    return true;
+  case EM_AARCH64: {
+    if (reloc.type == R_AARCH64_PREL32) {
+      if (i32(pcrel) != pcrel) {
+        return false;
+      }
+      std::memcpy(dst, &pcrel, sizeof(i32));
+      return true;
+    }
+    if (reloc.type != R_AARCH64_CALL26 && reloc.type != R_AARCH64_JUMP26) {
+      return false;
+    }
+    // Out-of-range branches are left to the linker, which can add a veneer.
+    if ((pcrel & 3) != 0 || pcrel < -(i64(1) << 27) || pcrel >= i64(1) << 27) {
+      return false;
+    }
+    u32 insn;
+    std::memcpy(&insn, dst, sizeof(u32));
+    insn = (insn & 0xfc00'0000) | ((pcrel >> 2) & 0x03ff'ffff);
+    std::memcpy(dst, &insn, sizeof(u32));
+    return true;
+  }
+  default: return false;
+  }
+}
+
+u32 AssemblerElf::line_add_file(std::string_view dir,
+                                std::string_view name) noexcept {
+  // Few directories per module, a linear search is fine.
+  u32 dir_idx = 0;
+  while (dir_idx < line_dirs.size() && line_dirs[dir_idx] != dir) {
+    ++dir_idx;
+  }
+  if (dir_idx == line_dirs.size()) {
+    line_dirs.emplace_back(dir);
+  }
+  line_files.emplace_back(dir_idx, name);
+  return line_files.size() - 1;
+}
+
+namespace {
+namespace dwarf_line {
+// Line program parameters, same as LLVM.
+constexpr i32 LINE_BASE = -5;
+constexpr u32 LINE_RANGE = 14;
+constexpr u8 OPCODE_BASE = 13;
+
+constexpr u8 DW_LNS_copy = 1;
+constexpr u8 DW_LNS_advance_pc = 2;
+constexpr u8 DW_LNS_advance_line = 3;
+constexpr u8 DW_LNS_set_file = 4;
+constexpr u8 DW_LNS_set_column = 5;
+constexpr u8 DW_LNE_end_sequence = 1;
+constexpr u8 DW_LNE_set_address = 2;
+} // namespace dwarf_line
+} // namespace
+
+void AssemblerElf::line_add_sequence(SecRef sec,
+                                     std::span<const LineRow> rows,
+                                     u32 end) noexcept {
+  using namespace dwarf_line;
+  while (!rows.empty() && rows.back().off >= end) {
+    rows = rows.first(rows.size() - 1);
+  }
+  if (rows.empty()) {
+    return;
+  }
+
+  util::VectorWriter w(line_program);
+  // DW_LNE_set_address, the address is relocated when emitting.
+  w.write<u8>(0);
+  w.write_uleb(9);
+  w.write<u8>(DW_LNE_set_address);
+  const u32 rows_begin = line_rows.size();
+  line_rows.insert(line_rows.end(), rows.begin(), rows.end());
+  line_seqs.push_back(LineSeq{
+      sec, rows[0].off, end, u32(w.size()), rows_begin, u32(line_rows.size())});
+  w.write<u64>(0);
+
+  u32 addr = rows[0].off, file = 1, line = 1, column = 0;
+  for (const LineRow &row : rows) {
+    if (row.file != file) {
+      w.write<u8>(DW_LNS_set_file);
+      w.write_uleb(row.file);
+      file = row.file;
+    }
+    if (row.column != column) {
+      w.write<u8>(DW_LNS_set_column);
+      w.write_uleb(row.column);
+      column = row.column;
+    }
+    i64 line_delta = i64(row.line) - i64(line);
+    if (line_delta < LINE_BASE || line_delta >= LINE_BASE + i64(LINE_RANGE)) {
+      w.write<u8>(DW_LNS_advance_line);
+      w.write_sleb(line_delta);
+      line_delta = 0;
+    }
+    line = row.line;
+
+    // Special opcodes advance address and line and append a row.
+    u64 addr_delta = row.off - addr;
+    u64 opcode = (line_delta - LINE_BASE) + OPCODE_BASE;
+    if (opcode + LINE_RANGE * addr_delta <= 255) {
+      w.write<u8>(opcode + LINE_RANGE * addr_delta);
+    } else {
+      w.write<u8>(DW_LNS_advance_pc);
+      w.write_uleb(addr_delta);
+      w.write<u8>(opcode);
+    }
+    addr = row.off;
+  }
+
+  w.write<u8>(DW_LNS_advance_pc);
+  w.write_uleb(end - addr);
+  w.write<u8>(0);
+  w.write_uleb(1);
+  w.write<u8>(DW_LNE_end_sequence);
+}
+
+void AssemblerElf::line_emit() noexcept {
+  using namespace dwarf_line;
+  const auto write_str = [](util::VectorWriter &w, std::string_view str) {
+    w.write({reinterpret_cast<const u8 *>(str.data()), str.size()});
+    w.write<u8>(0);
+  };
+  SecRef abbrev_ref = SecRef(), info_ref = SecRef(), aranges_ref = SecRef(),
+         line_ref = SecRef();
+  DataSection &abbrev = get_or_create_section(
+      abbrev_ref, elf::sec_off(".debug_abbrev"), SHT_PROGBITS, 0, 1, false);
+  DataSection &info = get_or_create_section(
+      info_ref, elf::sec_off(".rela.debug_info"), SHT_PROGBITS, 0, 1);
+  DataSection &aranges = get_or_create_section(
+      aranges_ref, elf::sec_off(".rela.debug_aranges"), SHT_PROGBITS, 0, 1);
+  DataSection &line_sec = get_or_create_section(
+      line_ref, elf::sec_off(".rela.debug_line"), SHT_PROGBITS, 0, 1);
+
+  // .debug_abbrev: a compile unit without children.
+  {
+    util::VectorWriter w(abbrev.data);
+    w.write_uleb(1);    // abbreviation code
+    w.write_uleb(0x11); // DW_TAG_compile_unit
+    w.write<u8>(0);     // DW_CHILDREN_no
+    w.write_uleb(0x25); // DW_AT_producer
+    w.write_uleb(0x08); // DW_FORM_string
+    w.write_uleb(0x03); // DW_AT_name
+    w.write_uleb(0x08); // DW_FORM_string
+    w.write_uleb(0x1b); // DW_AT_comp_dir
+    w.write_uleb(0x08); // DW_FORM_string
+    w.write_uleb(0x10); // DW_AT_stmt_list
+    w.write_uleb(0x17); // DW_FORM_sec_offset
+    w.write<u16>(0);
+    w.write<u8>(0);
+  }
+
+  // .debug_info: the compile unit is named after the first file.
+  {
+    util::VectorWriter w(info.data);
+    w.write<u32>(0); // unit_length, set below
+    w.write<u16>(5); // version
+    w.write<u8>(1);  // DW_UT_compile
+    w.write<u8>(8);  // address_size
+    reloc_sec(info_ref, abbrev.sym, target_info.reloc_abs32, w.size(), 0);
+    w.write<u32>(0); // debug_abbrev_offset
+    w.write_uleb(1);
+    write_str(w, "TPDE");
+    write_str(w, line_files[0].second);
+    write_str(w, line_dirs[line_files[0].first]);
+    reloc_sec(info_ref, line_sec.sym, target_info.reloc_abs32, w.size(), 0);
+    w.write<u32>(0); // stmt_list
+    u32 unit_length = w.size() - 4;
+    std::memcpy(w.data(), &unit_length, sizeof(unit_length));
+  }
+
+  // .debug_aranges: address ranges of the compile unit, adjacent sequences
+  // of the same section are merged.
+  {
+    util::VectorWriter w(aranges.data);
+    w.write<u32>(0); // unit_length, set below
+    w.write<u16>(2); // version
+    reloc_sec(aranges_ref, info.sym, target_info.reloc_abs32, w.size(), 0);
+    w.write<u32>(0); // debug_info_offset
+    w.write<u8>(8);  // address_size
+    w.write<u8>(0);  // segment_selector_size
+    w.zero(4);       // pad tuples to 16 bytes
+    for (size_t i = 0; i < line_seqs.size();) {
+      const SecRef sec = line_seqs[i].sec;
+      const u32 begin = line_seqs[i].begin;
+      u32 end = line_seqs[i].end;
+      for (++i; i < line_seqs.size() && line_seqs[i].sec == sec &&
+                line_seqs[i].begin >= end;
+           ++i) {
+        end = line_seqs[i].end;
+      }
+      reloc_abs(aranges_ref, get_section(sec).sym, w.size(), begin);
+      w.write<u64>(0);
+      w.write<u64>(end - begin);
+    }
+    w.zero(16);
+    u32 unit_length = w.size() - 4;
+    std::memcpy(w.data(), &unit_length, sizeof(unit_length));
+  }
+
+  // .debug_line: DWARF v5 header with inline strings, then the sequences.
+  {
+    util::VectorWriter w(line_sec.data);
+    w.write<u32>(0); // unit_length, set below
+    w.write<u16>(5); // version
+    w.write<u8>(8);  // address_size
+    w.write<u8>(0);  // segment_selector_size
+    const size_t header_length_off = w.size();
+    w.write<u32>(0); // header_length, set below
+    w.write<u8>(1);  // minimum_instruction_length
+    w.write<u8>(1);  // maximum_operations_per_instruction
+    w.write<u8>(1);  // default_is_stmt
+    w.write<i8>(LINE_BASE);
+    w.write<u8>(LINE_RANGE);
+    w.write<u8>(OPCODE_BASE);
+    constexpr u8 std_opcode_lengths[OPCODE_BASE - 1] = {
+        0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1};
+    w.write(std_opcode_lengths);
+    // Directories: DW_LNCT_path as DW_FORM_string
+    w.write<u8>(1);
+    w.write_uleb(1);
+    w.write_uleb(0x08);
+    w.write_uleb(line_dirs.size());
+    for (const std::string &dir : line_dirs) {
+      write_str(w, dir);
+    }
+    // Files: DW_LNCT_path as DW_FORM_string, DW_LNCT_directory_index as
+    // DW_FORM_udata
+    w.write<u8>(2);
+    w.write_uleb(1);
+    w.write_uleb(0x08);
+    w.write_uleb(2);
+    w.write_uleb(0x0f);
+    w.write_uleb(line_files.size());
+    for (const auto &[dir_idx, name] : line_files) {
+      write_str(w, name);
+      w.write_uleb(dir_idx);
+    }
+    const u32 program_off = w.size();
+    w.write({line_program.data(), line_program.size()});
+    for (const LineSeq &seq : line_seqs) {
+      reloc_abs(line_ref,
+                get_section(seq.sec).sym,
+                program_off + seq.addr_off,
+                seq.begin);
+    }
+
+    u32 header_length = program_off - (header_length_off + 4);
+    std::memcpy(w.data() + header_length_off, &header_length, 4);
+    u32 unit_length = w.size() - 4;
+    std::memcpy(w.data(), &unit_length, sizeof(unit_length));
+  }
+}
+
+void AssemblerElf::finalize() noexcept {
+  eh_writer.flush();
+  if (!line_seqs.empty()) {
+    line_emit();
+  }
 
-std::vector<u8> AssemblerElf::build_object_file() noexcept {
+  // Resolve references to local symbols within the same section, e.g. calls
+  // to internal functions, so that neither the linker nor the mapper has to.
+  for (size_t i = elf::predef_sec_count(); i < sections.size(); ++i) {
+    DataSection *sec = sections[i].get();
+    if (!sec || !sec->has_relocs || sec->is_virtual) {
+      continue;
+    }
+    size_t keep = 0;
+    for (const Relocation &reloc : sec->relocs) {
+      if (!resolve_local_reloc(*sec, reloc)) {
+        sec->relocs[keep++] = reloc;
+      }
+    }
+    sec->relocs.resize(keep);
+  }
+}
+
+bool AssemblerElf::write_object_file(ObjectSink sink) noexcept {
   using namespace elf;
 
   auto target_info = static_cast<const TargetInfoElf &>(this->target_info);
 
-  std::vector<u8> out{};
-
   unsigned secidx_symtax_shndx = 0;
 
   uint32_t sym_count = local_symbols.size() + global_symbols.size();
@@ -781,225 +1205,226 @@ std::vector<u8> AssemblerElf::build_object_file() noexcept {
     assert(local_shndx.empty() && global_shndx.empty());
   }
 
-  u32 obj_size = sizeof(Elf64_Ehdr) + sizeof(Elf64_Shdr) * sec_count + 16;
-  obj_size += sizeof(Elf64_Sym) * sym_count;
-  obj_size += strtab.size();
-  obj_size += SHSTRTAB.size() + shstrtab_extra.size();
-  for (const auto &sec : sections) {
-    if (!sec) { // skip relocation sections
-      continue;
-    }
-    obj_size += sec->data.size() + sizeof(Elf64_Rela) * sec->relocs.size() + 16;
-  }
-  if (secidx_symtax_shndx != 0) {
-    obj_size += sizeof(uint32_t) * sym_count;
-  }
-  out.reserve(obj_size);
-
-  out.resize(sizeof(Elf64_Ehdr));
-
-  const auto shdr_off = out.size();
-  out.resize(out.size() + sizeof(Elf64_Shdr) * sec_count);
-
-  const auto sec_hdr = [shdr_off, &out](const u32 idx) {
-    return reinterpret_cast<Elf64_Shdr *>(out.data() + shdr_off) + idx;
-  };
-
-  {
-    auto *hdr = reinterpret_cast<Elf64_Ehdr *>(out.data());
-
-    hdr->e_ident[0] = ELFMAG0;
-    hdr->e_ident[1] = ELFMAG1;
-    hdr->e_ident[2] = ELFMAG2;
-    hdr->e_ident[3] = ELFMAG3;
-    hdr->e_ident[4] = ELFCLASS64;
-    hdr->e_ident[5] = ELFDATA2LSB;
-    hdr->e_ident[6] = EV_CURRENT;
-    hdr->e_ident[7] = target_info.elf_osabi;
-    hdr->e_ident[8] = 0;
-    hdr->e_type = ET_REL;
-    hdr->e_machine = target_info.elf_machine;
-    hdr->e_version = EV_CURRENT;
-    hdr->e_shoff = shdr_off;
-    hdr->e_ehsize = sizeof(Elf64_Ehdr);
-    hdr->e_shentsize = sizeof(Elf64_Shdr);
-    if (sec_count < SHN_LORESERVE) {
-      hdr->e_shnum = sec_count;
-    } else {
-      // If e_shnum is too small, the number of sections is stored in the size
-      // field of the NULL section entry.
-      hdr->e_shnum = 0;
-      sec_hdr(0)->sh_size = sec_count;
-    }
-    hdr->e_shstrndx = sec_idx(".shstrtab");
+  // First compute the layout of the file, then write all parts in order of
+  // their file offsets.
+  Elf64_Ehdr ehdr{};
+  std::vector<Elf64_Shdr> shdrs(sec_count);
+  u64 off = sizeof(Elf64_Ehdr) + sizeof(Elf64_Shdr) * sec_count;
+
+  ehdr.e_ident[0] = ELFMAG0;
+  ehdr.e_ident[1] = ELFMAG1;
+  ehdr.e_ident[2] = ELFMAG2;
+  ehdr.e_ident[3] = ELFMAG3;
+  ehdr.e_ident[4] = ELFCLASS64;
+  ehdr.e_ident[5] = ELFDATA2LSB;
+  ehdr.e_ident[6] = EV_CURRENT;
+  ehdr.e_ident[7] = target_info.elf_osabi;
+  ehdr.e_ident[8] = 0;
+  ehdr.e_type = ET_REL;
+  ehdr.e_machine = target_info.elf_machine;
+  ehdr.e_version = EV_CURRENT;
+  ehdr.e_shoff = sizeof(Elf64_Ehdr);
+  ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+  ehdr.e_shentsize = sizeof(Elf64_Shdr);
+  if (sec_count < SHN_LORESERVE) {
+    ehdr.e_shnum = sec_count;
+  } else {
+    // If e_shnum is too small, the number of sections is stored in the size
+    // field of the NULL section entry.
+    ehdr.e_shnum = 0;
+    shdrs[0].sh_size = sec_count;
   }
+  ehdr.e_shstrndx = sec_idx(".shstrtab");
 
   // .note.GNU-stack
   {
-    auto *hdr = sec_hdr(sec_idx(".note.GNU-stack"));
-    hdr->sh_name = sec_off(".note.GNU-stack");
-    hdr->sh_type = SHT_PROGBITS;
-    hdr->sh_offset = out.size(); // gcc seems to give empty sections an offset
-    hdr->sh_addralign = 1;
+    auto &hdr = shdrs[sec_idx(".note.GNU-stack")];
+    hdr.sh_name = sec_off(".note.GNU-stack");
+    hdr.sh_type = SHT_PROGBITS;
+    hdr.sh_offset = off; // gcc seems to give empty sections an offset
+    hdr.sh_addralign = 1;
   }
 
   // .symtab
   {
-    const size_t local_cnt = local_symbols.size();
-    const size_t global_cnt = global_symbols.size();
-    const auto size =
-        sizeof(Elf64_Sym) * (local_symbols.size() + global_symbols.size());
-    const auto sh_off = out.size();
-    out.insert(out.end(),
-               reinterpret_cast<uint8_t *>(local_symbols.data()),
-               reinterpret_cast<uint8_t *>(local_symbols.data() + local_cnt));
-    // global symbols need to come after the local symbols
-    out.insert(out.end(),
-               reinterpret_cast<uint8_t *>(global_symbols.data()),
-               reinterpret_cast<uint8_t *>(global_symbols.data() + global_cnt));
-
-    auto *hdr = sec_hdr(sec_idx(".symtab"));
-    hdr->sh_name = sec_off(".symtab");
-    hdr->sh_type = SHT_SYMTAB;
-    hdr->sh_offset = sh_off;
-    hdr->sh_size = size;
-    hdr->sh_link = sec_idx(".strtab");
-    hdr->sh_info = local_symbols.size(); // first non-local symbol idx
-    hdr->sh_addralign = 8;
-    hdr->sh_entsize = sizeof(Elf64_Sym);
+    auto &hdr = shdrs[sec_idx(".symtab")];
+    hdr.sh_name = sec_off(".symtab");
+    hdr.sh_type = SHT_SYMTAB;
+    hdr.sh_offset = off;
+    hdr.sh_size = sizeof(Elf64_Sym) * sym_count;
+    hdr.sh_link = sec_idx(".strtab");
+    hdr.sh_info = local_symbols.size(); // first non-local symbol idx
+    hdr.sh_addralign = 8;
+    hdr.sh_entsize = sizeof(Elf64_Sym);
+    off += hdr.sh_size;
   }
 
   // .strtab
   {
-    const auto size = util::align_up(strtab.size(), 8);
-    const auto pad = size - strtab.size();
-    const auto sh_off = out.size();
-    out.insert(out.end(),
-               reinterpret_cast<const u8 *>(strtab.data()),
-               reinterpret_cast<const u8 *>(strtab.data() + strtab.size()));
-    out.resize(out.size() + pad);
-
-    auto *hdr = sec_hdr(sec_idx(".strtab"));
-    hdr->sh_name = sec_off(".strtab");
-    hdr->sh_type = SHT_STRTAB;
-    hdr->sh_offset = sh_off;
-    hdr->sh_size = size;
-    hdr->sh_addralign = 1;
+    auto &hdr = shdrs[sec_idx(".strtab")];
+    hdr.sh_name = sec_off(".strtab");
+    hdr.sh_type = SHT_STRTAB;
+    hdr.sh_offset = off;
+    hdr.sh_size = util::align_up(strtab.size(), 8);
+    hdr.sh_addralign = 1;
+    off += hdr.sh_size;
   }
 
   // .shstrtab
   {
-    const auto size = SHSTRTAB.size() + shstrtab_extra.size();
-    const auto pad = util::align_up(size, 8) - size;
-    const auto sh_off = out.size();
-    out.insert(out.end(),
-               reinterpret_cast<const u8 *>(SHSTRTAB.data()),
-               reinterpret_cast<const u8 *>(SHSTRTAB.data() + SHSTRTAB.size()));
-    out.insert(out.end(),
-               reinterpret_cast<const u8 *>(shstrtab_extra.data()),
-               reinterpret_cast<const u8 *>(shstrtab_extra.data() +
-                                            shstrtab_extra.size()));
-    out.resize(out.size() + pad);
-
-    auto *hdr = sec_hdr(sec_idx(".shstrtab"));
-    hdr->sh_name = sec_off(".shstrtab");
-    hdr->sh_type = SHT_STRTAB;
-    hdr->sh_offset = sh_off;
-    hdr->sh_size = size;
-    hdr->sh_addralign = 1;
+    auto &hdr = shdrs[sec_idx(".shstrtab")];
+    hdr.sh_name = sec_off(".shstrtab");
+    hdr.sh_type = SHT_STRTAB;
+    hdr.sh_offset = off;
+    hdr.sh_size = SHSTRTAB.size() + shstrtab_extra.size();
+    hdr.sh_addralign = 1;
+    off += util::align_up(hdr.sh_size, 8);
   }
 
   for (size_t i = predef_sec_count(); i < sections.size(); ++i) {
     DataSection &sec = *sections[i];
-    Elf64_Shdr *hdr = sec_hdr(i);
-    hdr->sh_name = sec.name;
-    hdr->sh_type = sec.type;
-    hdr->sh_flags = sec.flags;
-    hdr->sh_addr = 0;
-    hdr->sh_offset = out.size();
-    hdr->sh_size = sec.size();
-    hdr->sh_link = 0;
-    hdr->sh_info = 0;
-    hdr->sh_addralign = sec.align;
-    hdr->sh_entsize = 0;
+    Elf64_Shdr &hdr = shdrs[i];
+    hdr.sh_name = sec.name;
+    hdr.sh_type = sec.type;
+    hdr.sh_flags = sec.flags;
+    hdr.sh_addr = 0;
+    hdr.sh_offset = off;
+    hdr.sh_size = sec.size();
+    hdr.sh_link = 0;
+    hdr.sh_info = 0;
+    hdr.sh_addralign = sec.align;
+    hdr.sh_entsize = sec.entsize;
     if (sec.type == SHT_GROUP) [[unlikely]] {
       if (sym_is_local(sec.sym)) {
-        hdr->sh_info = sym_idx(sec.sym);
+        hdr.sh_info = sym_idx(sec.sym);
       } else {
-        hdr->sh_info = local_symbols.size() + sym_idx(sec.sym);
+        hdr.sh_info = local_symbols.size() + sym_idx(sec.sym);
       }
-      hdr->sh_link = sec_idx(".symtab");
-      hdr->sh_entsize = 4;
+      hdr.sh_link = sec_idx(".symtab");
+      hdr.sh_entsize = 4;
     }
-
-    const auto pad = util::align_up(sec.data.size(), 8) - sec.data.size();
-    out.insert(out.end(), sec.data.begin(), sec.data.end());
-    out.resize(out.size() + pad);
+    off += util::align_up(sec.data_off + sec.data.size(), 8);
 
     if (sec.has_relocs) {
       assert(sections[i + 1] == nullptr);
-      Elf64_Shdr *rela_hdr = sec_hdr(i + 1);
-      rela_hdr->sh_name = sec.name - 5;
-      rela_hdr->sh_type = SHT_RELA;
-      rela_hdr->sh_flags = SHF_INFO_LINK | (sec.flags & SHF_GROUP);
-      rela_hdr->sh_addr = 0;
-      rela_hdr->sh_offset = out.size();
-      rela_hdr->sh_size = sizeof(Elf64_Rela) * sec.relocs.size();
-      rela_hdr->sh_link = sec_idx(".symtab");
-      rela_hdr->sh_info = i;
-      rela_hdr->sh_addralign = alignof(Elf64_Rela);
-      rela_hdr->sh_entsize = sizeof(Elf64_Rela);
+      Elf64_Shdr &rela_hdr = shdrs[i + 1];
+      rela_hdr.sh_name = sec.name - 5;
+      rela_hdr.sh_type = SHT_RELA;
+      rela_hdr.sh_flags = SHF_INFO_LINK | (sec.flags & SHF_GROUP);
+      rela_hdr.sh_addr = 0;
+      rela_hdr.sh_offset = off;
+      rela_hdr.sh_size = sizeof(Elf64_Rela) * sec.relocs.size();
+      rela_hdr.sh_link = sec_idx(".symtab");
+      rela_hdr.sh_info = i;
+      rela_hdr.sh_addralign = alignof(Elf64_Rela);
+      rela_hdr.sh_entsize = sizeof(Elf64_Rela);
+      off += rela_hdr.sh_size;
 
       // Skip allocated nullptr relocation section
       i += 1;
+    }
+  }
 
-      // Resize invalidates rela_hdr.
-      size_t rela_offset = rela_hdr->sh_offset;
-      out.resize(out.size() + rela_hdr->sh_size);
-
-      // Addend to symbol id to convert global symbol to the ELF symbol.
-      u32 global_symbol_fix = u32{0x8000'0000} + local_symbols.size();
-
-      auto *rela = reinterpret_cast<Elf64_Rela *>(out.data() + rela_offset);
-      [[maybe_unused]] auto *rela_begin = rela;
-      for (const Relocation &reloc : sec.relocs) {
-        rela->r_addend = reloc.addend;
-        rela->r_offset = reloc.offset;
-        u32 symbol_fix = sym_is_local(reloc.symbol) ? 0 : global_symbol_fix;
-        rela->r_info = ELF64_R_INFO(reloc.symbol.id() + symbol_fix, reloc.type);
-        ++rela;
+  if (secidx_symtax_shndx != 0) {
+    auto &hdr = shdrs[secidx_symtax_shndx];
+    hdr.sh_name = sec_off(".symtab_shndx");
+    hdr.sh_type = SHT_SYMTAB_SHNDX;
+    hdr.sh_offset = off;
+    hdr.sh_size = sizeof(uint32_t) * sym_count;
+    hdr.sh_link = sec_idx(".symtab");
+    hdr.sh_addralign = 4;
+    hdr.sh_entsize = 4;
+  }
+
+  const auto write = [&sink](const void *data, size_t size) {
+    return size == 0 || sink({static_cast<const u8 *>(data), size});
+  };
+  const auto write_zeros = [&write](size_t size) {
+    static constexpr u8 zeros[64] = {};
+    for (; size > sizeof(zeros); size -= sizeof(zeros)) {
+      if (!write(zeros, sizeof(zeros))) {
+        return false;
       }
-      assert(sec_hdr(i)->sh_size == sizeof(Elf64_Rela) * (rela - rela_begin));
     }
+    return write(zeros, size);
+  };
+
+  if (!write(&ehdr, sizeof(ehdr)) ||
+      !write(shdrs.data(), sizeof(Elf64_Shdr) * shdrs.size())) {
+    return false;
   }
 
-  if (secidx_symtax_shndx != 0) {
-    auto *hdr = sec_hdr(secidx_symtax_shndx);
-    hdr->sh_name = sec_off(".symtab_shndx");
-    hdr->sh_type = SHT_SYMTAB_SHNDX;
-    hdr->sh_offset = out.size();
-    hdr->sh_size = sizeof(uint32_t) * sym_count;
-    hdr->sh_link = sec_idx(".symtab");
-    hdr->sh_addralign = 4;
-    hdr->sh_entsize = 4;
-
-    out.insert(out.end(),
-               reinterpret_cast<const uint8_t *>(local_shndx.data()),
-               reinterpret_cast<const uint8_t *>(local_shndx.data() +
-                                                 local_shndx.size()));
-    if (uint32_t missing = local_symbols.size() - local_shndx.size()) {
-      out.resize(out.size() + sizeof(uint32_t) * missing);
+  // global symbols need to come after the local symbols
+  if (!write(local_symbols.data(), sizeof(Elf64_Sym) * local_symbols.size()) ||
+      !write(global_symbols.data(),
+             sizeof(Elf64_Sym) * global_symbols.size())) {
+    return false;
+  }
+
+  if (!write(strtab.data(), strtab.size()) ||
+      !write_zeros(util::align_up(strtab.size(), 8) - strtab.size())) {
+    return false;
+  }
+
+  size_t shstrtab_size = SHSTRTAB.size() + shstrtab_extra.size();
+  if (!write(SHSTRTAB.data(), SHSTRTAB.size()) ||
+      !write(shstrtab_extra.data(), shstrtab_extra.size()) ||
+      !write_zeros(util::align_up(shstrtab_size, 8) - shstrtab_size)) {
+    return false;
+  }
+
+  // Addend to symbol id to convert global symbol to the ELF symbol.
+  u32 global_symbol_fix = u32{0x8000'0000} + local_symbols.size();
+  // Relocations are converted in batches to avoid a copy of the entire table.
+  std::array<Elf64_Rela, 128> rela_buf;
+  for (size_t i = predef_sec_count(); i < sections.size(); ++i) {
+    DataSection &sec = *sections[i];
+    const auto write_chunk = [&write](std::span<const u8> chunk) {
+      return write(chunk.data(), chunk.size());
+    };
+    const size_t data_size = sec.data_off + sec.data.size();
+    const auto pad = util::align_up(data_size, 8) - data_size;
+    if (!sec.for_each_chunk(write_chunk) || !write_zeros(pad)) {
+      return false;
+    }
+
+    if (!sec.has_relocs) {
+      continue;
+    }
+    // Skip allocated nullptr relocation section
+    i += 1;
+
+    size_t rela_cnt = 0;
+    for (const Relocation &reloc : sec.relocs) {
+      Elf64_Rela &rela = rela_buf[rela_cnt++];
+      rela.r_addend = reloc.addend;
+      rela.r_offset = reloc.offset;
+      u32 symbol_fix = sym_is_local(reloc.symbol) ? 0 : global_symbol_fix;
+      rela.r_info = ELF64_R_INFO(reloc.symbol.id() + symbol_fix, reloc.type);
+      if (rela_cnt == rela_buf.size()) {
+        if (!write(rela_buf.data(), sizeof(Elf64_Rela) * rela_cnt)) {
+          return false;
+        }
+        rela_cnt = 0;
+      }
     }
-    out.insert(out.end(),
-               reinterpret_cast<const uint8_t *>(global_shndx.data()),
-               reinterpret_cast<const uint8_t *>(global_shndx.data() +
-                                                 global_shndx.size()));
-    if (uint32_t missing = global_symbols.size() - global_shndx.size()) {
-      out.resize(out.size() + sizeof(uint32_t) * missing);
+    if (!write(rela_buf.data(), sizeof(Elf64_Rela) * rela_cnt)) {
+      return false;
+    }
+  }
+
+  if (secidx_symtax_shndx != 0) {
+    u32 local_missing = local_symbols.size() - local_shndx.size();
+    u32 global_missing = global_symbols.size() - global_shndx.size();
+    if (!write(local_shndx.data(), sizeof(uint32_t) * local_shndx.size()) ||
+        !write_zeros(sizeof(uint32_t) * local_missing) ||
+        !write(global_shndx.data(), sizeof(uint32_t) * global_shndx.size()) ||
+        !write_zeros(sizeof(uint32_t) * global_missing)) {
+      return false;
     }
   }
 
-  return out;
+  return true;
 }
 
 namespace {
@@ -1052,6 +1477,7 @@ const AssemblerElf::TargetInfoElf AssemblerElfA64::TARGET_INFO{
 
     .reloc_pc32 = R_AARCH64_PREL32,
     .reloc_abs64 = R_AARCH64_ABS64,
+    .reloc_abs32 = R_AARCH64_ABS32,
   },
 
   ELFOSABI_SYSV,
@@ -1067,6 +1493,7 @@ const AssemblerElf::TargetInfoElf AssemblerElfX64::TARGET_INFO{
 
     .reloc_pc32 = R_X86_64_PC32,
     .reloc_abs64 = R_X86_64_64,
+    .reloc_abs32 = R_X86_64_32,
   },
 
   ELFOSABI_SYSV,
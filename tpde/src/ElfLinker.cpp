@@ -0,0 +1,1255 @@
+// SPDX-FileCopyrightText: 2025 Contributors to TPDE <https://tpde.org>
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "tpde/ElfLinker.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <elf.h>
+#include <vector>
+
+#include "tpde/AssemblerElf.hpp"
+#include "tpde/StringTable.hpp"
+#include "tpde/base.hpp"
+#include "tpde/util/SmallVector.hpp"
+#include "tpde/util/misc.hpp"
+
+namespace tpde {
+
+namespace {
+
+/// Hash function of .gnu.hash.
+u32 gnu_hash(std::string_view name) noexcept {
+  u32 h = 5381;
+  for (unsigned char c : name) {
+    h = h * 33 + c;
+  }
+  return h;
+}
+
+/// Whether the instruction before a GOTPCRELX relocation is mov reg, [rip+x],
+/// which can be rewritten to lea reg, [rip+x].
+bool is_relaxable_mov(const u8 *loc) noexcept {
+  return loc[-2] == 0x8b && (loc[-1] & 0xc7) == 0x05;
+}
+
+void write32(u8 *loc, u32 val) noexcept { std::memcpy(loc, &val, sizeof(val)); }
+
+void write64(u8 *loc, u64 val) noexcept { std::memcpy(loc, &val, sizeof(val)); }
+
+void blend(u8 *loc, u32 mask, u32 data) noexcept {
+  u32 insn;
+  std::memcpy(&insn, loc, sizeof(insn));
+  insn = (data & mask) | (insn & ~mask);
+  std::memcpy(loc, &insn, sizeof(insn));
+}
+
+/// Encode the page offset into an AArch64 adrp instruction.
+u32 adrp_imm(u64 page_diff) noexcept {
+  u64 v = page_diff >> 12;
+  return (v & 3) << 29 | ((v >> 2) & 0x7'ffff) << 5;
+}
+
+/// How a relocation is handled in the shared object.
+enum class RelocKind : u8 {
+  /// Resolved at link time, symbol must be defined.
+  Direct,
+  /// 64-bit address, becomes a dynamic relocation.
+  Abs64,
+  /// Call, goes through a PLT stub for undefined symbols.
+  Call,
+  /// Load from a GOT entry.
+  Got,
+  Unsupported,
+};
+
+RelocKind classify_reloc(u16 machine, u32 type) noexcept {
+  if (machine == EM_X86_64) {
+    switch (type) {
+    case R_X86_64_64: return RelocKind::Abs64;
+    case R_X86_64_PC32:
+    case R_X86_64_PC64: return RelocKind::Direct;
+    case R_X86_64_PLT32: return RelocKind::Call;
+    case R_X86_64_GOTPCREL:
+    case R_X86_64_GOTPCRELX:
+    case R_X86_64_REX_GOTPCRELX: return RelocKind::Got;
+    default: return RelocKind::Unsupported;
+    }
+  }
+  switch (type) {
+  case R_AARCH64_ABS64: return RelocKind::Abs64;
+  case R_AARCH64_PREL32:
+  case R_AARCH64_PREL64:
+  case R_AARCH64_ADR_PREL_PG_HI21:
+  case R_AARCH64_ADD_ABS_LO12_NC:
+  case R_AARCH64_LDST8_ABS_LO12_NC:
+  case R_AARCH64_LDST16_ABS_LO12_NC:
+  case R_AARCH64_LDST32_ABS_LO12_NC:
+  case R_AARCH64_LDST64_ABS_LO12_NC:
+  case R_AARCH64_LDST128_ABS_LO12_NC: return RelocKind::Direct;
+  case R_AARCH64_CALL26:
+  case R_AARCH64_JUMP26: return RelocKind::Call;
+  case R_AARCH64_ADR_GOT_PAGE:
+  case R_AARCH64_LD64_GOT_LO12_NC: return RelocKind::Got;
+  default: return RelocKind::Unsupported;
+  }
+}
+
+struct OutSection {
+  u32 name = 0;
+  u32 type = SHT_NULL;
+  u64 flags = 0;
+  /// Virtual address, equal to the file offset for allocated sections.
+  u64 addr = 0;
+  u64 offset = 0;
+  u64 size = 0;
+  u32 align = 1;
+  u32 entsize = 0;
+  u32 link = 0;
+  u32 info = 0;
+};
+
+
+// xor ebp, ebp; mov r9, rdx; pop rsi; mov rdx, rsp; and rsp, -16; push rax;
+// push rsp; xor r8d, r8d; xor ecx, ecx; lea rdi, [rip + main];
+// call [rip + __libc_start_main@GOT]; hlt
+constexpr u8 X64_START[] = {
+    0x31, 0xed, 0x49, 0x89, 0xd1, 0x5e, 0x48, 0x89, 0xe2, 0x48, 0x83, 0xe4,
+    0xf0, 0x50, 0x54, 0x45, 0x31, 0xc0, 0x31, 0xc9, 0x48, 0x8d, 0x3d, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0x15, 0x00, 0x00, 0x00, 0x00, 0xf4};
+// mov x29, #0; mov x30, #0; mov x5, x0; ldr x1, [sp]; add x2, sp, #8;
+// mov x6, sp; adrp x0, main; add x0, x0, :lo12:main; mov x3, #0; mov x4, #0;
+// adrp x16, got; ldr x16, [x16, :lo12:got]; blr x16; brk #1000
+constexpr u32 A64_START[] = {0xd280'001d,
+                             0xd280'001e,
+                             0xaa00'03e5,
+                             0xf940'03e1,
+                             0x9100'23e2,
+                             0x9100'03e6,
+                             0x9000'0000,
+                             0x9100'0000,
+                             0xd280'0003,
+                             0xd280'0004,
+                             0x9000'0010,
+                             0xf940'0210,
+                             0xd63f'0200,
+                             0xd420'7d00};
+
+} // anonymous namespace
+
+/// State of a single link. The phases run in order: entry point, section
+/// sorting, relocation scan, dynamic symbols, layout, and finally writing the
+/// image.
+class ElfLinker::Linker {
+  static constexpr u64 PLT_ENTRY_SIZE = 16;
+  static constexpr u32 BLOOM_SHIFT = 26;
+
+  AssemblerElf &assembler;
+  const ElfLinker::Options &options;
+  const bool exe;
+  const u16 machine;
+  const bool is_a64;
+  /// Maximum page size of the target, segments are aligned to this.
+  const u64 page_size;
+  /// Symbol counts, only valid after find_entry, which might add a symbol.
+  u32 local_count = 0;
+  u32 sym_count = 0;
+
+  SymRef entry_sym, main_sym, libc_start;
+  u64 start_size = 0;
+
+  /// Allocated sections by segment.
+  util::SmallVector<SecRef, 16> ro_secs, rx_secs, rw_secs, bss_secs;
+  /// Non-allocated DWARF sections, copied after the segments.
+  util::SmallVector<SecRef, 4> debug_secs;
+
+  /// GOT entries, PLT stubs, and dynamic symbol index of imports for every
+  /// symbol. Slots are stored plus one, zero means none.
+  std::vector<u32> got_slot, plt_slot, dynsym_idx;
+  util::SmallVector<SymRef> got_syms, plt_syms, imports;
+  size_t dyn_reloc_count = 0;
+
+  struct Export {
+    SymRef sym;
+    u32 hash;
+  };
+  StringTable dynstr;
+  util::SmallVector<u32> needed_names;
+  u32 soname = 0;
+  util::SmallVector<Export> exports;
+  util::SmallVector<u32> dynsym_names;
+  u32 nbuckets = 1;
+  u32 bloom_words = 1;
+  u32 export_offset = 0;
+  u32 dynsym_count = 0;
+  bool has_init = false;
+  bool has_fini = false;
+  size_t dyn_count = 0;
+  u32 fde_count = 0;
+  std::string_view interp;
+
+  /// Output sections, the first one is the null section.
+  util::SmallVector<OutSection, 32> out_secs;
+  StringTable shstrtab;
+  /// Output section index for every assembler section, zero if not emitted.
+  util::SmallVector<u32, 32> sec_map;
+  /// Current file offset during layout.
+  u64 off = 0;
+  u32 phnum = 0;
+  u32 interp_sec = 0, dynsym_sec = 0, dynstr_sec = 0, gnu_hash_sec = 0;
+  u32 rela_sec = 0, eh_hdr_sec = 0, plt_sec = 0, start_sec = 0;
+  u32 dynamic_sec = 0, got_sec = 0, symtab_sec = 0, strtab_sec = 0;
+  u32 shstrtab_sec = 0;
+  u64 ro_end = 0, rx_start = 0, rx_end = 0;
+  u64 rw_start = 0, rw_file_end = 0, rw_end = 0;
+  u64 shoff = 0;
+  u64 file_size = 0;
+  /// Symbol table for debuggers and profilers, reusing the string table.
+  util::SmallVector<Elf64_Sym, 0> symtab;
+
+  std::vector<u8> image;
+  u8 *base = nullptr;
+  /// Relative relocations come first, as indicated by DT_RELACOUNT.
+  util::SmallVector<Elf64_Rela, 0> rela_relative, rela_sym;
+
+public:
+  Linker(AssemblerElf &assembler,
+         const ElfLinker::Options &options,
+         bool exe) noexcept
+      : assembler(assembler),
+        options(options),
+        exe(exe),
+        machine(static_cast<const AssemblerElf::TargetInfoElf &>(
+                    assembler.target_info)
+                    .elf_machine),
+        is_a64(machine == EM_AARCH64),
+        page_size(is_a64 ? 0x10000 : 0x1000) {}
+
+  bool link(Assembler::ObjectSink sink) noexcept;
+
+private:
+  bool find_entry() noexcept;
+  bool sort_sections() noexcept;
+  bool scan_relocs() noexcept;
+  void collect_dynsyms() noexcept;
+  bool layout() noexcept;
+  bool apply_relocs() noexcept;
+  bool apply_debug_relocs() noexcept;
+  void write_dynamic() noexcept;
+  void write_eh_frame_hdr() noexcept;
+  void write_headers() noexcept;
+
+  SymRef find_global(std::string_view name) const noexcept {
+    for (size_t i = 0; i < assembler.global_symbols.size(); ++i) {
+      SymRef sym = SymRef(0x8000'0000 | i);
+      if (assembler.sym_name(sym) == name) {
+        return sym;
+      }
+    }
+    return SymRef();
+  }
+
+  u32 sym_idx(SymRef sym) const noexcept {
+    u32 idx = AssemblerElf::sym_idx(sym);
+    return AssemblerElf::sym_is_local(sym) ? idx : idx + local_count;
+  }
+
+  bool is_undef(SymRef sym) const noexcept {
+    return assembler.sym_ptr(sym)->st_shndx == SHN_UNDEF;
+  }
+
+  bool is_allocated(SecRef ref) const noexcept {
+    const DataSection *sec = assembler.sections[ref.id()].get();
+    return sec && (sec->flags & SHF_ALLOC) && !(sec->flags & SHF_TLS);
+  }
+
+  void add_import(SymRef sym) noexcept {
+    if (!dynsym_idx[sym_idx(sym)]) {
+      imports.push_back(sym);
+      dynsym_idx[sym_idx(sym)] = imports.size();
+    }
+  }
+
+  void add_got(SymRef sym) noexcept {
+    if (!got_slot[sym_idx(sym)]) {
+      got_syms.push_back(sym);
+      got_slot[sym_idx(sym)] = got_syms.size();
+      ++dyn_reloc_count;
+      if (is_undef(sym)) {
+        add_import(sym);
+      }
+    }
+  }
+
+  /// Add an output section at the current offset. Allocated sections have the
+  /// same file offset and address.
+  u32 add_section(std::string_view name,
+                  u32 type,
+                  u64 flags,
+                  u64 size,
+                  u32 align,
+                  u32 entsize = 0) noexcept {
+    OutSection &out = out_secs.emplace_back();
+    out.name = shstrtab.add(name);
+    out.type = type;
+    out.flags = flags;
+    out.align = align;
+    out.entsize = entsize;
+    out.size = size;
+    out.offset = util::align_up(off, align);
+    out.addr = flags & SHF_ALLOC ? out.offset : 0;
+    if (type != SHT_NOBITS) {
+      off = out.offset + size;
+    }
+    return out_secs.size() - 1;
+  }
+
+  u32 add_asm_section(SecRef ref) noexcept {
+    const DataSection &sec = assembler.get_section(ref);
+    u64 size = sec.size();
+    if (ref == assembler.secref_eh_frame) {
+      size += 4; // zero terminator
+    }
+    u32 idx = add_section(assembler.sec_name(ref),
+                          sec.type,
+                          sec.flags & ~u64{SHF_GROUP},
+                          size,
+                          sec.align,
+                          sec.entsize);
+    sec_map[ref.id()] = idx;
+    return idx;
+  }
+
+  /// Symbol address in the output.
+  u64 sym_addr(SymRef sym) const noexcept {
+    const Elf64_Sym *elf_sym = assembler.sym_ptr(sym);
+    if (elf_sym->st_shndx == SHN_ABS) {
+      return elf_sym->st_value;
+    }
+    u32 sec = sec_map[assembler.sym_section(sym).id()];
+    return out_secs[sec].addr + elf_sym->st_value;
+  }
+
+  u16 sym_shndx(SymRef sym) const noexcept {
+    const Elf64_Sym *elf_sym = assembler.sym_ptr(sym);
+    if (elf_sym->st_shndx == SHN_UNDEF || elf_sym->st_shndx == SHN_ABS) {
+      return elf_sym->st_shndx;
+    }
+    return sec_map[assembler.sym_section(sym).id()];
+  }
+
+  u64 got_addr(SymRef sym) const noexcept {
+    return out_secs[got_sec].addr + 8 * (got_slot[sym_idx(sym)] - 1);
+  }
+
+  u64 plt_addr(SymRef sym) const noexcept {
+    return out_secs[plt_sec].addr +
+           PLT_ENTRY_SIZE * (plt_slot[sym_idx(sym)] - 1);
+  }
+
+  bool has_type(u32 type) const noexcept {
+    return std::any_of(rw_secs.begin(), rw_secs.end(), [&](SecRef ref) {
+      return assembler.get_section(ref).type == type;
+    });
+  }
+};
+
+bool ElfLinker::Linker::find_entry() noexcept {
+  // Executables start at the entry symbol or, if only main is defined, at a
+  // start stub that passes main to __libc_start_main, like crt1.o.
+  entry_sym = find_global(options.entry);
+  if (entry_sym.valid() && !is_undef(entry_sym)) {
+    return true;
+  }
+  entry_sym = SymRef();
+  main_sym = find_global("main");
+  if (!main_sym.valid() || is_undef(main_sym)) {
+    TPDE_LOG_ERR("entry symbol {} not defined", options.entry);
+    return false;
+  }
+  libc_start = find_global("__libc_start_main");
+  if (!libc_start.valid()) {
+    libc_start = assembler.sym_add_undef("__libc_start_main",
+                                         AssemblerElf::SymBinding::GLOBAL);
+  }
+  start_size = is_a64 ? sizeof(A64_START) : sizeof(X64_START);
+  return true;
+}
+
+bool ElfLinker::Linker::sort_sections() noexcept {
+  // Sort allocated sections into read-only, executable, and writable data.
+  for (size_t i = 0; i < assembler.sections.size(); ++i) {
+    const DataSection *sec = assembler.sections[i].get();
+    if (!sec) {
+      continue;
+    }
+    if (!(sec->flags & SHF_ALLOC)) {
+      std::string_view name = assembler.sec_name(SecRef(i));
+      if (name.starts_with(".debug_") && sec->size() != 0) {
+        debug_secs.push_back(SecRef(i));
+      }
+      continue;
+    }
+    if (sec->flags & SHF_TLS) {
+      if (sec->size() == 0) {
+        continue;
+      }
+      TPDE_LOG_ERR("thread-local storage is not supported when linking");
+      return false;
+    }
+    if (sec->flags & SHF_EXECINSTR) {
+      rx_secs.push_back(SecRef(i));
+    } else if (!(sec->flags & SHF_WRITE)) {
+      ro_secs.push_back(SecRef(i));
+    } else if (sec->type == SHT_NOBITS) {
+      bss_secs.push_back(SecRef(i));
+    } else {
+      rw_secs.push_back(SecRef(i));
+    }
+  }
+  // Keep init/fini arrays contiguous for DT_INIT_ARRAY/DT_FINI_ARRAY.
+  const auto rw_key = [&](SecRef ref) {
+    u32 type = assembler.get_section(ref).type;
+    return type == SHT_INIT_ARRAY ? 0 : type == SHT_FINI_ARRAY ? 1 : 2;
+  };
+  std::stable_sort(rw_secs.begin(), rw_secs.end(), [&](SecRef a, SecRef b) {
+    return rw_key(a) < rw_key(b);
+  });
+  // Cold code after everything else, away from the hot code.
+  std::stable_partition(rx_secs.begin(), rx_secs.end(), [&](SecRef ref) {
+    return ref != assembler.secref_text_cold;
+  });
+  return true;
+}
+
+bool ElfLinker::Linker::scan_relocs() noexcept {
+  // Scan relocations for required GOT entries, PLT stubs, and dynamic
+  // relocations.
+  got_slot.resize(sym_count);
+  plt_slot.resize(sym_count);
+  dynsym_idx.resize(sym_count);
+  for (const auto *secs : {&ro_secs, &rx_secs, &rw_secs}) {
+    for (SecRef ref : *secs) {
+      DataSection &sec = assembler.get_section(ref);
+      for (const Relocation &reloc : assembler.get_relocs(ref)) {
+        const SymRef sym = reloc.symbol;
+        const bool undef = is_undef(sym);
+        if (!undef && assembler.sym_ptr(sym)->st_shndx != SHN_ABS &&
+            !is_allocated(assembler.sym_section(sym))) {
+          TPDE_LOG_ERR("relocation against symbol {} in unallocated section",
+                       assembler.sym_name(sym));
+          return false;
+        }
+
+        switch (classify_reloc(machine, reloc.type)) {
+        case RelocKind::Direct:
+          if (undef) {
+            TPDE_LOG_ERR("relocation {} against undefined symbol {} is not "
+                         "position-independent",
+                         reloc.type,
+                         assembler.sym_name(sym));
+            return false;
+          }
+          break;
+        case RelocKind::Abs64:
+          if (!(sec.flags & SHF_WRITE)) {
+            TPDE_LOG_ERR("dynamic relocation in read-only section {}",
+                         assembler.sec_name(ref));
+            return false;
+          }
+          ++dyn_reloc_count;
+          if (undef) {
+            add_import(sym);
+          }
+          break;
+        case RelocKind::Call:
+          if (undef) {
+            add_got(sym);
+            if (!plt_slot[sym_idx(sym)]) {
+              plt_syms.push_back(sym);
+              plt_slot[sym_idx(sym)] = plt_syms.size();
+            }
+          }
+          break;
+        case RelocKind::Got:
+          if (is_a64 && reloc.addend != 0) {
+            TPDE_LOG_ERR("GOT relocation with addend is not supported");
+            return false;
+          }
+          if (!undef && reloc.type != R_X86_64_GOTPCREL && !is_a64 &&
+              reloc.offset >= 2 &&
+              is_relaxable_mov(sec.data_ptr(reloc.offset))) {
+            break;
+          }
+          add_got(sym);
+          break;
+        case RelocKind::Unsupported:
+          TPDE_LOG_ERR("unsupported relocation {} for dynamic linking",
+                       reloc.type);
+          return false;
+        }
+      }
+    }
+  }
+  if (main_sym.valid()) {
+    add_got(libc_start);
+  }
+  return true;
+}
+
+void ElfLinker::Linker::collect_dynsyms() noexcept {
+  // Dynamic symbols: imports first, then the exported symbols, which are
+  // ordered by their hash bucket as required by .gnu.hash.
+  for (const std::string &lib : options.needed) {
+    needed_names.push_back(dynstr.add(lib));
+  }
+  soname = options.soname.empty() ? 0 : dynstr.add(options.soname);
+
+  // Executables export nothing, all references are resolved locally.
+  for (size_t i = 0; !exe && i < assembler.global_symbols.size(); ++i) {
+    const Elf64_Sym &elf_sym = assembler.global_symbols[i];
+    const auto vis = ELF64_ST_VISIBILITY(elf_sym.st_other);
+    if (elf_sym.st_shndx == SHN_UNDEF ||
+        (vis != STV_DEFAULT && vis != STV_PROTECTED)) {
+      continue;
+    }
+    SymRef sym = SymRef(0x8000'0000 | i);
+    if (elf_sym.st_shndx != SHN_ABS &&
+        !is_allocated(assembler.sym_section(sym))) {
+      continue;
+    }
+    exports.push_back(Export{sym, gnu_hash(assembler.sym_name(sym))});
+  }
+
+  nbuckets = std::max<u32>(exports.size() / 4, 1);
+  while (bloom_words * 64 < exports.size() * 12) {
+    bloom_words *= 2;
+  }
+  std::stable_sort(
+      exports.begin(), exports.end(), [&](const Export &a, const Export &b) {
+        return a.hash % nbuckets < b.hash % nbuckets;
+      });
+
+  export_offset = 1 + imports.size();
+  dynsym_count = export_offset + exports.size();
+  for (SymRef sym : imports) {
+    dynsym_names.push_back(dynstr.add(assembler.sym_name(sym)));
+  }
+  for (const Export &exp : exports) {
+    dynsym_names.push_back(dynstr.add(assembler.sym_name(exp.sym)));
+  }
+
+  has_init = has_type(SHT_INIT_ARRAY);
+  has_fini = has_type(SHT_FINI_ARRAY);
+  dyn_count = options.needed.size() + (soname ? 1 : 0) + 11 +
+              (has_init ? 2 : 0) + (has_fini ? 2 : 0) + (exe ? 1 : 0) + 1;
+
+  // Count FDEs for .eh_frame_hdr.
+  const DataSection &eh_frame =
+      assembler.get_section(assembler.secref_eh_frame);
+  for (size_t pos = 0; pos + 8 <= eh_frame.data.size();) {
+    u32 len, id;
+    std::memcpy(&len, eh_frame.data.data() + pos, sizeof(len));
+    std::memcpy(&id, eh_frame.data.data() + pos + 4, sizeof(id));
+    if (len == 0) {
+      break;
+    }
+    fde_count += id != 0;
+    pos += 4 + len;
+  }
+
+  interp = options.interp;
+  if (exe && interp.empty()) {
+    interp = is_a64 ? "/lib/ld-linux-aarch64.so.1"
+                    : "/lib64/ld-linux-x86-64.so.2";
+  }
+}
+
+bool ElfLinker::Linker::layout() noexcept {
+  // Executables additionally have PT_PHDR and PT_INTERP.
+  phnum = exe ? 8 : 6;
+  off = sizeof(Elf64_Ehdr) + phnum * sizeof(Elf64_Phdr);
+  out_secs.emplace_back();
+  sec_map.resize(assembler.sections.size(), 0);
+
+  if (exe) {
+    interp_sec =
+        add_section(".interp", SHT_PROGBITS, SHF_ALLOC, interp.size() + 1, 1);
+  }
+  dynsym_sec = add_section(".dynsym",
+                           SHT_DYNSYM,
+                           SHF_ALLOC,
+                           dynsym_count * sizeof(Elf64_Sym),
+                           8,
+                           sizeof(Elf64_Sym));
+  dynstr_sec = add_section(".dynstr", SHT_STRTAB, SHF_ALLOC, dynstr.size(), 1);
+  const u64 gnu_hash_size =
+      16 + 8 * bloom_words + 4 * nbuckets + 4 * exports.size();
+  gnu_hash_sec =
+      add_section(".gnu.hash", SHT_GNU_HASH, SHF_ALLOC, gnu_hash_size, 8);
+  rela_sec = add_section(".rela.dyn",
+                         SHT_RELA,
+                         SHF_ALLOC,
+                         dyn_reloc_count * sizeof(Elf64_Rela),
+                         8,
+                         sizeof(Elf64_Rela));
+  eh_hdr_sec = add_section(
+      ".eh_frame_hdr", SHT_PROGBITS, SHF_ALLOC, 12 + 8 * fde_count, 4);
+  for (SecRef ref : ro_secs) {
+    add_asm_section(ref);
+  }
+  ro_end = off;
+
+  off = util::align_up(off, page_size);
+  rx_start = off;
+  plt_sec = add_section(".plt",
+                        SHT_PROGBITS,
+                        SHF_ALLOC | SHF_EXECINSTR,
+                        plt_syms.size() * PLT_ENTRY_SIZE,
+                        16);
+  if (start_size) {
+    start_sec = add_section(".text.start",
+                            SHT_PROGBITS,
+                            SHF_ALLOC | SHF_EXECINSTR,
+                            start_size,
+                            16);
+  }
+  for (SecRef ref : rx_secs) {
+    add_asm_section(ref);
+  }
+  rx_end = off;
+
+  off = util::align_up(off, page_size);
+  rw_start = off;
+  dynamic_sec = add_section(".dynamic",
+                            SHT_DYNAMIC,
+                            SHF_ALLOC | SHF_WRITE,
+                            dyn_count * sizeof(Elf64_Dyn),
+                            8,
+                            sizeof(Elf64_Dyn));
+  got_sec = add_section(
+      ".got", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, got_syms.size() * 8, 8);
+  for (SecRef ref : rw_secs) {
+    add_asm_section(ref);
+  }
+  rw_file_end = off;
+  rw_end = off;
+  for (SecRef ref : bss_secs) {
+    // NOBITS sections take no file space, place them after the data.
+    const u64 file_off = off;
+    off = rw_end;
+    u32 idx = add_asm_section(ref);
+    rw_end = out_secs[idx].addr + out_secs[idx].size;
+    off = file_off;
+  }
+
+  for (SecRef ref : debug_secs) {
+    add_asm_section(ref);
+  }
+
+  symtab.push_back(Elf64_Sym{});
+  u32 symtab_locals = 1;
+  symtab_sec = add_section(".symtab",
+                           SHT_SYMTAB,
+                           0,
+                           sym_count * sizeof(Elf64_Sym),
+                           8,
+                           sizeof(Elf64_Sym));
+  strtab_sec =
+      add_section(".strtab", SHT_STRTAB, 0, assembler.strtab.size(), 1);
+  const u32 shstrtab_name = shstrtab.add(".shstrtab");
+  shstrtab_sec = out_secs.size();
+  {
+    OutSection &out = out_secs.emplace_back();
+    out.name = shstrtab_name;
+    out.type = SHT_STRTAB;
+    // Size is set below, the section is written after all names are known.
+  }
+  if (out_secs.size() >= SHN_LORESERVE) {
+    TPDE_LOG_ERR("too many sections for linked output");
+    return false;
+  }
+
+  for (u32 i = 1; i < sym_count; ++i) {
+    const bool local = i < local_count;
+    SymRef sym = local ? SymRef(i) : SymRef(0x8000'0000 | (i - local_count));
+    Elf64_Sym elf_sym = *assembler.sym_ptr(sym);
+    const auto shndx = elf_sym.st_shndx;
+    if (shndx != SHN_UNDEF && shndx != SHN_ABS) {
+      SecRef sec = assembler.sym_section(sym);
+      if (!sec_map[sec.id()]) {
+        continue; // e.g., group section symbols
+      }
+      elf_sym.st_value = sym_addr(sym);
+      elf_sym.st_shndx = sec_map[sec.id()];
+    }
+    symtab.push_back(elf_sym);
+    symtab_locals += local;
+  }
+  out_secs[symtab_sec].size = symtab.size() * sizeof(Elf64_Sym);
+  out_secs[symtab_sec].link = strtab_sec;
+  out_secs[symtab_sec].info = symtab_locals;
+  // .strtab follows .symtab, which may have shrunk.
+  off = out_secs[symtab_sec].offset + out_secs[symtab_sec].size;
+  out_secs[strtab_sec].offset = off;
+  off += out_secs[strtab_sec].size;
+  out_secs[shstrtab_sec].offset = off;
+  out_secs[shstrtab_sec].size = shstrtab.size();
+  off += shstrtab.size();
+  shoff = util::align_up(off, 8);
+  file_size = shoff + out_secs.size() * sizeof(Elf64_Shdr);
+
+  out_secs[dynsym_sec].link = dynstr_sec;
+  out_secs[dynsym_sec].info = 1; // only the null symbol is local
+  out_secs[gnu_hash_sec].link = dynsym_sec;
+  out_secs[rela_sec].link = dynsym_sec;
+  out_secs[dynamic_sec].link = dynstr_sec;
+  return true;
+}
+
+bool ElfLinker::Linker::apply_relocs() noexcept {
+  // Copy section contents.
+  for (const auto *secs : {&ro_secs, &rx_secs, &rw_secs}) {
+    for (SecRef ref : *secs) {
+      u8 *dst = base + out_secs[sec_map[ref.id()]].addr;
+      assembler.get_section(ref).for_each_chunk(
+          [&dst](std::span<const u8> chunk) {
+            std::memcpy(dst, chunk.data(), chunk.size());
+            dst += chunk.size();
+            return true;
+          });
+    }
+  }
+
+  const u32 r_relative = is_a64 ? R_AARCH64_RELATIVE : R_X86_64_RELATIVE;
+  const u32 r_abs64 = is_a64 ? R_AARCH64_ABS64 : R_X86_64_64;
+
+  bool success = true;
+  const auto check_range =
+      [&](u64 val, unsigned bits, [[maybe_unused]] u32 type) {
+        if (util::sext(val, bits) != i64(val)) {
+          TPDE_LOG_ERR("relocation {} out of range: {:x}", type, val);
+          success = false;
+        }
+      };
+
+  for (const auto *secs : {&ro_secs, &rx_secs, &rw_secs}) {
+    for (SecRef ref : *secs) {
+      const u64 sec_addr = out_secs[sec_map[ref.id()]].addr;
+      for (const Relocation &reloc : assembler.get_relocs(ref)) {
+        const SymRef sym = reloc.symbol;
+        const bool undef = is_undef(sym);
+        const u64 p = sec_addr + reloc.offset;
+        u8 *const loc = base + p;
+        const u64 s = undef ? 0 : sym_addr(sym);
+        const u64 sa = s + reloc.addend;
+
+        if (reloc.type == r_abs64) {
+          if (undef) {
+            rela_sym.push_back(Elf64_Rela{
+                p,
+                ELF64_R_INFO(dynsym_idx[sym_idx(sym)], r_abs64),
+                reloc.addend});
+          } else {
+            rela_relative.push_back(
+                Elf64_Rela{p, ELF64_R_INFO(0, r_relative), i64(sa)});
+            write64(loc, sa);
+          }
+          continue;
+        }
+
+        if (!is_a64) {
+          switch (reloc.type) {
+          case R_X86_64_PC32:
+            check_range(sa - p, 32, reloc.type);
+            write32(loc, sa - p);
+            break;
+          case R_X86_64_PC64: write64(loc, sa - p); break;
+          case R_X86_64_PLT32: {
+            u64 v = (undef ? plt_addr(sym) : s) + reloc.addend - p;
+            check_range(v, 32, reloc.type);
+            write32(loc, v);
+            break;
+          }
+          case R_X86_64_GOTPCRELX:
+          case R_X86_64_REX_GOTPCRELX:
+            if (!got_slot[sym_idx(sym)]) {
+              // Relaxed during the scan: mov reg, [rip+x] -> lea.
+              loc[-2] = 0x8d;
+              check_range(sa - p, 32, reloc.type);
+              write32(loc, sa - p);
+              break;
+            }
+            [[fallthrough]];
+          case R_X86_64_GOTPCREL: {
+            u64 v = got_addr(sym) + reloc.addend - p;
+            check_range(v, 32, reloc.type);
+            write32(loc, v);
+            break;
+          }
+          default: TPDE_UNREACHABLE("unexpected relocation");
+          }
+          continue;
+        }
+
+        switch (reloc.type) {
+        case R_AARCH64_PREL32:
+          check_range(sa - p, 32, reloc.type);
+          write32(loc, sa - p);
+          break;
+        case R_AARCH64_PREL64: write64(loc, sa - p); break;
+        case R_AARCH64_CALL26:
+        case R_AARCH64_JUMP26: {
+          u64 v = (undef ? plt_addr(sym) : s) + reloc.addend - p;
+          check_range(v, 28, reloc.type);
+          blend(loc, 0x03ff'ffff, v >> 2);
+          break;
+        }
+        case R_AARCH64_ADR_PREL_PG_HI21: {
+          u64 v = util::align_down(sa, 0x1000) - util::align_down(p, 0x1000);
+          check_range(v, 33, reloc.type);
+          blend(loc, 0x60ff'ffe0, adrp_imm(v));
+          break;
+        }
+        case R_AARCH64_ADD_ABS_LO12_NC:
+        case R_AARCH64_LDST8_ABS_LO12_NC:
+          blend(loc, 0xfff << 10, (sa & 0xfff) << 10);
+          break;
+        case R_AARCH64_LDST16_ABS_LO12_NC:
+          blend(loc, 0xfff << 10, (sa & 0xfff) >> 1 << 10);
+          break;
+        case R_AARCH64_LDST32_ABS_LO12_NC:
+          blend(loc, 0xfff << 10, (sa & 0xfff) >> 2 << 10);
+          break;
+        case R_AARCH64_LDST64_ABS_LO12_NC:
+          blend(loc, 0xfff << 10, (sa & 0xfff) >> 3 << 10);
+          break;
+        case R_AARCH64_LDST128_ABS_LO12_NC:
+          blend(loc, 0xfff << 10, (sa & 0xfff) >> 4 << 10);
+          break;
+        case R_AARCH64_ADR_GOT_PAGE: {
+          u64 got = got_addr(sym);
+          u64 v = util::align_down(got, 0x1000) - util::align_down(p, 0x1000);
+          check_range(v, 33, reloc.type);
+          blend(loc, 0x60ff'ffe0, adrp_imm(v));
+          break;
+        }
+        case R_AARCH64_LD64_GOT_LO12_NC:
+          blend(loc, 0xfff << 10, (got_addr(sym) & 0xfff) >> 3 << 10);
+          break;
+        default: TPDE_UNREACHABLE("unexpected relocation");
+        }
+      }
+    }
+  }
+  return success;
+}
+
+bool ElfLinker::Linker::apply_debug_relocs() noexcept {
+  // Debug sections only refer to addresses of allocated sections and to
+  // offsets into other debug sections, so they need no dynamic relocations.
+  const u32 r_abs32 = is_a64 ? R_AARCH64_ABS32 : R_X86_64_32;
+  const u32 r_abs64 = is_a64 ? R_AARCH64_ABS64 : R_X86_64_64;
+  for (SecRef ref : debug_secs) {
+    const u64 sec_off = out_secs[sec_map[ref.id()]].offset;
+    u8 *dst = base + sec_off;
+    assembler.get_section(ref).for_each_chunk(
+        [&dst](std::span<const u8> chunk) {
+          std::memcpy(dst, chunk.data(), chunk.size());
+          dst += chunk.size();
+          return true;
+        });
+
+    for (const Relocation &reloc : assembler.get_relocs(ref)) {
+      const SymRef sym = reloc.symbol;
+      if (is_undef(sym) || (assembler.sym_ptr(sym)->st_shndx != SHN_ABS &&
+                            !sec_map[assembler.sym_section(sym).id()])) {
+        TPDE_LOG_ERR("relocation in {} against symbol {} not in output",
+                     assembler.sec_name(ref),
+                     assembler.sym_name(sym));
+        return false;
+      }
+      // Non-allocated sections have address zero, so this is the offset
+      // into the target debug section.
+      const u64 sa = sym_addr(sym) + reloc.addend;
+      u8 *const loc = base + sec_off + reloc.offset;
+      if (reloc.type == r_abs64) {
+        write64(loc, sa);
+      } else if (reloc.type == r_abs32 && sa <= 0xffff'ffff) {
+        write32(loc, sa);
+      } else {
+        TPDE_LOG_ERR("unsupported relocation {} in {}",
+                     reloc.type,
+                     assembler.sec_name(ref));
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void ElfLinker::Linker::write_dynamic() noexcept {
+  const u32 r_relative = is_a64 ? R_AARCH64_RELATIVE : R_X86_64_RELATIVE;
+  const u32 r_glob_dat = is_a64 ? R_AARCH64_GLOB_DAT : R_X86_64_GLOB_DAT;
+
+  // GOT entries are filled by the dynamic loader.
+  for (SymRef sym : got_syms) {
+    const u64 addr = got_addr(sym);
+    if (is_undef(sym)) {
+      rela_sym.push_back(Elf64_Rela{
+          addr, ELF64_R_INFO(dynsym_idx[sym_idx(sym)], r_glob_dat), 0});
+    } else {
+      const u64 s = sym_addr(sym);
+      rela_relative.push_back(
+          Elf64_Rela{addr, ELF64_R_INFO(0, r_relative), i64(s)});
+      write64(base + addr, s);
+    }
+  }
+
+  // PLT stubs jump through the GOT entry of the symbol.
+  for (SymRef sym : plt_syms) {
+    const u64 stub = plt_addr(sym);
+    const u64 got = got_addr(sym);
+    u8 *dst = base + stub;
+    if (!is_a64) {
+      // jmp qword ptr [rip + got]; ud2; int3 padding
+      dst[0] = 0xff;
+      dst[1] = 0x25;
+      write32(dst + 2, got - (stub + 6));
+      dst[6] = 0x0f;
+      dst[7] = 0x0b;
+      std::memset(dst + 8, 0xcc, PLT_ENTRY_SIZE - 8);
+    } else {
+      // adrp x16, got; ldr x17, [x16, :lo12:got]; br x17; nop
+      u64 page_diff =
+          util::align_down(got, 0x1000) - util::align_down(stub, 0x1000);
+      write32(dst + 0, 0x9000'0010 | adrp_imm(page_diff));
+      write32(dst + 4, 0xf940'0211 | ((got & 0xfff) >> 3) << 10);
+      write32(dst + 8, 0xd61f'0220);
+      write32(dst + 12, 0xd503'201f);
+    }
+  }
+
+  if (start_sec) {
+    const u64 stub = out_secs[start_sec].addr;
+    const u64 main_addr = sym_addr(main_sym);
+    const u64 got = got_addr(libc_start);
+    u8 *dst = base + stub;
+    if (!is_a64) {
+      std::memcpy(dst, X64_START, sizeof(X64_START));
+      write32(dst + 23, main_addr - (stub + 27));
+      write32(dst + 29, got - (stub + 33));
+    } else {
+      std::memcpy(dst, A64_START, sizeof(A64_START));
+      u64 main_page = util::align_down(main_addr, 0x1000);
+      u64 got_page = util::align_down(got, 0x1000);
+      u64 pc_page = util::align_down(stub + 24, 0x1000);
+      blend(dst + 24, 0x60ff'ffe0, adrp_imm(main_page - pc_page));
+      blend(dst + 28, 0xfff << 10, (main_addr & 0xfff) << 10);
+      pc_page = util::align_down(stub + 40, 0x1000);
+      blend(dst + 40, 0x60ff'ffe0, adrp_imm(got_page - pc_page));
+      blend(dst + 44, 0xfff << 10, (got & 0xfff) >> 3 << 10);
+    }
+  }
+
+  // Dynamic relocations
+  assert(rela_relative.size() + rela_sym.size() == dyn_reloc_count);
+  {
+    u8 *dst = base + out_secs[rela_sec].addr;
+    std::memcpy(dst,
+                rela_relative.data(),
+                rela_relative.size() * sizeof(Elf64_Rela));
+    dst += rela_relative.size() * sizeof(Elf64_Rela);
+    std::memcpy(dst, rela_sym.data(), rela_sym.size() * sizeof(Elf64_Rela));
+  }
+
+  // Dynamic symbols
+  {
+    auto *dst =
+        reinterpret_cast<Elf64_Sym *>(base + out_secs[dynsym_sec].addr);
+    for (u32 i = 0; i < imports.size(); ++i) {
+      const Elf64_Sym *elf_sym = assembler.sym_ptr(imports[i]);
+      dst[1 + i] = Elf64_Sym{
+          .st_name = dynsym_names[i],
+          .st_info = elf_sym->st_info,
+          .st_other = elf_sym->st_other,
+          .st_shndx = SHN_UNDEF,
+          .st_value = 0,
+          .st_size = 0,
+      };
+    }
+    for (u32 i = 0; i < exports.size(); ++i) {
+      const SymRef sym = exports[i].sym;
+      const Elf64_Sym *elf_sym = assembler.sym_ptr(sym);
+      dst[export_offset + i] = Elf64_Sym{
+          .st_name = dynsym_names[imports.size() + i],
+          .st_info = elf_sym->st_info,
+          .st_other = elf_sym->st_other,
+          .st_shndx = sym_shndx(sym),
+          .st_value = sym_addr(sym),
+          .st_size = elf_sym->st_size,
+      };
+    }
+    std::memcpy(
+        base + out_secs[dynstr_sec].addr, dynstr.data(), dynstr.size());
+  }
+
+  // .gnu.hash
+  {
+    u8 *dst = base + out_secs[gnu_hash_sec].addr;
+    u32 header[4] = {nbuckets, export_offset, bloom_words, BLOOM_SHIFT};
+    std::memcpy(dst, header, sizeof(header));
+    auto *bloom = reinterpret_cast<u64 *>(dst + sizeof(header));
+    auto *buckets = reinterpret_cast<u32 *>(bloom + bloom_words);
+    u32 *chain = buckets + nbuckets;
+    for (u32 i = 0; i < exports.size(); ++i) {
+      const u32 h = exports[i].hash;
+      bloom[(h / 64) % bloom_words] |=
+          u64{1} << (h % 64) | u64{1} << ((h >> BLOOM_SHIFT) % 64);
+      const u32 bucket = h % nbuckets;
+      if (!buckets[bucket]) {
+        buckets[bucket] = export_offset + i;
+      }
+      const bool last =
+          i + 1 == exports.size() || exports[i + 1].hash % nbuckets != bucket;
+      chain[i] = (h & ~1u) | (last ? 1 : 0);
+    }
+  }
+
+  // .dynamic
+  {
+    util::SmallVector<Elf64_Dyn, 32> dyn;
+    const auto add_dyn = [&](i64 tag, u64 val) {
+      dyn.push_back(Elf64_Dyn{tag, {val}});
+    };
+    for (u32 name : needed_names) {
+      add_dyn(DT_NEEDED, name);
+    }
+    if (soname) {
+      add_dyn(DT_SONAME, soname);
+    }
+    add_dyn(DT_GNU_HASH, out_secs[gnu_hash_sec].addr);
+    add_dyn(DT_STRTAB, out_secs[dynstr_sec].addr);
+    add_dyn(DT_SYMTAB, out_secs[dynsym_sec].addr);
+    add_dyn(DT_STRSZ, dynstr.size());
+    add_dyn(DT_SYMENT, sizeof(Elf64_Sym));
+    add_dyn(DT_RELA, out_secs[rela_sec].addr);
+    add_dyn(DT_RELASZ, out_secs[rela_sec].size);
+    add_dyn(DT_RELAENT, sizeof(Elf64_Rela));
+    add_dyn(DT_RELACOUNT, rela_relative.size());
+    const auto array_bounds = [&](u32 type) {
+      u64 start = ~u64{0}, end = 0;
+      for (SecRef ref : rw_secs) {
+        if (assembler.get_section(ref).type == type) {
+          const OutSection &out = out_secs[sec_map[ref.id()]];
+          start = std::min(start, out.addr);
+          end = std::max(end, out.addr + out.size);
+        }
+      }
+      return std::make_pair(start, end - start);
+    };
+    if (has_init) {
+      auto [addr, size] = array_bounds(SHT_INIT_ARRAY);
+      add_dyn(DT_INIT_ARRAY, addr);
+      add_dyn(DT_INIT_ARRAYSZ, size);
+    }
+    if (has_fini) {
+      auto [addr, size] = array_bounds(SHT_FINI_ARRAY);
+      add_dyn(DT_FINI_ARRAY, addr);
+      add_dyn(DT_FINI_ARRAYSZ, size);
+    }
+    if (exe) {
+      add_dyn(DT_DEBUG, 0);
+    }
+    add_dyn(DT_FLAGS, DF_BIND_NOW);
+    add_dyn(DT_FLAGS_1, exe ? DF_1_NOW | DF_1_PIE : DF_1_NOW);
+    add_dyn(DT_NULL, 0);
+    assert(dyn.size() == dyn_count);
+    std::memcpy(base + out_secs[dynamic_sec].addr,
+                dyn.data(),
+                dyn.size() * sizeof(Elf64_Dyn));
+  }
+
+  if (interp_sec) {
+    std::memcpy(
+        base + out_secs[interp_sec].addr, interp.data(), interp.size());
+  }
+}
+
+void ElfLinker::Linker::write_eh_frame_hdr() noexcept {
+  // .eh_frame_hdr, with a table of FDEs sorted by their start address.
+  const DataSection &eh_frame =
+      assembler.get_section(assembler.secref_eh_frame);
+  const u64 hdr = out_secs[eh_hdr_sec].addr;
+  const u64 eh_addr = out_secs[sec_map[assembler.secref_eh_frame.id()]].addr;
+  util::SmallVector<std::pair<u64, u64>> table;
+  for (size_t pos = 0; pos + 8 <= eh_frame.data.size();) {
+    u32 len, id;
+    std::memcpy(&len, base + eh_addr + pos, sizeof(len));
+    std::memcpy(&id, base + eh_addr + pos + 4, sizeof(id));
+    if (len == 0) {
+      break;
+    }
+    if (id != 0) {
+      i32 pc_rel;
+      std::memcpy(&pc_rel, base + eh_addr + pos + 8, sizeof(pc_rel));
+      table.emplace_back(eh_addr + pos + 8 + pc_rel, eh_addr + pos);
+    }
+    pos += 4 + len;
+  }
+  std::sort(table.begin(), table.end());
+
+  u8 *dst = base + hdr;
+  dst[0] = 1; // version
+  dst[1] = dwarf::DW_EH_PE_pcrel | dwarf::DW_EH_PE_sdata4;
+  dst[2] = dwarf::DW_EH_PE_udata4;
+  dst[3] = dwarf::DW_EH_PE_datarel | dwarf::DW_EH_PE_sdata4;
+  write32(dst + 4, eh_addr - (hdr + 4));
+  write32(dst + 8, table.size());
+  for (size_t i = 0; i < table.size(); ++i) {
+    write32(dst + 12 + 8 * i, table[i].first - hdr);
+    write32(dst + 16 + 8 * i, table[i].second - hdr);
+  }
+}
+
+void ElfLinker::Linker::write_headers() noexcept {
+  // Non-allocated sections
+  std::memcpy(base + out_secs[symtab_sec].offset,
+              symtab.data(),
+              symtab.size() * sizeof(Elf64_Sym));
+  std::memcpy(base + out_secs[strtab_sec].offset,
+              assembler.strtab.data(),
+              assembler.strtab.size());
+  std::memcpy(
+      base + out_secs[shstrtab_sec].offset, shstrtab.data(), shstrtab.size());
+
+  // Section headers
+  {
+    auto *shdrs = reinterpret_cast<Elf64_Shdr *>(base + shoff);
+    for (size_t i = 1; i < out_secs.size(); ++i) {
+      const OutSection &out = out_secs[i];
+      shdrs[i] = Elf64_Shdr{
+          .sh_name = out.name,
+          .sh_type = out.type,
+          .sh_flags = out.flags,
+          .sh_addr = out.addr,
+          .sh_offset = out.offset,
+          .sh_size = out.size,
+          .sh_link = out.link,
+          .sh_info = out.info,
+          .sh_addralign = out.align,
+          .sh_entsize = out.entsize,
+      };
+    }
+  }
+
+  // Program headers, empty segments are left as PT_NULL.
+  {
+    auto *phdr = reinterpret_cast<Elf64_Phdr *>(base + sizeof(Elf64_Ehdr));
+    const auto segment = [&](u32 type,
+                             u32 flags,
+                             u64 start,
+                             u64 file_end,
+                             u64 mem_end,
+                             u64 align) {
+      if (mem_end != start || type != PT_LOAD) {
+        *phdr = Elf64_Phdr{
+            .p_type = type,
+            .p_flags = flags,
+            .p_offset = start,
+            .p_vaddr = start,
+            .p_paddr = start,
+            .p_filesz = file_end - start,
+            .p_memsz = mem_end - start,
+            .p_align = align,
+        };
+      }
+      ++phdr;
+    };
+    const auto sec_segment = [&](u32 type, u32 flags, u32 sec, u64 align) {
+      const OutSection &out = out_secs[sec];
+      const u64 end = out.addr + out.size;
+      segment(type, flags, out.addr, end, end, align);
+    };
+    if (exe) {
+      const u64 phdr_start = sizeof(Elf64_Ehdr);
+      const u64 phdr_end = phdr_start + phnum * sizeof(Elf64_Phdr);
+      segment(PT_PHDR, PF_R, phdr_start, phdr_end, phdr_end, 8);
+      sec_segment(PT_INTERP, PF_R, interp_sec, 1);
+    }
+    segment(PT_LOAD, PF_R, 0, ro_end, ro_end, page_size);
+    segment(PT_LOAD, PF_R | PF_X, rx_start, rx_end, rx_end, page_size);
+    segment(PT_LOAD, PF_R | PF_W, rw_start, rw_file_end, rw_end, page_size);
+    sec_segment(PT_DYNAMIC, PF_R | PF_W, dynamic_sec, 8);
+    sec_segment(PT_GNU_EH_FRAME, PF_R, eh_hdr_sec, 4);
+    segment(PT_GNU_STACK, PF_R | PF_W, 0, 0, 0, 16);
+  }
+
+  // ELF header
+  const auto &target_info =
+      static_cast<const AssemblerElf::TargetInfoElf &>(assembler.target_info);
+  Elf64_Ehdr ehdr{};
+  ehdr.e_ident[0] = ELFMAG0;
+  ehdr.e_ident[1] = ELFMAG1;
+  ehdr.e_ident[2] = ELFMAG2;
+  ehdr.e_ident[3] = ELFMAG3;
+  ehdr.e_ident[4] = ELFCLASS64;
+  ehdr.e_ident[5] = ELFDATA2LSB;
+  ehdr.e_ident[6] = EV_CURRENT;
+  ehdr.e_ident[7] = target_info.elf_osabi;
+  ehdr.e_type = ET_DYN;
+  ehdr.e_machine = machine;
+  ehdr.e_version = EV_CURRENT;
+  if (entry_sym.valid()) {
+    ehdr.e_entry = sym_addr(entry_sym);
+  } else if (start_sec) {
+    ehdr.e_entry = out_secs[start_sec].addr;
+  }
+  ehdr.e_phoff = sizeof(Elf64_Ehdr);
+  ehdr.e_shoff = shoff;
+  ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+  ehdr.e_phentsize = sizeof(Elf64_Phdr);
+  ehdr.e_phnum = phnum;
+  ehdr.e_shentsize = sizeof(Elf64_Shdr);
+  ehdr.e_shnum = out_secs.size();
+  ehdr.e_shstrndx = shstrtab_sec;
+  std::memcpy(base, &ehdr, sizeof(ehdr));
+}
+
+bool ElfLinker::Linker::link(Assembler::ObjectSink sink) noexcept {
+  if (machine != EM_X86_64 && machine != EM_AARCH64) {
+    TPDE_LOG_ERR("unsupported machine {} for linking", machine);
+    return false;
+  }
+  if (exe && !find_entry()) {
+    return false;
+  }
+  local_count = assembler.local_symbols.size();
+  sym_count = local_count + assembler.global_symbols.size();
+  if (!sort_sections() || !scan_relocs()) {
+    return false;
+  }
+  collect_dynsyms();
+  if (!layout()) {
+    return false;
+  }
+
+  image.resize(file_size);
+  base = image.data();
+  if (!apply_relocs() || !apply_debug_relocs()) {
+    return false;
+  }
+  write_dynamic();
+  write_eh_frame_hdr();
+  write_headers();
+  return sink(image);
+}
+
+bool ElfLinker::link(AssemblerElf &assembler,
+                     const Options &options,
+                     Assembler::ObjectSink sink,
+                     bool exe) noexcept {
+  return Linker(assembler, options, exe).link(sink);
+}
+
+} // namespace tpde
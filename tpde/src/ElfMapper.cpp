@@ -4,12 +4,22 @@
 #include "tpde/ElfMapper.hpp"
 
 #include <algorithm>
+#include <cerrno>
 #include <compare>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <elf.h>
+#include <fcntl.h>
+#include <format>
+#include <mutex>
+#include <string>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include "tpde/AssemblerElf.hpp"
 #include "tpde/base.hpp"
+#include "tpde/util/SmallBitSet.hpp"
 #include "tpde/util/SmallVector.hpp"
 #include "tpde/util/misc.hpp"
 
@@ -21,6 +31,36 @@
 extern "C" void __register_frame(void *);
 extern "C" void __deregister_frame(void *);
 
+// GDB JIT interface, see "JIT Compilation Interface" in the gdb manual. The
+// definitions are weak, so that a definition elsewhere in the process (e.g.,
+// from LLVM) is used instead and gdb sees a single descriptor. Registrations
+// are only synchronized among ElfMappers; registering code from another JIT
+// concurrently is unsupported, as its lock is not shared.
+extern "C" {
+enum jit_actions_t { JIT_NOACTION = 0, JIT_REGISTER_FN, JIT_UNREGISTER_FN };
+
+struct jit_code_entry {
+  jit_code_entry *next_entry;
+  jit_code_entry *prev_entry;
+  const char *symfile_addr;
+  uint64_t symfile_size;
+};
+
+struct jit_descriptor {
+  uint32_t version;
+  uint32_t action_flag;
+  jit_code_entry *relevant_entry;
+  jit_code_entry *first_entry;
+};
+
+[[gnu::weak, gnu::noinline]] void __jit_debug_register_code() {
+  // gdb sets a breakpoint here, which must not be optimized away.
+  asm volatile("" ::: "memory");
+}
+
+[[gnu::weak]] jit_descriptor __jit_debug_descriptor = {1, 0, nullptr, nullptr};
+}
+
 #else
   #error "unsupported architecture/os combo"
 #endif
@@ -43,6 +83,171 @@ static constexpr Arch TargetArch = Arch::AArch64;
 static constexpr Arch TargetArch = Arch::Unknown;
 #endif
 
+/// Protects __jit_debug_descriptor against concurrent ElfMappers.
+std::mutex gdb_jit_mutex;
+
+/// Process-wide perf map and jitdump files, shared by all mappers and opened
+/// on first use.
+class PerfFiles {
+  std::mutex mutex;
+  int map_fd = -1;
+  int dump_fd = -1;
+  void *dump_marker = nullptr;
+  u64 code_index = 0;
+  bool dump_failed = false;
+
+public:
+  ~PerfFiles() {
+    if (dump_fd >= 0) {
+      // JIT_CODE_CLOSE
+      write_record(3, {});
+      munmap(dump_marker, ::getpagesize());
+      ::close(dump_fd);
+    }
+    if (map_fd >= 0) {
+      ::close(map_fd);
+    }
+  }
+
+  static PerfFiles &get() noexcept {
+    static PerfFiles files;
+    return files;
+  }
+
+  std::unique_lock<std::mutex> lock() noexcept {
+    return std::unique_lock<std::mutex>(mutex);
+  }
+
+  static u64 timestamp() noexcept {
+    // perf record -k 1 uses CLOCK_MONOTONIC.
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return u64(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+  }
+
+  static bool write_all(int fd, std::span<const u8> data) noexcept {
+    while (!data.empty()) {
+      ssize_t res = ::write(fd, data.data(), data.size());
+      if (res < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      data = data.subspan(res);
+    }
+    return true;
+  }
+
+  /// Append a line to the perf map, which must be locked.
+  void write_map_entry(u64 addr, u64 size, std::string_view name) noexcept {
+    if (map_fd < 0) {
+      char path[64];
+      snprintf(path, sizeof(path), "/tmp/perf-%d.map", int(::getpid()));
+      map_fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (map_fd < 0) {
+        TPDE_LOG_ERR("failed to open perf map {}", path);
+        return;
+      }
+    }
+    std::string line = std::format("{:x} {:x} {}\n", addr, size, name);
+    write_all(map_fd, {reinterpret_cast<const u8 *>(line.data()), line.size()});
+  }
+
+  /// Open the jitdump file, which must be locked. Returns false on failure.
+  bool open_dump() noexcept {
+    if (dump_fd >= 0 || dump_failed) {
+      return !dump_failed;
+    }
+    dump_failed = true;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/jit-%d.dump", int(::getpid()));
+    dump_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (dump_fd < 0) {
+      TPDE_LOG_ERR("failed to open jitdump file {}", path);
+      return false;
+    }
+    // perf finds the file through an executable mapping of it.
+    dump_marker = ::mmap(nullptr,
+                         ::getpagesize(),
+                         PROT_READ | PROT_EXEC,
+                         MAP_PRIVATE,
+                         dump_fd,
+                         0);
+    if (dump_marker == MAP_FAILED) {
+      TPDE_LOG_ERR("failed to map jitdump file {}", path);
+      ::close(dump_fd);
+      dump_fd = -1;
+      return false;
+    }
+
+    struct {
+      u32 magic = 0x4a69'5444; // "JiTD"
+      u32 version = 1;
+      u32 total_size = 40;
+      u32 elf_mach;
+      u32 pad1 = 0;
+      u32 pid;
+      u64 timestamp;
+      u64 flags = 0;
+    } header;
+    header.elf_mach = TargetArch == Arch::AArch64 ? EM_AARCH64 : EM_X86_64;
+    header.pid = ::getpid();
+    header.timestamp = timestamp();
+    write_all(dump_fd, {reinterpret_cast<const u8 *>(&header), sizeof(header)});
+    dump_failed = false;
+    return true;
+  }
+
+  /// Write a jitdump record, the file must be open and locked.
+  void write_record(u32 id, std::span<const u8> body) noexcept {
+    struct {
+      u32 id;
+      u32 total_size;
+      u64 timestamp;
+    } header{id, u32(16 + body.size()), timestamp()};
+    write_all(dump_fd, {reinterpret_cast<const u8 *>(&header), sizeof(header)});
+    write_all(dump_fd, body);
+  }
+
+  /// Write JIT_CODE_DEBUG_INFO and JIT_CODE_LOAD records for a function, the
+  /// file must be open and locked.
+  void write_code_load(const u8 *code,
+                       u64 size,
+                       std::string_view name,
+                       std::span<const u8> debug_entries,
+                       u64 debug_entry_count) noexcept {
+    util::SmallVector<u8, 256> body;
+    const auto append = [&body](const void *data, size_t len) {
+      const size_t off = body.size();
+      body.resize(off + len);
+      std::memcpy(body.data() + off, data, len);
+    };
+    const u64 addr = reinterpret_cast<u64>(code);
+    if (debug_entry_count) {
+      append(&addr, 8);
+      append(&debug_entry_count, 8);
+      append(debug_entries.data(), debug_entries.size());
+      write_record(2, body);
+      body.clear();
+    }
+
+    const u32 pid = ::getpid();
+    const u32 tid = ::syscall(SYS_gettid);
+    append(&pid, 4);
+    append(&tid, 4);
+    append(&addr, 8); // vma
+    append(&addr, 8); // code_addr
+    append(&size, 8);
+    append(&code_index, 8);
+    append(name.data(), name.size());
+    body.push_back(0);
+    append(code, size);
+    write_record(0, body);
+    ++code_index;
+  }
+};
+
 } // anonymous namespace
 
 void ElfMapper::reset() noexcept {
@@ -50,6 +255,9 @@ void ElfMapper::reset() noexcept {
     return;
   }
 
+  if (gdb_jit_entry) {
+    gdb_unregister();
+  }
   if (registered_frame_off) {
     __deregister_frame(mapped_addr + registered_frame_off);
   }
@@ -60,10 +268,42 @@ void ElfMapper::reset() noexcept {
 }
 
 bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
-  // Approximate number of PLT/GOT slots.
-  // TODO: better approximation
-  u32 got_plt_slot_count =
-      assembler.local_symbols.size() + assembler.global_symbols.size();
+  // Upper bound for the number of PLT/GOT slots: every symbol that is the
+  // target of a call or GOT relocation might need one.
+  u32 got_plt_slot_count = 0;
+  {
+    u32 local_count = assembler.local_symbols.size();
+    util::SmallBitSet<256> needs_slot;
+    needs_slot.resize(local_count + assembler.global_symbols.size());
+    needs_slot.zero();
+    for (size_t i = 0; i < assembler.sections.size(); ++i) {
+      if (!assembler.sections[i] ||
+          !(assembler.sections[i]->flags & SHF_ALLOC)) {
+        continue;
+      }
+      for (const auto &reloc : assembler.get_relocs(SecRef(i))) {
+        switch (reloc.type) {
+        case R_X86_64_PLT32:
+        case R_X86_64_GOTPCREL:
+        case R_X86_64_GOTPCRELX:
+        case R_X86_64_REX_GOTPCRELX:
+        case R_AARCH64_CALL26:
+        case R_AARCH64_JUMP26:
+        case R_AARCH64_ADR_GOT_PAGE:
+        case R_AARCH64_LD64_GOT_LO12_NC: break;
+        default: continue;
+        }
+        u32 idx = AssemblerElf::sym_idx(reloc.symbol);
+        if (!AssemblerElf::sym_is_local(reloc.symbol)) {
+          idx += local_count;
+        }
+        if (!needs_slot.is_set(idx)) {
+          needs_slot.mark_set(idx);
+          ++got_plt_slot_count;
+        }
+      }
+    }
+  }
 
 #ifdef __x86_64__
   // PLT+GOT slot: jmp qword ptr [rip + 2]; ud2; <address>
@@ -99,6 +339,8 @@ bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
     sort_key |= !(sec.flags & SHF_WRITE) ? 0 : (1 << 1);
     // bss sections after data sections
     sort_key |= !(sec.type == SHT_NOBITS) ? 0 : (1 << 0);
+    // cold code after everything else, away from the hot code
+    sort_key |= SecRef(i) != assembler.secref_text_cold ? 0 : (1 << 3);
 
     alloc_sections.emplace_back(SecRef(i), sort_key);
   }
@@ -246,6 +488,37 @@ bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
     u32 *dest = reinterpret_cast<u32 *>(pc);
     *dest = (data & mask) | (*dest & ~mask);
   };
+  // Relax adrp+ldr from the GOT into adrp+add of the symbol address if the
+  // pair is adjacent and the symbol is in range.
+  const auto relax_got_pair = [&](u8 *sec_addr,
+                                  const Relocation &page,
+                                  const Relocation &lo12) {
+    if (page.type != R_AARCH64_ADR_GOT_PAGE ||
+        lo12.type != R_AARCH64_LD64_GOT_LO12_NC ||
+        page.symbol != lo12.symbol || page.addend != lo12.addend ||
+        lo12.offset != page.offset + 4) {
+      return false;
+    }
+    uintptr_t pc = reinterpret_cast<uintptr_t>(sec_addr + page.offset);
+    u32 adrp = *reinterpret_cast<u32 *>(pc);
+    u32 ldr = *reinterpret_cast<u32 *>(pc + 4);
+    // ldr xt, [xn, #imm] with xn being the destination of the adrp.
+    if ((ldr & 0xffc0'0000) != 0xf940'0000 ||
+        ((ldr >> 5) & 0x1f) != (adrp & 0x1f)) {
+      return false;
+    }
+    uintptr_t syma =
+        reinterpret_cast<uintptr_t>(sym_addr(page.symbol)) + page.addend;
+    auto v = util::align_down(syma, 0x1000) - util::align_down(pc, 0x1000);
+    if (util::sext(v, 33) != intptr_t(v)) {
+      return false;
+    }
+    v >>= 12;
+    blend(pc, 0x60ff'ffe0, (v & 3) << 29 | (((v >> 2) & 0x7'ffff) << 5));
+    *reinterpret_cast<u32 *>(pc + 4) =
+        de64_ADDxi(DA_GP(ldr & 0x1f), DA_GP(adrp & 0x1f), syma & 0xfff);
+    return true;
+  };
   const auto resolve_reloc = [&](u8 *sec_addr, Relocation &reloc) {
     SymRef sym_ref = reloc.symbol;
     uintptr_t sym = reinterpret_cast<uintptr_t>(sym_addr(sym_ref));
@@ -282,6 +555,20 @@ bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
         std::memcpy(reinterpret_cast<u8 *>(pc), &v32, sizeof(u32));
         break;
       }
+      case R_X86_64_GOTPCRELX:
+      case R_X86_64_REX_GOTPCRELX: {
+        // Relax mov reg, [rip + GOT] to lea reg, [rip + sym] if in range.
+        u8 *insn = reinterpret_cast<u8 *>(pc);
+        auto v = syma - pc;
+        if (insn[-2] == 0x8b && (insn[-1] & 0xc7) == 0x05 &&
+            util::sext(v, 32) == intptr_t(v)) {
+          insn[-2] = 0x8d;
+          u32 v32 = v;
+          std::memcpy(insn, &v32, sizeof(u32));
+          break;
+        }
+        [[fallthrough]];
+      }
       case R_X86_64_GOTPCREL: {
         auto got = got_entry(sym_idx(sym_ref), sym);
         auto v = got + reloc.addend - pc;
@@ -314,13 +601,14 @@ bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
         std::memcpy(reinterpret_cast<u8 *>(pc), &v32, sizeof(u32));
         break;
       }
-      case R_AARCH64_CALL26: {
+      case R_AARCH64_CALL26:
+      case R_AARCH64_JUMP26: {
         auto v = syma - pc;
         if ((v & 3) || util::sext(v, 28) != intptr_t(v)) {
           v = plt_entry(sym_idx(sym_ref), sym) + reloc.addend - pc;
         }
         if (util::sext(v, 32) != intptr_t(v)) {
-          TPDE_LOG_ERR("R_AARCH64_CALL26 out of range: {:x}", v);
+          TPDE_LOG_ERR("R_AARCH64_CALL26/JUMP26 out of range: {:x}", v);
           success = false;
         }
         blend(pc, 0x03ff'ffff, v >> 2);
@@ -365,12 +653,25 @@ bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
     auto &sec = assembler.get_section(as.section);
     // No need to zero bss, mmap zero-initializes memory.
     if (sec.type != SHT_NOBITS) {
-      std::memcpy(mapped_addr + sec.addr, sec.data.data(), sec.size());
+      u8 *dst = mapped_addr + sec.addr;
+      sec.for_each_chunk([&dst](std::span<const u8> chunk) {
+        std::memcpy(dst, chunk.data(), chunk.size());
+        dst += chunk.size();
+        return true;
+      });
     }
 
     u8 *sec_addr = mapped_addr + sec.addr;
-    for (auto &reloc : assembler.get_relocs(as.section)) {
-      resolve_reloc(sec_addr, reloc);
+    auto relocs = assembler.get_relocs(as.section);
+    for (size_t i = 0; i < relocs.size(); ++i) {
+      if constexpr (TargetArch == Arch::AArch64) {
+        if (i + 1 < relocs.size() &&
+            relax_got_pair(sec_addr, relocs[i], relocs[i + 1])) {
+          ++i;
+          continue;
+        }
+      }
+      resolve_reloc(sec_addr, relocs[i]);
     }
   }
 
@@ -400,6 +701,13 @@ bool ElfMapper::map(AssemblerElf &assembler, SymbolResolver resolver) noexcept {
   registered_frame_off = eh_frame.addr + assembler.eh_first_fde_off;
   __register_frame(mapped_addr + registered_frame_off);
 
+  if (perf_map || jitdump) [[unlikely]] {
+    perf_record(assembler);
+  }
+  if (gdb_jit) [[unlikely]] {
+    gdb_register(assembler);
+  }
+
   return true;
 }
 
@@ -412,4 +720,291 @@ void *ElfMapper::get_sym_addr(SymRef sym) noexcept {
   return sym_addrs[idx];
 }
 
+void ElfMapper::perf_record(const AssemblerElf &assembler) noexcept {
+  PerfFiles &files = PerfFiles::get();
+  auto lock = files.lock();
+  const bool write_dump = jitdump && files.open_dump();
+
+  // Line table sequences ordered by section and offset, to find the rows of
+  // each function.
+  util::SmallVector<u32> seqs;
+  if (write_dump) {
+    for (u32 i = 0; i < assembler.line_seqs.size(); ++i) {
+      seqs.push_back(i);
+    }
+    std::sort(seqs.begin(), seqs.end(), [&](u32 a, u32 b) {
+      const auto &seq_a = assembler.line_seqs[a];
+      const auto &seq_b = assembler.line_seqs[b];
+      return std::make_pair(seq_a.sec.id(), seq_a.begin) <
+             std::make_pair(seq_b.sec.id(), seq_b.begin);
+    });
+  }
+  util::SmallVector<std::string, 0> file_paths;
+  if (write_dump) {
+    for (const auto &[dir_idx, name] : assembler.line_files) {
+      const std::string &dir = assembler.line_dirs[dir_idx];
+      file_paths.push_back(dir.empty() || name.starts_with('/')
+                               ? name
+                               : dir + '/' + name);
+    }
+  }
+
+  util::SmallVector<u8, 0> debug_entries;
+  const u32 local_count = assembler.local_symbols.size();
+  const u32 sym_count = local_count + assembler.global_symbols.size();
+  for (u32 i = 1; i < sym_count; ++i) {
+    const SymRef sym = i < local_count
+                           ? SymRef(i)
+                           : SymRef(0x8000'0000 | (i - local_count));
+    const Elf64_Sym *elf_sym = assembler.sym_ptr(sym);
+    if (ELF64_ST_TYPE(elf_sym->st_info) != STT_FUNC || !elf_sym->st_size ||
+        elf_sym->st_shndx == SHN_UNDEF || elf_sym->st_shndx == SHN_ABS) {
+      continue;
+    }
+    const SecRef sec_ref = assembler.sym_section(sym);
+    const DataSection &sec = assembler.get_section(sec_ref);
+    if (!(sec.flags & SHF_EXECINSTR)) {
+      continue;
+    }
+    const u8 *code = mapped_addr + sec.addr + elf_sym->st_value;
+    const std::string_view name = assembler.sym_name(sym);
+    if (perf_map) {
+      files.write_map_entry(
+          reinterpret_cast<u64>(code), elf_sym->st_size, name);
+    }
+    if (!write_dump) {
+      continue;
+    }
+
+    // Debug entries: code_addr, line, discriminator, file name
+    debug_entries.clear();
+    u64 entry_count = 0;
+    const u64 func_end = elf_sym->st_value + elf_sym->st_size;
+    auto it = std::lower_bound(
+        seqs.begin(), seqs.end(), elf_sym->st_value, [&](u32 idx, u64 off) {
+          const auto &seq = assembler.line_seqs[idx];
+          return std::make_pair(seq.sec.id(), u64(seq.begin)) <
+                 std::make_pair(sec_ref.id(), off);
+        });
+    for (; it != seqs.end(); ++it) {
+      const auto &seq = assembler.line_seqs[*it];
+      if (seq.sec != sec_ref || seq.begin >= func_end) {
+        break;
+      }
+      for (u32 r = seq.rows_begin; r < seq.rows_end; ++r) {
+        const LineRow &row = assembler.line_rows[r];
+        const u64 addr =
+            reinterpret_cast<u64>(mapped_addr + sec.addr + row.off);
+        const u32 line_disc[2] = {row.line, 0};
+        const std::string &path = file_paths[row.file];
+        const size_t off = debug_entries.size();
+        debug_entries.resize(off + 16 + path.size() + 1);
+        std::memcpy(debug_entries.data() + off, &addr, 8);
+        std::memcpy(debug_entries.data() + off + 8, line_disc, 8);
+        std::memcpy(
+            debug_entries.data() + off + 16, path.c_str(), path.size() + 1);
+        ++entry_count;
+      }
+    }
+    files.write_code_load(
+        code, elf_sym->st_size, name, debug_entries, entry_count);
+  }
+}
+
+struct ElfMapper::GdbJitEntry {
+  jit_code_entry entry;
+  util::SmallVector<u8, 0> elf;
+};
+
+void ElfMapper::gdb_register(const AssemblerElf &assembler) noexcept {
+  // The object file for gdb is a relocatable ELF file with the section
+  // addresses set to the mapped addresses. Section indices are kept, so that
+  // the symbol table can be copied as is, and .symtab, .strtab, and .shstrtab
+  // are appended. Only contents that gdb cannot read from memory are included:
+  // .eh_frame, which is already relocated, and the debug sections, whose
+  // relocations are applied here.
+  const u32 sec_count = assembler.sections.size();
+  if (sec_count + 3 >= SHN_LORESERVE) {
+    TPDE_LOG_WARN("too many sections for GDB JIT registration");
+    return;
+  }
+  const u32 symtab_idx = sec_count;
+  const u32 strtab_idx = sec_count + 1;
+  const u32 shstrtab_idx = sec_count + 2;
+
+  auto *jit_entry = new GdbJitEntry();
+  util::SmallVector<u8, 0> &elf = jit_entry->elf;
+  util::SmallVector<Elf64_Shdr, 0> shdrs;
+  shdrs.resize(sec_count + 3);
+  StringTable shstrtab;
+
+  elf.resize(sizeof(Elf64_Ehdr));
+  const auto append = [&elf](const void *data, size_t size, size_t align) {
+    const size_t off = util::align_up(elf.size(), align);
+    elf.resize(off + size);
+    if (size) {
+      std::memcpy(elf.data() + off, data, size);
+    }
+    return off;
+  };
+  const auto sym_value = [&](SymRef sym) -> u64 {
+    const Elf64_Sym *elf_sym = assembler.sym_ptr(sym);
+    if (elf_sym->st_shndx == SHN_UNDEF) {
+      return reinterpret_cast<u64>(get_sym_addr(sym));
+    }
+    if (elf_sym->st_shndx == SHN_ABS) {
+      return elf_sym->st_value;
+    }
+    // Non-allocated sections, i.e. other debug sections, are at address 0.
+    const DataSection &sec = assembler.get_section(assembler.sym_section(sym));
+    if (!(sec.flags & SHF_ALLOC)) {
+      return elf_sym->st_value;
+    }
+    return reinterpret_cast<u64>(mapped_addr + sec.addr) + elf_sym->st_value;
+  };
+
+  for (u32 i = 1; i < sec_count; ++i) {
+    if (!assembler.sections[i]) { // relocation sections are omitted
+      continue;
+    }
+    const DataSection &sec = *assembler.sections[i];
+    const std::string_view name = assembler.sec_name(SecRef(i));
+    Elf64_Shdr &hdr = shdrs[i];
+    if (sec.flags & SHF_ALLOC) {
+      hdr.sh_type = SHT_NOBITS;
+      hdr.sh_addr = reinterpret_cast<u64>(mapped_addr + sec.addr);
+      if (SecRef(i) == assembler.secref_eh_frame) {
+        hdr.sh_type = SHT_PROGBITS;
+        hdr.sh_offset = append(mapped_addr + sec.addr, sec.size(), 8);
+      }
+    } else if (sec.type == SHT_PROGBITS && name.starts_with(".debug_")) {
+      hdr.sh_type = SHT_PROGBITS;
+      hdr.sh_offset = util::align_up(elf.size(), 8);
+      elf.resize(hdr.sh_offset);
+      sec.for_each_chunk([&](std::span<const u8> chunk) {
+        append(chunk.data(), chunk.size(), 1);
+        return true;
+      });
+      u8 *data = elf.data() + hdr.sh_offset;
+      for (const Relocation &reloc : assembler.get_relocs(SecRef(i))) {
+        const u64 value = sym_value(reloc.symbol) + reloc.addend;
+        switch (reloc.type) {
+        case R_X86_64_64:
+        case R_AARCH64_ABS64:
+          std::memcpy(data + reloc.offset, &value, sizeof(u64));
+          break;
+        case R_X86_64_32:
+        case R_AARCH64_ABS32: {
+          const u32 value32 = value;
+          std::memcpy(data + reloc.offset, &value32, sizeof(u32));
+          break;
+        }
+        default:
+          TPDE_LOG_WARN("unsupported relocation {} in {} for GDB JIT",
+                        reloc.type,
+                        name);
+        }
+      }
+    } else {
+      continue;
+    }
+    hdr.sh_name = shstrtab.add(name);
+    hdr.sh_flags = sec.flags & ~u64{SHF_GROUP};
+    hdr.sh_size = sec.size();
+    hdr.sh_addralign = sec.align;
+    hdr.sh_entsize = sec.entsize;
+  }
+
+  {
+    Elf64_Shdr &hdr = shdrs[symtab_idx];
+    hdr.sh_name = shstrtab.add(".symtab");
+    hdr.sh_type = SHT_SYMTAB;
+    hdr.sh_offset = append(assembler.local_symbols.data(),
+                           sizeof(Elf64_Sym) * assembler.local_symbols.size(),
+                           8);
+    append(assembler.global_symbols.data(),
+           sizeof(Elf64_Sym) * assembler.global_symbols.size(),
+           1);
+    hdr.sh_size = elf.size() - hdr.sh_offset;
+    hdr.sh_link = strtab_idx;
+    hdr.sh_info = assembler.local_symbols.size();
+    hdr.sh_addralign = 8;
+    hdr.sh_entsize = sizeof(Elf64_Sym);
+  }
+  {
+    Elf64_Shdr &hdr = shdrs[strtab_idx];
+    hdr.sh_name = shstrtab.add(".strtab");
+    hdr.sh_type = SHT_STRTAB;
+    hdr.sh_offset =
+        append(assembler.strtab.data(), assembler.strtab.size(), 1);
+    hdr.sh_size = assembler.strtab.size();
+    hdr.sh_addralign = 1;
+  }
+  {
+    Elf64_Shdr &hdr = shdrs[shstrtab_idx];
+    hdr.sh_name = shstrtab.add(".shstrtab");
+    hdr.sh_type = SHT_STRTAB;
+    hdr.sh_offset = append(shstrtab.data(), shstrtab.size(), 1);
+    hdr.sh_size = shstrtab.size();
+    hdr.sh_addralign = 1;
+  }
+
+  const auto &target_info =
+      static_cast<const AssemblerElf::TargetInfoElf &>(assembler.target_info);
+  Elf64_Ehdr ehdr{};
+  ehdr.e_ident[EI_MAG0] = ELFMAG0;
+  ehdr.e_ident[EI_MAG1] = ELFMAG1;
+  ehdr.e_ident[EI_MAG2] = ELFMAG2;
+  ehdr.e_ident[EI_MAG3] = ELFMAG3;
+  ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+  ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+  ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+  ehdr.e_ident[EI_OSABI] = target_info.elf_osabi;
+  ehdr.e_type = ET_REL;
+  ehdr.e_machine = target_info.elf_machine;
+  ehdr.e_version = EV_CURRENT;
+  ehdr.e_shoff = append(shdrs.data(), sizeof(Elf64_Shdr) * shdrs.size(), 8);
+  ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+  ehdr.e_shentsize = sizeof(Elf64_Shdr);
+  ehdr.e_shnum = shdrs.size();
+  ehdr.e_shstrndx = shstrtab_idx;
+  std::memcpy(elf.data(), &ehdr, sizeof(ehdr));
+
+  jit_code_entry &entry = jit_entry->entry;
+  entry.symfile_addr = reinterpret_cast<const char *>(elf.data());
+  entry.symfile_size = elf.size();
+
+  std::lock_guard lock(gdb_jit_mutex);
+  entry.prev_entry = nullptr;
+  entry.next_entry = __jit_debug_descriptor.first_entry;
+  if (entry.next_entry) {
+    entry.next_entry->prev_entry = &entry;
+  }
+  __jit_debug_descriptor.first_entry = &entry;
+  __jit_debug_descriptor.relevant_entry = &entry;
+  __jit_debug_descriptor.action_flag = JIT_REGISTER_FN;
+  __jit_debug_register_code();
+  gdb_jit_entry = jit_entry;
+}
+
+void ElfMapper::gdb_unregister() noexcept {
+  jit_code_entry &entry = gdb_jit_entry->entry;
+  {
+    std::lock_guard lock(gdb_jit_mutex);
+    if (entry.prev_entry) {
+      entry.prev_entry->next_entry = entry.next_entry;
+    } else {
+      __jit_debug_descriptor.first_entry = entry.next_entry;
+    }
+    if (entry.next_entry) {
+      entry.next_entry->prev_entry = entry.prev_entry;
+    }
+    __jit_debug_descriptor.relevant_entry = &entry;
+    __jit_debug_descriptor.action_flag = JIT_UNREGISTER_FN;
+    __jit_debug_register_code();
+  }
+  delete gdb_jit_entry;
+  gdb_jit_entry = nullptr;
+}
+
 } // namespace tpde